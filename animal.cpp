@@ -1,23 +1,15 @@
 // animal.cpp
 // Implementation of the Animal class, responsible for tracking individual
-// animal details. Relies on ExhibitManager to verify that an animal's assigned
-// exhibit exists.
+// animal details. Exhibit validation happens where an ExhibitManager is in
+// scope (AnimalManager::loadFromDatabase, exhibit selection in the UI).
 
 #include "animal.h"
-#include "exhibitManager.h" // Provides static methods to query existing exhibits
-#include <iostream>         // Used for console I/O (warnings, printing)
+#include <iostream> // Used for console I/O (printing)
 
 // Constructor
 // - Initializes all member variables: name, species, id, age, exhibit
-// - If the specified exhibit does not exist in ExhibitManager, logs a warning
 Animal::Animal(const string &n, const string &s, int i, int a, const string &ex)
-    : name(n), species(s), id(i), age(a), exhibit(ex) {
-  if (!ExhibitManager::exhibitExists(ex)) {
-    std::cerr << "[Warning] Exhibit '" << ex << "' does not exist."
-              << std::endl;
-    // Optionally, one could assign a default exhibit here or throw an exception
-  }
-}
+    : name(n), species(s), id(i), age(a), exhibit(ex) {}
 
 // printAnimalInformation
 // Displays all stored details about this animal to the console.
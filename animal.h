@@ -19,7 +19,7 @@ private:
 
 public:
   // Constructor: initializes all fields
-  // 'ex' is validated at runtime in the .cpp implementation
+  // 'ex' is not validated here; callers check it against their ExhibitManager
   Animal(const string &n, const string &s, int i, int a, const string &ex);
 
   // ——— Getters —————————————————————————————————
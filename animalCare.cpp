@@ -5,67 +5,859 @@
 //  - database.h: Provides Database abstraction for SQLite operations
 
 #include "animalCare.h"
-#include "database.h" // Abstraction over sqlite3 for executing SQL
-#include <ctime>      // time() and localtime
-#include <iostream>   // std::cout, std::cerr
-#include <sstream>    // std::ostringstream
+#include "database.h"    // Abstraction over sqlite3 for executing SQL
+#include <algorithm>     // std::upper_bound, std::rotate, std::lower_bound
+#include <charconv>      // std::to_chars for allocation-free formatting
+#include <cstdio>        // std::sscanf for stored timestamps
+#include <cstdlib>       // std::strtod for stored feeding amounts
+#include <ctime>         // time() and localtime_r
+#include <iostream>      // std::cout, std::cerr
+#include <limits>        // std::numeric_limits for open-ended ranges
+#include <sstream>       // std::ostringstream
+#include <tuple>         // std::tie for diagnosis ordering
+#include <unordered_set> // Memory records when merging stored ones
+
+// ===== Record formatting =====
+// FeedingRecord::formatTo
+//  - "[FEEDING] <amount>kg of <food>"; amount uses the same 6-significant-digit
+//    general format that operator<< produces
+void FeedingRecord::formatTo(std::string &out) const {
+  char num[32];
+  auto res = std::to_chars(num, num + sizeof(num), amount,
+                           std::chars_format::general, 6);
+  out += "[FEEDING] ";
+  out.append(num, res.ptr);
+  out += "kg of ";
+  out += foodType;
+}
+
+// HealthRecord::formatTo
+//  - "[HEALTH] <diagnosis> by <vet>: <notes>"
+void HealthRecord::formatTo(std::string &out) const {
+  out += "[HEALTH] ";
+  out += diagnosis;
+  out += " by ";
+  out += vetName;
+  out += ": ";
+  out += notes;
+}
+
+// TimestampFormatter::refresh
+//  - Re-derives the cached hour prefix with the thread-safe localtime_r
+void TimestampFormatter::refresh(time_t t) {
+  std::tm tm{};
+  localtime_r(&t, &tm);
+  prefixLen = std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:", &tm);
+  hourStart = t - (tm.tm_min * 60 + tm.tm_sec);
+  valid = true;
+}
+
+// TimestampFormatter::formatTo
+//  - Appends the cached prefix plus MM:SS computed arithmetically
+void TimestampFormatter::formatTo(std::string &out, time_t t) {
+  if (!valid || t < hourStart || t >= hourStart + 3600) {
+    refresh(t);
+  }
+  int offset = static_cast<int>(t - hourStart);
+  int minutes = offset / 60;
+  int seconds = offset % 60;
+  char tail[5] = {static_cast<char>('0' + minutes / 10),
+                  static_cast<char>('0' + minutes % 10), ':',
+                  static_cast<char>('0' + seconds / 10),
+                  static_cast<char>('0' + seconds % 10)};
+  out.append(prefix, prefixLen);
+  out.append(tail, sizeof(tail));
+}
+
+// ===== CarePeriod =====
+// First arena block is sized for a typical day; later blocks grow
+// geometrically from the upstream (new/delete) resource
+static constexpr size_t kInitialArenaBytes = 64 * 1024;
+
+// Constructor: places the period's containers inside its own arena
+CarePeriod::CarePeriod(time_t start)
+    : dayStart(start), arena(kInitialArenaBytes), contents(nullptr) {
+  std::pmr::polymorphic_allocator<> alloc(&arena);
+  contents = alloc.new_object<Contents>(&arena);
+}
+
+// Destructor: everything in 'contents' was allocated from 'arena' and owns
+// no outside resources, so the arena's own destructor reclaims it all at once
+CarePeriod::~CarePeriod() {}
+
+// historyFor
+//  - Looks up (or appends) the dense history slot for an animal
+CareHistory &CarePeriod::historyFor(int id) {
+  auto [it, inserted] =
+      contents->historyIndex.try_emplace(id, contents->histories.size());
+  if (inserted) {
+    contents->histories.push_back({id, std::pmr::vector<CareEntry>(&arena),
+                                   std::pmr::vector<time_t>(&arena),
+                                   std::pmr::vector<double>(&arena)});
+  }
+  return contents->histories[it->second];
+}
+
+// findHistory
+//  - Read-only lookup; nullptr when the animal has no records this period
+const CareHistory *CarePeriod::findHistory(int id) const {
+  auto it = contents->historyIndex.find(id);
+  return it == contents->historyIndex.end() ? nullptr
+                                            : &contents->histories[it->second];
+}
+
+const std::pmr::vector<CareHistory> &CarePeriod::getHistories() const {
+  return contents->histories;
+}
+
+// dayStartOf
+//  - Floors a timestamp to midnight UTC (also correct for pre-1970 times);
+//    saturates at the minimum time_t instead of overflowing
+time_t CarePeriod::dayStartOf(time_t t) {
+  time_t rem = t % SECONDS_PER_DAY;
+  if (rem < 0) {
+    if (t < std::numeric_limits<time_t>::min() + SECONDS_PER_DAY)
+      return std::numeric_limits<time_t>::min();
+    rem += SECONDS_PER_DAY;
+  }
+  return t - rem;
+}
+
+// ===== AnimalCareManager =====
+// periodFor
+//  - Returns the period for the day containing 't', creating it if needed
+CarePeriod &AnimalCareManager::periodFor(time_t t) {
+  time_t day = CarePeriod::dayStartOf(t);
+  return periods.try_emplace(day, day).first->second;
+}
+
+// restoreOrder
+//  - The new entry is almost always the latest, making this a single compare;
+//    if the clock went backwards it is rotated into place (columns likewise)
+void AnimalCareManager::restoreOrder(CareHistory &history) {
+  auto &entries = history.entries;
+  if (entries.size() < 2) {
+    return;
+  }
+  time_t t = getEntryTime(entries.back());
+  if (getEntryTime(entries[entries.size() - 2]) <= t) {
+    return;
+  }
+  auto pos = std::upper_bound(
+      entries.begin(), entries.end() - 1, t,
+      [](time_t v, const CareEntry &e) { return v < getEntryTime(e); });
+  std::rotate(pos, entries.end() - 1, entries.end());
+
+  if (std::holds_alternative<FeedingRecord>(entries[pos - entries.begin()])) {
+    auto &times = history.feedingTimes;
+    auto &amounts = history.feedingAmounts;
+    size_t at = std::upper_bound(times.begin(), times.end() - 1, t) -
+                times.begin();
+    std::rotate(times.begin() + at, times.end() - 1, times.end());
+    std::rotate(amounts.begin() + at, amounts.end() - 1, amounts.end());
+  }
+}
 
 // recordFeeding
-//  - Creates a FeedingRecord with current timestamp, food type, and amount
-//  - Stores it in the in-memory 'records' map for quick retrieval
+//  - Creates a FeedingRecord with the given (or current) timestamp, food
+//    type, and amount
+//  - Stores it inline in the animal's history within that day's arena
+//  - Scores the amount against the animal's intake baseline and queues an
+//    alert for outliers (see takeAlerts)
 void AnimalCareManager::recordFeeding(int id, const std::string &food,
-                                      double amount) {
-  records[id].emplace_back(
-      std::make_unique<FeedingRecord>(std::time(nullptr), food, amount));
+                                      double amount, time_t when) {
+  time_t now = when ? when : std::time(nullptr);
+  addFeeding(id, food, amount, now);
+  unsavedFeedings.push_back({id, food, amount, now});
+}
+
+void AnimalCareManager::addFeeding(int id, const std::string &food,
+                                   double amount, time_t now) {
+  CarePeriod &period = periodFor(now);
+  CareHistory &history = period.historyFor(id);
+  history.entries.emplace_back(std::in_place_type<FeedingRecord>, now, food,
+                               amount, period.getResource());
+  history.feedingTimes.push_back(now);
+  history.feedingAmounts.push_back(amount);
+  restoreOrder(history);
+  scheduler.onCareRecorded(id, CareType::Feeding, now);
+
+  if (auto alert = monitor.observe(id, now, amount)) {
+    pendingAlerts.push_back(*alert);
+  }
 }
 
 // recordHealthCheck
-//  - Creates a HealthRecord with current timestamp, vet name, notes, and
-//  diagnosis
+//  - Creates a HealthRecord with the given (or current) timestamp, vet name,
+//    notes, and diagnosis
 //  - Stores it similarly to feeding records
+//  - Both re-arm the animal's care plan of that kind, if it has one, and
+//    queue the record for the next saveToDatabase
 void AnimalCareManager::recordHealthCheck(int id, const std::string &vet,
                                           const std::string &notes,
-                                          const std::string &diagnosis) {
-  records[id].emplace_back(std::make_unique<HealthRecord>(
-      std::time(nullptr), vet, notes, diagnosis));
+                                          const std::string &diagnosis,
+                                          time_t when) {
+  time_t now = when ? when : std::time(nullptr);
+  addHealthCheck(id, vet, notes, diagnosis, now);
+  unsavedHealthChecks.push_back({id, vet, notes, diagnosis, now});
+}
+
+void AnimalCareManager::addHealthCheck(int id, const std::string &vet,
+                                       const std::string &notes,
+                                       const std::string &diagnosis,
+                                       time_t now) {
+  CarePeriod &period = periodFor(now);
+  CareHistory &history = period.historyFor(id);
+  history.entries.emplace_back(std::in_place_type<HealthRecord>, now, vet,
+                               notes, diagnosis, period.getResource());
+  restoreOrder(history);
+  scheduler.onCareRecorded(id, CareType::Health, now);
+}
+
+// Materializes an archived row as a live record (default allocator)
+static CareEntry toEntry(const ArchiveRow &r) {
+  if (r.kind == CareType::Health) {
+    return CareEntry(std::in_place_type<HealthRecord>, r.time, r.vetName,
+                     r.notes, r.diagnosis);
+  }
+  return CareEntry(std::in_place_type<FeedingRecord>, r.time, r.foodType,
+                   r.amount);
 }
 
+// Output is flushed to std::cout whenever the buffer passes this size
+static constexpr size_t kDisplayFlushBytes = 64 * 1024;
+
 // displayCareRecords
 //  - Prints all care records for a given animal ID
+//  - Lines are appended into one reusable buffer and written in large chunks
 //  - If no records exist, notifies user
 void AnimalCareManager::displayCareRecords(int id) const {
-  auto it = records.find(id);
-  if (it == records.end()) {
+  TimestampFormatter timeFmt;
+  std::string buf;
+  buf.reserve(kDisplayFlushBytes + 256);
+  bool any = false;
+  auto print = [&](const CareEntry &entry) {
+    if (!any) {
+      std::cout << "Care records for animal " << id << ":\n";
+      any = true;
+    }
+    std::visit(
+        [&](const auto &r) {
+          timeFmt.formatTo(buf, r.getTime());
+          buf += " - ";
+          r.formatTo(buf);
+          buf += '\n';
+        },
+        entry);
+    if (buf.size() >= kDisplayFlushBytes) {
+      std::cout.write(buf.data(), buf.size());
+      buf.clear();
+    }
+  };
+  // Archived months first; they all predate the live periods
+  archive.scan(id, std::numeric_limits<time_t>::min(),
+               std::numeric_limits<time_t>::max(),
+               [&](const ArchiveRow &r) { print(toEntry(r)); });
+  for (const auto &[day, period] : periods) {
+    const CareHistory *history = period.findHistory(id);
+    if (!history) {
+      continue;
+    }
+    for (const CareEntry &entry : history->entries) {
+      print(entry);
+    }
+  }
+  std::cout.write(buf.data(), buf.size());
+  std::cout.flush();
+  if (!any) {
     std::cout << "No records for animal " << id << std::endl;
-    return;
   }
-  std::cout << "Care records for animal " << id << ":\n";
-  for (const auto &rptr : it->second) {
-    std::cout << formatTime(rptr->getTime()) << " - " << rptr->getDetails()
-              << std::endl;
+}
+
+// archiveBefore
+//  - Whole days ending at or before 'cutoff' are all at the front of the
+//    ordered map; their rows are encoded before the arenas are released
+int AnimalCareManager::archiveBefore(time_t cutoff) {
+  auto last = periods.begin();
+  std::vector<ArchiveRow> rows;
+  while (last != periods.end() &&
+         last->first + CarePeriod::SECONDS_PER_DAY <= cutoff) {
+    for (const CareHistory &h : last->second.getHistories()) {
+      for (const CareEntry &e : h.entries) {
+        if (const auto *f = std::get_if<FeedingRecord>(&e)) {
+          rows.push_back({h.animalId, f->getTime(), CareType::Feeding,
+                          f->amount, f->foodType, {}, {}, {}});
+        } else {
+          const auto &hr = std::get<HealthRecord>(e);
+          rows.push_back({h.animalId, hr.getTime(), CareType::Health, 0.0, {},
+                          hr.vetName, hr.notes, hr.diagnosis});
+        }
+      }
+    }
+    ++last;
+  }
+  // Views into the arenas; release only once they are encoded
+  if (!rows.empty() && !archive.append(rows)) {
+    return -1;
   }
+  int released = static_cast<int>(std::distance(periods.begin(), last));
+  periods.erase(periods.begin(), last);
+  return released;
 }
 
-// formatTime
-//  - Helper to convert time_t to a human-readable string
-std::string AnimalCareManager::formatTime(time_t t) {
-  char buf[64];
-  std::tm *tm = std::localtime(&t);
-  std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", tm);
-  return buf;
+// recordsBetween
+//  - Visits only the days overlapping [from, to); within each, binary
+//    searches the animal's sorted history for the first entry >= from
+std::vector<CareEntry>
+AnimalCareManager::recordsBetween(int id, time_t from, time_t to,
+                                  CareType filter) const {
+  std::vector<CareEntry> out;
+  if (from >= to) {
+    return out;
+  }
+  archive.scan(id, from, to, [&](const ArchiveRow &r) {
+    if (filter == CareType::Any || r.kind == filter) {
+      out.push_back(toEntry(r));
+    }
+  });
+  for (auto it = periods.lower_bound(CarePeriod::dayStartOf(from));
+       it != periods.end() && it->first < to; ++it) {
+    const CareHistory *history = it->second.findHistory(id);
+    if (!history) {
+      continue;
+    }
+    const auto &entries = history->entries;
+    auto first = std::lower_bound(
+        entries.begin(), entries.end(), from,
+        [](const CareEntry &e, time_t v) { return getEntryTime(e) < v; });
+    for (auto e = first; e != entries.end() && getEntryTime(*e) < to; ++e) {
+      if (matchesType(*e, filter)) {
+        out.push_back(*e);
+      }
+    }
+  }
+  return out;
+}
+
+// pastFeedings
+//  - Collects archived and stored-only feedings into the same column layout
+//    the kernels use
+void AnimalCareManager::pastFeedings(int id, time_t from, time_t to,
+                                     Database &db, std::vector<time_t> &times,
+                                     std::vector<double> &amounts) const {
+  auto collect = [&](const ArchiveRow &r) {
+    if (r.kind == CareType::Feeding) {
+      times.push_back(r.time);
+      amounts.push_back(r.amount);
+    }
+  };
+  archive.scan(id, from, to, collect);
+  scanStoredOnly(id, from, to, CareType::Feeding, db, collect);
+}
+
+// feedingStats
+//  - Runs the stats kernel over the archived and stored-only feedings, then
+//    over each overlapping day's feeding column
+AmountStats AnimalCareManager::feedingStats(int id, time_t from, time_t to,
+                                            Database &db) const {
+  AmountStats stats;
+  if (from >= to) {
+    return stats;
+  }
+  std::vector<time_t> times;
+  std::vector<double> amounts;
+  pastFeedings(id, from, to, db, times, amounts);
+  stats = careKernels::maskedStats(times.data(), amounts.data(), times.size(),
+                                   from, to);
+  for (auto it = periods.lower_bound(CarePeriod::dayStartOf(from));
+       it != periods.end() && it->first < to; ++it) {
+    const CareHistory *history = it->second.findHistory(id);
+    if (history) {
+      stats.merge(careKernels::maskedStats(
+          history->feedingTimes.data(), history->feedingAmounts.data(),
+          history->feedingTimes.size(), from, to));
+    }
+  }
+  return stats;
+}
+
+// feedingHistogram
+//  - Accumulates every overlapping day into the same bucket array
+std::vector<long> AnimalCareManager::feedingHistogram(int id, time_t from,
+                                                      time_t to, double lo,
+                                                      double width,
+                                                      size_t buckets,
+                                                      Database &db) const {
+  std::vector<long> counts(buckets, 0);
+  if (from >= to) {
+    return counts;
+  }
+  std::vector<time_t> times;
+  std::vector<double> amounts;
+  pastFeedings(id, from, to, db, times, amounts);
+  careKernels::maskedHistogram(times.data(), amounts.data(), times.size(),
+                               from, to, lo, width, counts.data(), buckets);
+  for (auto it = periods.lower_bound(CarePeriod::dayStartOf(from));
+       it != periods.end() && it->first < to; ++it) {
+    const CareHistory *history = it->second.findHistory(id);
+    if (history) {
+      careKernels::maskedHistogram(
+          history->feedingTimes.data(), history->feedingAmounts.data(),
+          history->feedingTimes.size(), from, to, lo, width, counts.data(),
+          buckets);
+    }
+  }
+  return counts;
+}
+
+// aggregate
+//  - Each day's histories are ordered by animal ID once, so a block of IDs
+//    is one contiguous slice of every day, found by binary search
+//  - The distinct IDs in range are cut into a few blocks per worker and the
+//    blocks (plus one task for the archived months and one for the rows
+//    earlier sessions stored) run on the job system; tasks only read shared
+//    state and write their own partial map
+CareAggregate AnimalCareManager::aggregate(const CareQuery &query,
+                                           const std::vector<Animal> &animals,
+                                           Database &db,
+                                           JobSystem *jobs) const {
+  // Days overlapping the query range
+  std::vector<const CarePeriod *> span;
+  for (auto it = periods.lower_bound(CarePeriod::dayStartOf(query.from));
+       it != periods.end() && it->first < query.to; ++it) {
+    span.push_back(&it->second);
+  }
+
+  std::vector<std::vector<const CareHistory *>> byId(span.size());
+  auto sortDays = [&](size_t b, size_t e) {
+    for (size_t d = b; d < e; ++d) {
+      for (const CareHistory &h : span[d]->getHistories()) {
+        byId[d].push_back(&h);
+      }
+      std::sort(byId[d].begin(), byId[d].end(),
+                [](const CareHistory *x, const CareHistory *y) {
+                  return x->animalId < y->animalId;
+                });
+    }
+  };
+  if (jobs) {
+    jobs->parallelFor(span.size(), 1, sortDays);
+  } else {
+    sortDays(0, span.size());
+  }
+
+  // Distinct animal IDs, sorted, to cut into equal-sized ID blocks
+  std::vector<int> ids;
+  for (const auto &day : byId) {
+    for (const CareHistory *h : day) {
+      ids.push_back(h->animalId);
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+  std::unordered_map<int, const Animal *> animalById;
+  animalById.reserve(animals.size());
+  for (const Animal &a : animals) {
+    animalById.emplace(a.getId(), &a);
+  }
+
+  // A few blocks per worker so stealing can even out uneven blocks
+  const size_t workers = jobs ? jobs->getThreadCount() : 1;
+  const size_t parts = std::min(ids.size(), workers * 4);
+  // After the ID blocks: archived months, then stored-only rows
+  std::vector<CareAggregate> partials(parts + 2);
+
+  auto work = [&](size_t p) {
+    const int lo = ids[p * ids.size() / parts];
+    const int hi = ids[(p + 1) * ids.size() / parts - 1];
+    CareAggregate &local = partials[p];
+    CareGroupKey key; // Reused so lookups don't reallocate its strings
+
+    for (size_t d = 0; d < span.size(); ++d) {
+      const CarePeriod *period = span[d];
+      time_t bucket = 0;
+      if (query.groupBy & GROUP_TIME) {
+        bucket = query.bucket == TimeBucket::Month
+                     ? CareArchive::monthStartOf(period->getDayStart())
+                     : period->getDayStart();
+      }
+      const auto &day = byId[d];
+      auto first = std::lower_bound(
+          day.begin(), day.end(), lo,
+          [](const CareHistory *h, int id) { return h->animalId < id; });
+      auto last = std::upper_bound(
+          first, day.end(), hi,
+          [](int id, const CareHistory *h) { return id < h->animalId; });
+      for (auto slot = first; slot != last; ++slot) {
+        const CareHistory &h = **slot;
+        // Animal-level dimensions are fixed for the whole history
+        const Animal *a = nullptr;
+        auto found = animalById.find(h.animalId);
+        if (found != animalById.end()) {
+          a = found->second;
+        }
+        key.animalId = (query.groupBy & GROUP_ANIMAL) ? h.animalId : -1;
+        key.species.clear();
+        key.exhibit.clear();
+        if (a && (query.groupBy & GROUP_SPECIES)) {
+          key.species = a->getSpecies();
+        }
+        if (a && (query.groupBy & GROUP_EXHIBIT)) {
+          key.exhibit = a->getExhibit();
+        }
+        key.bucket = bucket;
+
+        if (!(query.groupBy & (GROUP_FOOD | GROUP_VET))) {
+          // One key per history: feedings come from the column kernels and
+          // health checks are the in-range entries that are not feedings
+          AmountStats fed = careKernels::maskedStats(
+              h.feedingTimes.data(), h.feedingAmounts.data(),
+              h.feedingTimes.size(), query.from, query.to);
+          long health = 0;
+          if (query.filter != CareType::Feeding) {
+            auto byTime = [](const CareEntry &e, time_t v) {
+              return getEntryTime(e) < v;
+            };
+            auto first = std::lower_bound(h.entries.begin(), h.entries.end(),
+                                          query.from, byTime);
+            auto last =
+                std::lower_bound(first, h.entries.end(), query.to, byTime);
+            health = (last - first) - fed.count;
+          }
+          if (query.filter == CareType::Health) {
+            fed = AmountStats{};
+          }
+          if (fed.count + health == 0) {
+            continue;
+          }
+          CareTotals &totals = local[key];
+          totals.count += fed.count + health;
+          totals.feedings += fed.count;
+          totals.healthChecks += health;
+          totals.kilograms += fed.sum;
+          continue;
+        }
+
+        for (const CareEntry &e : h.entries) {
+          time_t t = getEntryTime(e);
+          if (t < query.from || t >= query.to ||
+              !matchesType(e, query.filter)) {
+            continue;
+          }
+          key.foodType.clear();
+          key.vetName.clear();
+          const auto *feeding = std::get_if<FeedingRecord>(&e);
+          if (feeding && (query.groupBy & GROUP_FOOD)) {
+            key.foodType = feeding->foodType;
+          }
+          const auto *health = std::get_if<HealthRecord>(&e);
+          if (health && (query.groupBy & GROUP_VET)) {
+            key.vetName = health->vetName;
+          }
+
+          auto slot = local.find(key);
+          if (slot == local.end()) {
+            slot = local.emplace(key, CareTotals{}).first;
+          }
+          CareTotals &totals = slot->second;
+          ++totals.count;
+          if (feeding) {
+            ++totals.feedings;
+            totals.kilograms += feeding->amount;
+          } else {
+            ++totals.healthChecks;
+          }
+        }
+      }
+    }
+  };
+
+  // Archived rows and rows only the database holds are independent of the
+  // live periods, so each source is scanned on a worker of its own; folder
+  // returns the callback that adds a row to one task's partial map
+  auto folder = [&](CareAggregate &local) {
+    return [&query, &animalById, &local, key = CareGroupKey{},
+            lastDay = std::numeric_limits<time_t>::min(),
+            lastBucket = time_t{0}](const ArchiveRow &r) mutable {
+      if (query.filter != CareType::Any && r.kind != query.filter) {
+        return;
+      }
+      key.animalId = (query.groupBy & GROUP_ANIMAL) ? r.animalId : -1;
+      key.species.clear();
+      key.exhibit.clear();
+      key.foodType.clear();
+      key.vetName.clear();
+      auto found = animalById.find(r.animalId);
+      if (found != animalById.end() && (query.groupBy & GROUP_SPECIES)) {
+        key.species = found->second->getSpecies();
+      }
+      if (found != animalById.end() && (query.groupBy & GROUP_EXHIBIT)) {
+        key.exhibit = found->second->getExhibit();
+      }
+      const bool feeding = r.kind == CareType::Feeding;
+      if (feeding && (query.groupBy & GROUP_FOOD)) {
+        key.foodType = r.foodType;
+      }
+      if (!feeding && (query.groupBy & GROUP_VET)) {
+        key.vetName = r.vetName;
+      }
+      key.bucket = 0;
+      if (query.groupBy & GROUP_TIME) {
+        time_t day = CarePeriod::dayStartOf(r.time);
+        if (day != lastDay) { // Rows are time-ordered: one lookup per day
+          lastDay = day;
+          lastBucket = query.bucket == TimeBucket::Month
+                           ? CareArchive::monthStartOf(day)
+                           : day;
+        }
+        key.bucket = lastBucket;
+      }
+
+      CareTotals &totals = local[key];
+      ++totals.count;
+      if (feeding) {
+        ++totals.feedings;
+        totals.kilograms += r.amount;
+      } else {
+        ++totals.healthChecks;
+      }
+    };
+  };
+  auto archived = [&]() {
+    archive.scan(-1, query.from, query.to, folder(partials[parts]));
+  };
+  auto stored = [&]() {
+    scanStoredOnly(-1, query.from, query.to, query.filter, db,
+                   folder(partials[parts + 1]));
+  };
+
+  auto run = [&](size_t b, size_t e) {
+    for (size_t p = b; p < e; ++p) {
+      if (p < parts) {
+        work(p);
+      } else if (p == parts) {
+        if (!archive.empty()) {
+          archived();
+        }
+      } else {
+        stored();
+      }
+    }
+  };
+  if (jobs) {
+    jobs->parallelFor(partials.size(), 1, run);
+  } else {
+    run(0, partials.size());
+  }
+
+  // Merge partial maps into the first
+  CareAggregate &result = partials[0];
+  for (size_t p = 1; p < partials.size(); ++p) {
+    for (auto &[k, totals] : partials[p]) {
+      result[k].merge(totals);
+    }
+  }
+  return std::move(result);
 }
 
 // ===== Persistence Layer =====
+// The CareRecords 'details' text for a feeding / a health check. Amounts
+// use default stream precision, so the text is for display only; the exact
+// values live in the structured columns.
+static std::string feedingDetails(double amount, std::string_view food) {
+  std::ostringstream details;
+  details << amount << "kg of " << food;
+  return details.str();
+}
+
+static std::string healthDetails(std::string_view vet, std::string_view notes,
+                                 std::string_view diagnosis) {
+  std::ostringstream details;
+  details << diagnosis << " by " << vet << ": " << notes;
+  return details.str();
+}
+
+static std::string toSqlTimestamp(time_t t);
+
+// Binds 'when' as a stored timestamp, or NULL (for "now") if it is 0
+static void bindTimestamp(sqlite3_stmt *stmt, int index, time_t when) {
+  if (when) {
+    sqlite3_bind_text(stmt, index, toSqlTimestamp(when).c_str(), -1,
+                      SQLITE_TRANSIENT);
+  } else {
+    sqlite3_bind_null(stmt, index);
+  }
+}
+
+// Steps a prepared CareRecords INSERT once and finalizes it
+static void insertCareRecord(sqlite3_stmt *stmt, Database &db) {
+  if (sqlite3_step(stmt) != SQLITE_DONE) {
+    std::cerr << "[Error] Failed to insert care record: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+  }
+  sqlite3_finalize(stmt);
+}
+
 // saveFeedingToDatabase
-//  - Constructs an INSERT SQL statement for feeding records and executes it
+//  - Writes the formatted 'details' text plus the food and exact amount in
+//    their own columns, so archiving never has to parse the text
 void AnimalCareManager::saveFeedingToDatabase(int id, const std::string &food,
-                                              double amount, Database &db) {
-  std::ostringstream sql;
-  sql << "INSERT INTO CareRecords (animal_id, type, details, timestamp) VALUES "
-         "("
-      << id << ", 'feeding', '" << amount << "kg of " << food
-      << "', datetime('now'));";
-  db.execute(sql.str());
+                                              double amount, Database &db,
+                                              time_t when) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql = "INSERT INTO CareRecords (animal_id, type, details, "
+                    "timestamp, food, amount) VALUES (?, 'feeding', ?, "
+                    "COALESCE(?, datetime('now')), ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare CareRecords insert: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return;
+  }
+  const std::string details = feedingDetails(amount, food);
+  sqlite3_bind_int(stmt, 1, id);
+  sqlite3_bind_text(stmt, 2, details.c_str(), -1, SQLITE_TRANSIENT);
+  bindTimestamp(stmt, 3, when);
+  sqlite3_bind_text(stmt, 4, food.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_double(stmt, 5, amount);
+  insertCareRecord(stmt, db);
+}
+
+// saveFeedingsToDatabase
+//  - 'details' is formatted exactly as saveFeedingToDatabase writes it
+//  - Entries without a time get datetime('now') via COALESCE(NULL, ...)
+int AnimalCareManager::saveFeedingsToDatabase(
+    const std::vector<FeedingEntry> &batch, Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql = "INSERT INTO CareRecords (animal_id, type, details, "
+                    "timestamp, food, amount) VALUES (?, 'feeding', ?, "
+                    "COALESCE(?, datetime('now')), ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare CareRecords insert: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return -1;
+  }
+
+  if (!db.beginTransaction()) {
+    sqlite3_finalize(stmt);
+    return -1;
+  }
+  for (const FeedingEntry &f : batch) {
+    const std::string text = feedingDetails(f.amount, f.food);
+    sqlite3_bind_int(stmt, 1, f.animalId);
+    sqlite3_bind_text(stmt, 2, text.c_str(), -1, SQLITE_TRANSIENT);
+    bindTimestamp(stmt, 3, f.time);
+    sqlite3_bind_text(stmt, 4, f.food.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(stmt, 5, f.amount);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      std::cerr << "[Error] Failed to insert feeding for animal "
+                << f.animalId << ": " << sqlite3_errmsg(db.get())
+                << std::endl;
+      sqlite3_finalize(stmt);
+      db.rollback();
+      return -1;
+    }
+    sqlite3_reset(stmt);
+  }
+  sqlite3_finalize(stmt);
+  if (!db.commit()) {
+    db.rollback();
+    return -1;
+  }
+  return static_cast<int>(batch.size());
+}
+
+// recordFeedings
+//  - Memory is only touched once the database commit succeeded
+int AnimalCareManager::recordFeedings(const std::vector<FeedingEntry> &batch,
+                                      Database &db) {
+  if (saveFeedingsToDatabase(batch, db) < 0) {
+    return -1;
+  }
+  for (const FeedingEntry &f : batch) {
+    addFeeding(f.animalId, f.food, f.amount,
+               f.time ? f.time : std::time(nullptr));
+  }
+  return static_cast<int>(batch.size());
+}
+
+// Steps a prepared CareRecords INSERT once and resets it for the next row
+static bool insertStep(sqlite3_stmt *stmt, Database &db) {
+  const bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+  if (!ok) {
+    std::cerr << "[Error] Failed to save care record: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+  }
+  sqlite3_reset(stmt);
+  return ok;
+}
+
+// saveToDatabase
+//  - Unsaved records always carry their time, so memory and the stored rows
+//    agree to the second
+//  - On failure the transaction is rolled back and nothing is marked saved
+int AnimalCareManager::saveToDatabase(Database &db) {
+  if (unsavedRecords() == 0 && !monitor.hasUnsaved()) {
+    return 0;
+  }
+  sqlite3_stmt *feeding = nullptr;
+  sqlite3_stmt *health = nullptr;
+  const char *feedingSql = "INSERT INTO CareRecords (animal_id, type, "
+                           "details, timestamp, food, amount) VALUES (?, "
+                           "'feeding', ?, ?, ?, ?);";
+  const char *healthSql = "INSERT INTO CareRecords (animal_id, type, "
+                          "details, timestamp, vet, notes, diagnosis) VALUES "
+                          "(?, 'health', ?, ?, ?, ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), feedingSql, -1, &feeding, nullptr) !=
+          SQLITE_OK ||
+      sqlite3_prepare_v2(db.get(), healthSql, -1, &health, nullptr) !=
+          SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare CareRecords insert: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    sqlite3_finalize(feeding);
+    sqlite3_finalize(health);
+    return -1;
+  }
+
+  if (!db.beginTransaction()) {
+    sqlite3_finalize(feeding);
+    sqlite3_finalize(health);
+    return -1;
+  }
+  bool ok = true;
+  for (size_t i = 0; ok && i < unsavedFeedings.size(); ++i) {
+    const FeedingEntry &f = unsavedFeedings[i];
+    const std::string text = feedingDetails(f.amount, f.food);
+    sqlite3_bind_int(feeding, 1, f.animalId);
+    sqlite3_bind_text(feeding, 2, text.c_str(), -1, SQLITE_TRANSIENT);
+    bindTimestamp(feeding, 3, f.time);
+    sqlite3_bind_text(feeding, 4, f.food.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(feeding, 5, f.amount);
+    ok = insertStep(feeding, db);
+  }
+  for (size_t i = 0; ok && i < unsavedHealthChecks.size(); ++i) {
+    const HealthEntry &h = unsavedHealthChecks[i];
+    const std::string text = healthDetails(h.vet, h.notes, h.diagnosis);
+    sqlite3_bind_int(health, 1, h.animalId);
+    sqlite3_bind_text(health, 2, text.c_str(), -1, SQLITE_TRANSIENT);
+    bindTimestamp(health, 3, h.time);
+    sqlite3_bind_text(health, 4, h.vet.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(health, 5, h.notes.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(health, 6, h.diagnosis.c_str(), -1, SQLITE_TRANSIENT);
+    ok = insertStep(health, db);
+  }
+  sqlite3_finalize(feeding);
+  sqlite3_finalize(health);
+  ok = ok && monitor.saveToDatabase(db);
+  if (!ok || !db.commit()) {
+    db.rollback();
+    return -1;
+  }
+  monitor.markSaved();
+  const int saved = static_cast<int>(unsavedRecords());
+  unsavedFeedings.clear();
+  unsavedHealthChecks.clear();
+  return saved;
 }
 
 // saveHealthToDatabase
@@ -73,18 +865,156 @@ void AnimalCareManager::saveFeedingToDatabase(int id, const std::string &food,
 void AnimalCareManager::saveHealthToDatabase(int id, const std::string &vet,
                                              const std::string &notes,
                                              const std::string &diagnosis,
-                                             Database &db) {
-  std::ostringstream sql;
-  sql << "INSERT INTO CareRecords (animal_id, type, details, timestamp) VALUES "
-         "("
-      << id << ", 'health', '" << diagnosis << " by " << vet << ": " << notes
-      << "', datetime('now'));";
-  db.execute(sql.str());
+                                             Database &db, time_t when) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql = "INSERT INTO CareRecords (animal_id, type, details, "
+                    "timestamp, vet, notes, diagnosis) VALUES (?, 'health', "
+                    "?, COALESCE(?, datetime('now')), ?, ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare CareRecords insert: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return;
+  }
+  const std::string details = healthDetails(vet, notes, diagnosis);
+  sqlite3_bind_int(stmt, 1, id);
+  sqlite3_bind_text(stmt, 2, details.c_str(), -1, SQLITE_TRANSIENT);
+  bindTimestamp(stmt, 3, when);
+  sqlite3_bind_text(stmt, 4, vet.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, 5, notes.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, 6, diagnosis.c_str(), -1, SQLITE_TRANSIENT);
+  insertCareRecord(stmt, db);
+}
+
+// Formats a time_t the way datetime('now') stores it: UTC "YYYY-MM-DD HH:MM:SS"
+static std::string toSqlTimestamp(time_t t) {
+  char buf[32];
+  std::tm tm{};
+  if (!gmtime_r(&t, &tm)) {
+    // Open-ended range bounds: clamp past every stored timestamp
+    return t < 0 ? "0000-01-01 00:00:00" : "9999-12-31 23:59:59";
+  }
+  std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+  return buf;
+}
+
+// Inverse of toSqlTimestamp
+static bool fromSqlTimestamp(const char *text, time_t &out) {
+  std::tm tm{};
+  if (!text || std::sscanf(text, "%d-%d-%d %d:%d:%d", &tm.tm_year,
+                           &tm.tm_mon, &tm.tm_mday, &tm.tm_hour, &tm.tm_min,
+                           &tm.tm_sec) != 6) {
+    return false;
+  }
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  out = timegm(&tm);
+  return true;
+}
+
+// The CareRecords 'details' text the save functions write for a record
+static std::string storedDetails(const ArchiveRow &r) {
+  return r.kind == CareType::Feeding
+             ? feedingDetails(r.amount, r.foodType)
+             : healthDetails(r.vetName, r.notes, r.diagnosis);
+}
+
+// recordsBetweenInDatabase
+//  - Archived chunks first (all older than the remaining rows), then a
+//    parameterized range query; the (animal_id, timestamp) index turns it
+//    into a seek plus a scan of the matching rows
+std::vector<StoredCareRecord>
+AnimalCareManager::recordsBetweenInDatabase(int id, time_t from, time_t to,
+                                            CareType filter, Database &db) {
+  std::vector<StoredCareRecord> out;
+  CareArchive stored;
+  stored.loadFromDatabase(db, from, to);
+  stored.scan(id, from, to, [&](const ArchiveRow &r) {
+    if (filter == CareType::Any || r.kind == filter) {
+      out.push_back({r.animalId,
+                     r.kind == CareType::Feeding ? "feeding" : "health",
+                     storedDetails(r), toSqlTimestamp(r.time), r.time});
+    }
+  });
+
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "SELECT animal_id, type, details, timestamp FROM CareRecords "
+      "WHERE animal_id = ? AND timestamp >= ? AND timestamp < ? "
+      "AND (? IS NULL OR type = ?) ORDER BY timestamp;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return out;
+  }
+  const std::string fromStr = toSqlTimestamp(from);
+  const std::string toStr = toSqlTimestamp(to);
+  sqlite3_bind_int(stmt, 1, id);
+  sqlite3_bind_text(stmt, 2, fromStr.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, 3, toStr.c_str(), -1, SQLITE_TRANSIENT);
+  if (filter != CareType::Any) {
+    const char *type = filter == CareType::Feeding ? "feeding" : "health";
+    sqlite3_bind_text(stmt, 4, type, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 5, type, -1, SQLITE_STATIC);
+  }
+
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    StoredCareRecord row;
+    row.animalId = sqlite3_column_int(stmt, 0);
+    row.type = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+    row.details = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 2));
+    row.timestamp =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+    fromSqlTimestamp(row.timestamp.c_str(), row.time);
+    out.push_back(std::move(row));
+  }
+  sqlite3_finalize(stmt);
+  return out;
+}
+
+// allRecordsBetween
+//  - Memory records are turned into their stored form; each stored row that
+//    matches one of them (by kind, timestamp and text) is dropped once
+std::vector<StoredCareRecord>
+AnimalCareManager::allRecordsBetween(int id, time_t from, time_t to,
+                                     CareType filter, Database &db) const {
+  std::vector<StoredCareRecord> out;
+  std::unordered_multiset<std::string> inMemory;
+  for (const CareEntry &e : recordsBetween(id, from, to, filter)) {
+    StoredCareRecord row{id, "", "", "", getEntryTime(e)};
+    if (const auto *f = std::get_if<FeedingRecord>(&e)) {
+      row.type = "feeding";
+      row.details = feedingDetails(f->amount, f->foodType);
+    } else {
+      const auto &h = std::get<HealthRecord>(e);
+      row.type = "health";
+      row.details = healthDetails(h.vetName, h.notes, h.diagnosis);
+    }
+    row.timestamp = toSqlTimestamp(row.time);
+    inMemory.insert(row.type + '|' + row.timestamp + '|' + row.details);
+    out.push_back(std::move(row));
+  }
+  for (StoredCareRecord &row :
+       recordsBetweenInDatabase(id, from, to, filter, db)) {
+    auto seen =
+        inMemory.find(row.type + '|' + row.timestamp + '|' + row.details);
+    if (seen != inMemory.end()) {
+      inMemory.erase(seen);
+    } else {
+      out.push_back(std::move(row));
+    }
+  }
+  std::stable_sort(out.begin(), out.end(),
+                   [](const StoredCareRecord &a, const StoredCareRecord &b) {
+                     return a.time < b.time;
+                   });
+  return out;
 }
 
 // loadFromDatabase
 //  - Loads all care records from the CareRecords table
-//  - Prints them, demonstrating retrieval; could instead populate 'records'
+//  - Prints them, demonstrating retrieval; could instead populate 'histories'
+//  - Loads the archived chunks, which every query reads alongside the days
+//  - Loads the intake baselines, so alerts need no new warm-up
 void AnimalCareManager::loadFromDatabase(Database &db) {
   sqlite3_stmt *stmt;
   const std::string sql =
@@ -110,4 +1040,361 @@ void AnimalCareManager::loadFromDatabase(Database &db) {
   }
 
   sqlite3_finalize(stmt);
+  archive.loadFromDatabase(db);
+  monitor.loadFromDatabase(db);
+}
+
+// A CareRecords row selected for archiving, with its fields split out
+struct ParsedCareRow {
+  sqlite3_int64 rowId;
+  int animalId;
+  time_t time;
+  CareType kind;
+  double amount = 0.0;
+  std::string food, vet, notes, diagnosis;
+
+  ArchiveRow view() const {
+    return {animalId, time, kind, amount, food, vet, notes, diagnosis};
+  }
+};
+
+// Splits a legacy "<diagnosis> by <vet>: <notes>" text
+//  - Fails unless exactly one split exists: "Bitten by snake by Ann: ok"
+//    could name either "snake by Ann" or "Ann" as the vet
+static bool splitHealthDetails(const std::string &text, ParsedCareRow &row) {
+  int splits = 0;
+  for (size_t by = text.find(" by "); by != std::string::npos;
+       by = text.find(" by ", by + 1)) {
+    for (size_t colon = text.find(": ", by + 4); colon != std::string::npos;
+         colon = text.find(": ", colon + 1)) {
+      if (++splits > 1) {
+        return false;
+      }
+      row.diagnosis = text.substr(0, by);
+      row.vet = text.substr(by + 4, colon - by - 4);
+      row.notes = text.substr(colon + 2);
+    }
+  }
+  return splits == 1;
+}
+
+// Splits a legacy "<amount>kg of <food>" text
+static bool splitFeedingDetails(const std::string &text, ParsedCareRow &row) {
+  char *end = nullptr;
+  row.amount = std::strtod(text.c_str(), &end);
+  std::string_view rest(end);
+  if (end == text.c_str() || rest.substr(0, 6) != "kg of ") {
+    return false;
+  }
+  row.food = rest.substr(6);
+  return true;
+}
+
+// Text column 'col' of the current row ("" for NULL)
+static std::string columnText(sqlite3_stmt *stmt, int col) {
+  const unsigned char *text = sqlite3_column_text(stmt, col);
+  return text ? reinterpret_cast<const char *>(text) : "";
+}
+
+// Reads the current row of a "SELECT id, animal_id, type, details,
+// timestamp, food, amount, vet, notes, diagnosis FROM CareRecords" query
+//  - Rows written with the structured columns are read from them; older
+//    rows only have the 'details' text, which is split into fields
+//  - exact: the split must also format back to the same text. Otherwise a
+//    health text that does not split keeps the longest diagnosis it could
+//    hold (and no vet or notes).
+//  - Returns false for an unknown type, a bad timestamp or (feedings, or
+//    when exact) text that does not split
+static bool parseCareRow(sqlite3_stmt *stmt, ParsedCareRow &row, bool exact) {
+  row.rowId = sqlite3_column_int64(stmt, 0);
+  row.animalId = sqlite3_column_int(stmt, 1);
+  const std::string type = columnText(stmt, 2);
+  const std::string details = columnText(stmt, 3);
+  if (!fromSqlTimestamp(
+          reinterpret_cast<const char *>(sqlite3_column_text(stmt, 4)),
+          row.time)) {
+    return false;
+  }
+
+  if (type == "feeding" && sqlite3_column_type(stmt, 6) != SQLITE_NULL) {
+    row.kind = CareType::Feeding;
+    row.food = columnText(stmt, 5);
+    row.amount = sqlite3_column_double(stmt, 6);
+    return true;
+  }
+  if (type == "health" && sqlite3_column_type(stmt, 9) != SQLITE_NULL) {
+    row.kind = CareType::Health;
+    row.vet = columnText(stmt, 7);
+    row.notes = columnText(stmt, 8);
+    row.diagnosis = columnText(stmt, 9);
+    return true;
+  }
+  if (type == "feeding") {
+    row.kind = CareType::Feeding;
+    return splitFeedingDetails(details, row) &&
+           (!exact || storedDetails(row.view()) == details);
+  }
+  if (type == "health") {
+    row.kind = CareType::Health;
+    if (splitHealthDetails(details, row)) {
+      return !exact || storedDetails(row.view()) == details;
+    }
+    row.diagnosis = details.substr(0, details.rfind(" by "));
+    return !exact;
+  }
+  return false;
+}
+
+// Every record of 'animalId' (-1 = all) in [from, to) passing 'filter'
+// that the database holds: CareArchive chunks, then CareRecords rows
+// (legacy text read as parseCareRow does when not exact)
+static std::vector<ParsedCareRow> storedRowsBetween(int animalId, time_t from,
+                                                    time_t to, CareType filter,
+                                                    Database &db) {
+  std::vector<ParsedCareRow> out;
+  if (from >= to) {
+    return out;
+  }
+  CareArchive stored;
+  stored.loadFromDatabase(db, from, to);
+  stored.scan(animalId, from, to, [&](const ArchiveRow &r) {
+    if (filter == CareType::Any || r.kind == filter) {
+      out.push_back({0, r.animalId, r.time, r.kind, r.amount,
+                     std::string(r.foodType), std::string(r.vetName),
+                     std::string(r.notes), std::string(r.diagnosis)});
+    }
+  });
+
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "SELECT id, animal_id, type, details, timestamp, food, amount, vet, "
+      "notes, diagnosis FROM CareRecords WHERE (? < 0 OR animal_id = ?) "
+      "AND timestamp >= ? AND timestamp < ? AND (? IS NULL OR type = ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return out;
+  }
+  const std::string fromStr = toSqlTimestamp(from);
+  const std::string toStr = toSqlTimestamp(to);
+  sqlite3_bind_int(stmt, 1, animalId);
+  sqlite3_bind_int(stmt, 2, animalId);
+  sqlite3_bind_text(stmt, 3, fromStr.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, 4, toStr.c_str(), -1, SQLITE_TRANSIENT);
+  if (filter != CareType::Any) {
+    const char *type = filter == CareType::Feeding ? "feeding" : "health";
+    sqlite3_bind_text(stmt, 5, type, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 6, type, -1, SQLITE_STATIC);
+  }
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    ParsedCareRow row;
+    if (parseCareRow(stmt, row, false)) {
+      out.push_back(std::move(row));
+    }
+  }
+  sqlite3_finalize(stmt);
+  return out;
+}
+
+// A record's identity across memory and the database: animal, kind, second
+// and stored text
+static std::string recordKey(const ArchiveRow &r) {
+  std::string key = std::to_string(r.animalId);
+  key += r.kind == CareType::Feeding ? "|f|" : "|h|";
+  key += std::to_string(r.time);
+  key += '|';
+  key += storedDetails(r);
+  return key;
+}
+
+// A live entry as a row (its strings view the entry)
+static ArchiveRow entryRow(int animalId, const CareEntry &e) {
+  if (const auto *f = std::get_if<FeedingRecord>(&e)) {
+    return {animalId, f->getTime(), CareType::Feeding, f->amount, f->foodType,
+            {}, {}, {}};
+  }
+  const auto &h = std::get<HealthRecord>(e);
+  return {animalId, h.getTime(), CareType::Health, 0.0, {}, h.vetName,
+          h.notes, h.diagnosis};
+}
+
+// scanStoredOnly
+//  - Memory records in range are keyed like allRecordsBetween's; each
+//    stored row matching one of them is dropped once
+void AnimalCareManager::scanStoredOnly(
+    int id, time_t from, time_t to, CareType filter, Database &db,
+    const std::function<void(const ArchiveRow &)> &fn) const {
+  const std::vector<ParsedCareRow> stored =
+      storedRowsBetween(id, from, to, filter, db);
+  if (stored.empty()) {
+    return;
+  }
+  std::unordered_multiset<std::string> inMemory;
+  auto remember = [&](const ArchiveRow &r) {
+    if (filter == CareType::Any || r.kind == filter) {
+      inMemory.insert(recordKey(r));
+    }
+  };
+  auto rememberHistory = [&](const CareHistory &history) {
+    for (const CareEntry &e : history.entries) {
+      const time_t t = getEntryTime(e);
+      if (t >= from && t < to) {
+        remember(entryRow(history.animalId, e));
+      }
+    }
+  };
+  archive.scan(id, from, to, remember);
+  for (auto it = periods.lower_bound(CarePeriod::dayStartOf(from));
+       it != periods.end() && it->first < to; ++it) {
+    if (id >= 0) {
+      if (const CareHistory *history = it->second.findHistory(id)) {
+        rememberHistory(*history);
+      }
+      continue;
+    }
+    for (const CareHistory &history : it->second.getHistories()) {
+      rememberHistory(history);
+    }
+  }
+
+  for (const ParsedCareRow &row : stored) {
+    const ArchiveRow r = row.view();
+    auto seen = inMemory.find(recordKey(r));
+    if (seen != inMemory.end()) {
+      inMemory.erase(seen);
+    } else {
+      fn(r);
+    }
+  }
+}
+
+// diagnosesBetween
+//  - One pass over the days in range and one query each for the stored
+//    rows and chunks, rather than a query per animal
+//  - A legacy row's diagnosis is read as storedRowsBetween reads it
+std::vector<DiagnosisEntry>
+AnimalCareManager::diagnosesBetween(time_t from, time_t to,
+                                    Database &db) const {
+  std::vector<DiagnosisEntry> out;
+  if (from >= to) {
+    return out;
+  }
+  auto scanRow = [&](const ArchiveRow &r) {
+    if (r.kind == CareType::Health) {
+      out.push_back({r.animalId, r.time, std::string(r.diagnosis)});
+    }
+  };
+  archive.scan(-1, from, to, scanRow);
+  for (const ParsedCareRow &row :
+       storedRowsBetween(-1, from, to, CareType::Health, db)) {
+    scanRow(row.view());
+  }
+  for (auto it = periods.lower_bound(CarePeriod::dayStartOf(from));
+       it != periods.end() && it->first < to; ++it) {
+    for (const CareHistory &history : it->second.getHistories()) {
+      for (const CareEntry &e : history.entries) {
+        const auto *h = std::get_if<HealthRecord>(&e);
+        const time_t t = getEntryTime(e);
+        if (h && t >= from && t < to) {
+          out.push_back({history.animalId, t, std::string(h->diagnosis)});
+        }
+      }
+    }
+  }
+
+  auto key = [](const DiagnosisEntry &d) {
+    return std::tie(d.animalId, d.time, d.diagnosis);
+  };
+  std::sort(out.begin(), out.end(),
+            [&](const DiagnosisEntry &a, const DiagnosisEntry &b) {
+              return key(a) < key(b);
+            });
+  out.erase(std::unique(out.begin(), out.end(),
+                        [&](const DiagnosisEntry &a, const DiagnosisEntry &b) {
+                          return key(a) == key(b);
+                        }),
+            out.end());
+  return out;
+}
+
+// archiveDatabaseBefore
+//  - Rows written with the structured columns are archived from them
+//  - Older rows only have the 'details' text; one is archived only if it
+//    splits into fields one way and formatting those fields gives back the
+//    same text, so nothing is lost when the row is deleted. The rest stay
+//    in CareRecords, as do rows with an unknown type or bad timestamp.
+//  - Merging into the month chunks and deleting the archived rows happen in
+//    one transaction
+int AnimalCareManager::archiveDatabaseBefore(time_t cutoff, Database &db,
+                                             int *kept) {
+  std::vector<ParsedCareRow> parsed;
+  int unsplit = 0;
+
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "SELECT id, animal_id, type, details, timestamp, food, amount, vet, "
+      "notes, diagnosis FROM CareRecords WHERE timestamp < ? "
+      "ORDER BY timestamp, id;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return -1;
+  }
+  const std::string cutoffStr = toSqlTimestamp(cutoff);
+  sqlite3_bind_text(stmt, 1, cutoffStr.c_str(), -1, SQLITE_TRANSIENT);
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    ParsedCareRow row;
+    if (parseCareRow(stmt, row, true)) {
+      parsed.push_back(std::move(row));
+    } else {
+      ++unsplit;
+    }
+  }
+  sqlite3_finalize(stmt);
+  if (kept) {
+    *kept = unsplit;
+  }
+  if (parsed.empty()) {
+    return 0;
+  }
+
+  std::vector<ArchiveRow> rows;
+  rows.reserve(parsed.size());
+  for (const ParsedCareRow &p : parsed) {
+    rows.push_back(p.view());
+  }
+
+  if (!db.beginTransaction()) {
+    return -1;
+  }
+  // Existing chunks of the affected months are merged, not overwritten
+  CareArchive staged;
+  staged.loadFromDatabase(db, CareArchive::monthStartOf(rows.front().time));
+  bool ok = staged.append(rows) && staged.saveToDatabase(db);
+
+  // Delete exactly the rows that were archived
+  if (ok && sqlite3_prepare_v2(db.get(),
+                               "DELETE FROM CareRecords WHERE id = ?;", -1,
+                               &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    ok = false;
+  } else if (ok) {
+    for (const ParsedCareRow &p : parsed) {
+      sqlite3_bind_int64(stmt, 1, p.rowId);
+      if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "[Error] Failed to delete archived record: "
+                  << sqlite3_errmsg(db.get()) << std::endl;
+        ok = false;
+        break;
+      }
+      sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+  }
+  if (!ok || !db.commit()) {
+    db.rollback();
+    return -1;
+  }
+  return static_cast<int>(parsed.size());
 }
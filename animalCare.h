@@ -5,26 +5,33 @@
 #ifndef ANIMAL_CARE_H
 #define ANIMAL_CARE_H
 
-#include "database.h" // Provides Database handle and execute/get functions
-#include <ctime>      // time_t
-#include <map>        // std::map for grouping records by animal ID
-#include <memory>     // std::unique_ptr for polymorphic CareRecord storage
-#include <sstream>    // std::ostringstream for formatting details
-#include <string>     // std::string
-#include <vector>     // std::vector for per-animal record lists
-
-// Base class for any care-related record (feeding, health checks, etc.)
+#include "animal.h"          // Animal species/exhibit for aggregation
+#include "careAggregation.h" // Grouped statistics query/result types
+#include "careArchive.h"     // Compressed monthly chunks of old records
+#include "careKernels.h"     // Vectorized feeding-amount kernels
+#include "careScheduler.h"   // Recurring care plans and due care
+#include "database.h"        // Database handle and execute/get functions
+#include "intakeMonitor.h"   // Streaming feeding-intake outlier detection
+#include "jobSystem.h"       // Parallel aggregation
+#include <ctime>             // time_t
+#include <map>               // std::map of day -> CarePeriod
+#include <memory_resource>   // Per-day monotonic arenas
+#include <string>            // std::string
+#include <string_view>       // std::string_view for record construction
+#include <unordered_map>     // Animal ID -> history slot
+#include <utility>           // std::exchange for takeAlerts
+#include <variant>           // std::variant for inline record storage
+#include <vector>            // std::vector for per-animal record lists
+
+// Common state for any care-related record (feeding, health checks, etc.).
+// Records are stored by value inside a CareEntry variant, so there is no
+// virtual dispatch and no per-record heap allocation.
 class CareRecord {
 protected:
   time_t timestamp; // Unix timestamp when record was created
   CareRecord(time_t t) : timestamp(t) {}
 
 public:
-  virtual ~CareRecord() = default;
-
-  // Returns a formatted string describing this record
-  virtual std::string getDetails() const = 0;
-
   // Retrieve raw timestamp (for sorting or formatting)
   time_t getTime() const { return timestamp; }
 };
@@ -32,64 +39,352 @@ public:
 // FeedingRecord: represents a feeding event
 class FeedingRecord : public CareRecord {
 public:
-  std::string foodType; // Type of food given
-  double amount;        // Amount in kilograms
+  std::pmr::string foodType; // Type of food given
+  double amount;             // Amount in kilograms
+
+  // 'res' supplies the string storage (the owning period's arena)
+  FeedingRecord(
+      time_t t, std::string_view f, double a,
+      std::pmr::memory_resource *res = std::pmr::get_default_resource())
+      : CareRecord(t), foodType(f, res), amount(a) {}
 
-  FeedingRecord(time_t t, std::string f, double a)
-      : CareRecord(t), foodType(std::move(f)), amount(a) {}
+  // Appends a description of this record to 'out' (no temporaries)
+  void formatTo(std::string &out) const;
 
-  std::string getDetails() const override {
-    std::ostringstream oss;
-    oss << "[FEEDING] " << amount << "kg of " << foodType;
-    return oss.str();
+  // Returns a formatted string describing this record
+  std::string getDetails() const {
+    std::string out;
+    formatTo(out);
+    return out;
   }
 };
 
 // HealthRecord: represents a veterinary health check
 class HealthRecord : public CareRecord {
 public:
-  std::string vetName;   // Name of veterinarian
-  std::string notes;     // Summary of health observations
-  std::string diagnosis; // Diagnosis provided
-
-  HealthRecord(time_t t, std::string v, std::string n, std::string d)
-      : CareRecord(t), vetName(std::move(v)), notes(std::move(n)),
-        diagnosis(std::move(d)) {}
-
-  std::string getDetails() const override {
-    std::ostringstream oss;
-    oss << "[HEALTH] " << diagnosis << " by " << vetName << ": " << notes;
-    return oss.str();
+  std::pmr::string vetName;   // Name of veterinarian
+  std::pmr::string notes;     // Summary of health observations
+  std::pmr::string diagnosis; // Diagnosis provided
+
+  // 'res' supplies the string storage (the owning period's arena)
+  HealthRecord(
+      time_t t, std::string_view v, std::string_view n, std::string_view d,
+      std::pmr::memory_resource *res = std::pmr::get_default_resource())
+      : CareRecord(t), vetName(v, res), notes(n, res), diagnosis(d, res) {}
+
+  // Appends a description of this record to 'out' (no temporaries)
+  void formatTo(std::string &out) const;
+
+  // Returns a formatted string describing this record
+  std::string getDetails() const {
+    std::string out;
+    formatTo(out);
+    return out;
   }
 };
 
+// TimestampFormatter: appends "YYYY-MM-DD HH:MM:SS" (local time) to a buffer.
+// The date/hour prefix is cached until a timestamp leaves that local hour;
+// refreshing per hour rather than per day keeps DST shifts correct.
+class TimestampFormatter {
+  time_t hourStart = 0; // First second of the cached local hour
+  bool valid = false;   // False until the first refresh
+  char prefix[32];      // Cached "YYYY-MM-DD HH:"
+  size_t prefixLen = 0;
+
+  void refresh(time_t t);
+
+public:
+  void formatTo(std::string &out, time_t t);
+};
+
+// A care record of either kind, stored inline
+using CareEntry = std::variant<FeedingRecord, HealthRecord>;
+
+// Timestamp of whichever record a CareEntry holds
+inline time_t getEntryTime(const CareEntry &e) {
+  return std::visit([](const auto &r) { return r.getTime(); }, e);
+}
+
+// Record kind filter for queries
+enum class CareType : int { Any, Feeding, Health };
+
+// True if 'e' passes 'filter'
+inline bool matchesType(const CareEntry &e, CareType filter) {
+  return filter == CareType::Any ||
+         (filter == CareType::Feeding) ==
+             std::holds_alternative<FeedingRecord>(e);
+}
+
+// A CareRecords row as stored in SQLite (details are pre-formatted text;
+// the table also keeps each record's fields in their own columns)
+struct StoredCareRecord {
+  int animalId;
+  std::string type;      // "feeding" or "health"
+  std::string details;   // Formatted record text
+  std::string timestamp; // "YYYY-MM-DD HH:MM:SS" (UTC)
+  time_t time = 0;       // The same timestamp parsed
+};
+
+// One feeding in a batch (e.g. a keeper's round of an exhibit)
+struct FeedingEntry {
+  int animalId;
+  std::string food;
+  double amount;   // kg
+  time_t time = 0; // When it happened; 0 means now
+};
+
+// The diagnosis of one health check
+struct DiagnosisEntry {
+  int animalId;
+  time_t time;
+  std::string diagnosis;
+};
+
+// One health check (waiting to be saved)
+struct HealthEntry {
+  int animalId;
+  std::string vet;
+  std::string notes;
+  std::string diagnosis;
+  time_t time = 0;
+};
+
+// All care records for one animal within a period, sorted by timestamp
+// Feeding timestamps/amounts are mirrored in typed columns (same order as
+// the feedings in 'entries') so statistics run on the vector kernels.
+struct CareHistory {
+  int animalId;
+  std::pmr::vector<CareEntry> entries;
+  std::pmr::vector<time_t> feedingTimes;   // Column: feeding timestamps
+  std::pmr::vector<double> feedingAmounts; // Column: feeding amounts (kg)
+};
+
+// CarePeriod: one UTC day of care records. The index, the histories, their
+// entry vectors and every record string are carved from the period's arena,
+// so archiving a day hands back a few large blocks in O(1) rather than
+// freeing each record and string individually.
+class CarePeriod {
+public:
+  static constexpr time_t SECONDS_PER_DAY = 24 * 60 * 60;
+
+  explicit CarePeriod(time_t dayStart);
+
+  // Releases the arena wholesale; contents are not destroyed one by one
+  ~CarePeriod();
+
+  // Non-copyable and non-movable: contents point into the arena
+  CarePeriod(const CarePeriod &) = delete;
+  CarePeriod &operator=(const CarePeriod &) = delete;
+
+  time_t getDayStart() const { return dayStart; }
+  std::pmr::memory_resource *getResource() { return &arena; }
+
+  // Returns the history for an animal, creating it on first use
+  CareHistory &historyFor(int animalID);
+
+  // Returns the animal's history, or nullptr if it has none this period
+  const CareHistory *findHistory(int animalID) const;
+
+  // Dense per-animal histories; aggregations stream through this vector
+  const std::pmr::vector<CareHistory> &getHistories() const;
+
+  // Start (00:00 UTC) of the day containing 't'
+  static time_t dayStartOf(time_t t);
+
+private:
+  // Objects placed inside the arena
+  struct Contents {
+    std::pmr::vector<CareHistory> histories;           // Dense histories
+    std::pmr::unordered_map<int, size_t> historyIndex; // Animal ID -> slot
+    explicit Contents(std::pmr::memory_resource *r)
+        : histories(r), historyIndex(r) {}
+  };
+
+  time_t dayStart;                           // First second of the period
+  std::pmr::monotonic_buffer_resource arena; // Backing store for the day
+  Contents *contents;                        // Allocated from 'arena'
+};
+
 // AnimalCareManager: orchestrates creation, display, and database persistence
 // of care records
 class AnimalCareManager {
-  // Mapping from animalID to a list of care record pointers
-  std::map<int, std::vector<std::unique_ptr<CareRecord>>> records;
+  // Periods keyed by day start, oldest first
+  std::map<time_t, CarePeriod> periods;
+
+  // Returns the period covering 't', creating it on first use
+  CarePeriod &periodFor(time_t t);
+
+  // Keeps a history (and its feeding columns) sorted after an entry was
+  // appended at the back
+  static void restoreOrder(CareHistory &history);
+
+  // Recurring care plans; re-armed whenever care is recorded
+  CareScheduler scheduler;
+
+  // Records moved out of the live periods; every query below also reads it
+  CareArchive archive;
+
+  // Per-animal intake baselines, updated by every recordFeeding and saved
+  // with the care records
+  IntakeMonitor monitor;
+
+  // Intake alerts raised since the last takeAlerts
+  std::vector<IntakeAlert> pendingAlerts;
+
+  // Dirty tracking: records made since the last saveToDatabase, which
+  // writes these and nothing else
+  std::vector<FeedingEntry> unsavedFeedings;
+  std::vector<HealthEntry> unsavedHealthChecks;
+
+  // recordFeeding/recordHealthCheck without marking the record unsaved
+  void addFeeding(int animalID, const std::string &food, double amount,
+                  time_t when);
+  void addHealthCheck(int animalID, const std::string &vet,
+                      const std::string &notes, const std::string &diagnosis,
+                      time_t when);
+
+  // Calls 'fn' for each record of 'animalID' (-1 = all) in [from, to)
+  // passing 'filter' that the database holds (CareRecords rows and
+  // CareArchive chunks) but memory does not: what earlier sessions saved
+  void scanStoredOnly(int animalID, time_t from, time_t to, CareType filter,
+                      Database &db,
+                      const std::function<void(const ArchiveRow &)> &fn) const;
+
+  // Appends the animal's feedings in [from, to) that are not in a live day
+  // (archived, or only in the database) as columns
+  void pastFeedings(int animalID, time_t from, time_t to, Database &db,
+                    std::vector<time_t> &times,
+                    std::vector<double> &amounts) const;
 
 public:
   AnimalCareManager() = default;
 
-  // In-memory operations:
-  void recordFeeding(int animalID, const std::string &food, double amount);
+  // Care plans and due care
+  CareScheduler &getScheduler() { return scheduler; }
+
+  // Archived (compressed) care history
+  const CareArchive &getArchive() const { return archive; }
+
+  // Feeding-intake baselines and alerts
+  IntakeMonitor &getMonitor() { return monitor; }
+
+  // Returns the intake alerts raised by feedings since the last call and
+  // clears them; the caller decides whether and how to report them
+  std::vector<IntakeAlert> takeAlerts() {
+    return std::exchange(pendingAlerts, {});
+  }
+
+  // In-memory operations ('when' of 0 means the current time). Recorded
+  // care is kept unsaved until the next saveToDatabase.
+  void recordFeeding(int animalID, const std::string &food, double amount,
+                     time_t when = 0);
   void recordHealthCheck(int animalID, const std::string &vet,
                          const std::string &notes,
-                         const std::string &diagnosis);
+                         const std::string &diagnosis, time_t when = 0);
   void displayCareRecords(int animalID) const;
 
+  // Moves every whole day that ends at or before 'cutoff' into the
+  // compressed archive and releases its arena. Records remain in the
+  // CareRecords table (see archiveDatabaseBefore).
+  //  - Returns the number of periods released, or -1 (releasing none) if
+  //    the archive could not take them
+  int archiveBefore(time_t cutoff);
+
+  // Returns copies of the animal's records with from <= time < to, oldest
+  // first, restricted to 'filter'. Binary search within each day keeps this
+  // O(days + log n + k).
+  std::vector<CareEntry> recordsBetween(int animalID, time_t from, time_t to,
+                                        CareType filter = CareType::Any) const;
+
+  // recordsBetween and recordsBetweenInDatabase together, in stored form,
+  // oldest first. Memory holds only this session's records (plus the
+  // archive loaded at startup); a record found both there and in the
+  // database (same kind, second and text) is listed once.
+  std::vector<StoredCareRecord>
+  allRecordsBetween(int animalID, time_t from, time_t to, CareType filter,
+                    Database &db) const;
+
+  // Every health check with from <= time < to, sorted by animal and time:
+  // memory (this session's records and the archive loaded at startup) plus
+  // the CareRecords rows and CareArchive chunks in the database. A check
+  // found in several of them (same animal, second and diagnosis) is listed
+  // once.
+  std::vector<DiagnosisEntry> diagnosesBetween(time_t from, time_t to,
+                                               Database &db) const;
+
+  // Grouped totals over all records matching 'query', in memory and stored
+  // in 'db' by earlier sessions (each record counted once, as in
+  // allRecordsBetween). Animals (looked up in 'animals' for species/exhibit)
+  // are split into contiguous ID ranges, each range is aggregated as a task
+  // on 'jobs' (inline if null) into a private hash map, and the partial maps
+  // are merged at the end.
+  CareAggregate aggregate(const CareQuery &query,
+                          const std::vector<Animal> &animals, Database &db,
+                          JobSystem *jobs = nullptr) const;
+
+  // Count/sum/min/max/mean of one animal's feeding amounts in [from, to),
+  // from memory and the feedings earlier sessions stored in 'db' (each
+  // counted once)
+  AmountStats feedingStats(int animalID, time_t from, time_t to,
+                           Database &db) const;
+
+  // Histogram of the same feedings: 'buckets' buckets of 'width' kg
+  // starting at 'lo' (outliers land in the end buckets)
+  std::vector<long> feedingHistogram(int animalID, time_t from, time_t to,
+                                     double lo, double width, size_t buckets,
+                                     Database &db) const;
+
   // Database operations:
+  // Also loads the CareArchive chunks and the intake baselines
   void loadFromDatabase(Database &db);
+
+  // Autosave: inserts the records made since the last save through prepared
+  // INSERTs in one transaction, so a save costs what changed; the intake
+  // baselines those records moved are written in the same transaction
+  //  - Returns the number of rows written, or -1 on failure (the records
+  //    stay unsaved for the next attempt)
+  int saveToDatabase(Database &db);
+  size_t unsavedRecords() const {
+    return unsavedFeedings.size() + unsavedHealthChecks.size();
+  }
+
+  // 'when' of 0 stores the current time; pass the time given to
+  // recordFeeding/recordHealthCheck so both copies carry the same second
   void saveFeedingToDatabase(int animalId, const std::string &food,
-                             double amount, Database &db);
+                             double amount, Database &db, time_t when = 0);
   void saveHealthToDatabase(int animalId, const std::string &vet,
                             const std::string &notes,
-                            const std::string &diagnosis, Database &db);
+                            const std::string &diagnosis, Database &db,
+                            time_t when = 0);
 
-private:
-  // Helper to format a time_t into human-readable string
-  static std::string formatTime(time_t t);
+  // Saves every feeding through one prepared INSERT in a single transaction
+  // (one commit), then records them in memory. Nothing is recorded if the
+  // transaction fails.
+  //  - Returns the number of feedings recorded, or -1 on failure
+  int recordFeedings(const std::vector<FeedingEntry> &batch, Database &db);
+
+  // The database half of recordFeedings: inserts the batch in one
+  // transaction without touching memory (for callers that already recorded
+  // the feedings and persist them later in bulk)
+  //  - Returns the number of rows inserted, or -1 on failure
+  static int saveFeedingsToDatabase(const std::vector<FeedingEntry> &batch,
+                                    Database &db);
+
+  // Same range query against the CareArchive chunks (pruned by their zone
+  // map columns) followed by the CareRecords table, served by the
+  // (animal_id, timestamp) index
+  static std::vector<StoredCareRecord>
+  recordsBetweenInDatabase(int animalId, time_t from, time_t to,
+                           CareType filter, Database &db);
+
+  // Moves CareRecords rows older than 'cutoff' into CareArchive chunks in
+  // one transaction. Rows from before the structured columns whose text
+  // does not split back into its fields unambiguously are left in place.
+  //  - Returns the number of rows archived, or -1 on failure
+  //  - kept: if given, receives the number of old rows left in place
+  static int archiveDatabaseBefore(time_t cutoff, Database &db,
+                                   int *kept = nullptr);
 };
 
 #endif // ANIMAL_CARE_H
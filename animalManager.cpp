@@ -12,12 +12,19 @@
 // addAnimal
 //  - Adds an Animal to both the in-memory vector and the persistent database
 //  - Also attempts to assign the animal to the given Exhibit
-//  - Returns false if exhibit is full (setAnimal() failure)
+//  - Returns false if the ID is taken, the exhibit is full (setAnimal()
+//    failure) or the insert fails; memory and the exhibit are then left as
+//    they were
 bool AnimalManager::addAnimal(const Animal &a, Exhibit &homeExhibit,
                               Database &db) {
   std::cout << "addAnimal Test 1\n";
+  if (exhibitSlots.count(a.getId()) || animalIndex.count(a.getId())) {
+    std::cerr << "[Error] Animal ID " << a.getId() << " is already in use.\n";
+    return false;
+  }
   // 1) Try to add to exhibit
-  if (!homeExhibit.setAnimal(a.getName())) {
+  int slot = homeExhibit.setAnimal(a.getId());
+  if (slot < 0) {
     std::cout << "[DEBUG] setAnimal returned FALSE for '" << a.getName()
               << "'\n";
     return false; // Exhibit full or invalid
@@ -27,7 +34,9 @@ bool AnimalManager::addAnimal(const Animal &a, Exhibit &homeExhibit,
   std::cout << "addAnimal Test 2\n";
 
   // 2) Store in-memory
+  animalIndex[a.getId()] = animals.size();
   animals.push_back(a);
+  exhibitSlots[a.getId()] = slot;
 
   std::cout << "addAnimal Test 2\n";
 
@@ -45,6 +54,11 @@ bool AnimalManager::addAnimal(const Animal &a, Exhibit &homeExhibit,
 
   if (!db.execute(sql.str())) {
     std::cerr << "[ERROR] Failed to insert animal into database!\n";
+    // Undo steps 1 and 2
+    homeExhibit.removeAnimalAt(slot);
+    animals.pop_back();
+    animalIndex.erase(a.getId());
+    exhibitSlots.erase(a.getId());
     return false;
   }
   // db.execute(sql.str()); // Executes SQL via wrapper
@@ -53,6 +67,119 @@ bool AnimalManager::addAnimal(const Animal &a, Exhibit &homeExhibit,
   return true;
 }
 
+// addAnimals
+//  - Persists every placed animal through one prepared INSERT inside a single
+//    transaction, then applies the placements in memory once it commits
+int AnimalManager::addAnimals(const std::vector<Animal> &batch,
+                              const std::vector<int> &exhibitOf,
+                              ExhibitManager &em, Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql = "INSERT INTO Animals (id, name, species, age, exhibit) "
+                    "VALUES (?, ?, ?, ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare Animals insert: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return -1;
+  }
+
+  if (!db.beginTransaction()) {
+    sqlite3_finalize(stmt);
+    return -1;
+  }
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (exhibitOf[i] < 0)
+      continue;
+    const Animal &a = batch[i];
+    const std::string exName =
+        em.getExhibitByIndex(exhibitOf[i]).getExhibitName();
+    sqlite3_bind_int(stmt, 1, a.getId());
+    sqlite3_bind_text(stmt, 2, a.getName().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, a.getSpecies().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 4, a.getAge());
+    sqlite3_bind_text(stmt, 5, exName.c_str(), -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      std::cerr << "[ERROR] Failed to insert animal '" << a.getName()
+                << "': " << sqlite3_errmsg(db.get()) << std::endl;
+      sqlite3_finalize(stmt);
+      db.rollback();
+      return -1;
+    }
+    sqlite3_reset(stmt);
+  }
+  sqlite3_finalize(stmt);
+  if (!db.commit()) {
+    db.rollback();
+    return -1;
+  }
+
+  // Committed: mirror the placements in memory
+  int added = 0;
+  animals.reserve(animals.size() + batch.size());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (exhibitOf[i] < 0)
+      continue;
+    Exhibit &ex = em.getExhibitByIndex(exhibitOf[i]);
+    Animal a = batch[i];
+    a.setAnimalExhibit(ex.getExhibitName());
+    exhibitSlots[a.getId()] = ex.setAnimal(a.getId());
+    animalIndex[a.getId()] = animals.size();
+    animals.push_back(a);
+    ++added;
+  }
+  return added;
+}
+
+// moveAnimals
+//  - Persists all exhibit changes in a single transaction, then frees each
+//    animal's old slot and claims one in its new exhibit
+bool AnimalManager::moveAnimals(const std::vector<RebalanceMove> &moves,
+                                ExhibitManager &em, Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql = "UPDATE Animals SET exhibit = ? WHERE id = ?;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare Animals update: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+
+  if (!db.beginTransaction()) {
+    sqlite3_finalize(stmt);
+    return false;
+  }
+  for (const auto &m : moves) {
+    const std::string exName =
+        em.getExhibitByIndex(m.toExhibit).getExhibitName();
+    sqlite3_bind_text(stmt, 1, exName.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, m.animalId);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      std::cerr << "[ERROR] Failed to move animal " << m.animalId << ": "
+                << sqlite3_errmsg(db.get()) << std::endl;
+      sqlite3_finalize(stmt);
+      db.rollback();
+      return false;
+    }
+    sqlite3_reset(stmt);
+  }
+  sqlite3_finalize(stmt);
+  if (!db.commit()) {
+    db.rollback();
+    return false;
+  }
+
+  // Committed: apply in memory, finding each animal through the ID index
+  for (const auto &m : moves) {
+    Exhibit &from = em.getExhibitByIndex(m.fromExhibit);
+    Exhibit &to = em.getExhibitByIndex(m.toExhibit);
+    from.removeAnimalAt(exhibitSlots[m.animalId]);
+    exhibitSlots[m.animalId] = to.setAnimal(m.animalId);
+    auto it = animalIndex.find(m.animalId);
+    if (it != animalIndex.end()) {
+      animals[it->second].setAnimalExhibit(to.getExhibitName());
+    }
+  }
+  return true;
+}
+
 // viewAnimals
 //  - Prints a simple list of all animals currently in memory
 void AnimalManager::viewAnimals() const {
@@ -113,30 +240,89 @@ void AnimalManager::updateAnimal(int idx, ExhibitManager &em) {
   int newExIdx = em.selectExhibit();
   const std::string oldExName = a.getExhibit();
   if (newExIdx >= 0) {
-    // Remove from old exhibit
-    em.getExhibitByName(oldExName).removeAnimal(a.getName());
+    // Remove from old exhibit: the reverse index gives the slot directly
+    auto slotIt = exhibitSlots.find(a.getId());
+    if (slotIt != exhibitSlots.end()) {
+      em.getExhibitByName(oldExName).removeAnimalAt(slotIt->second);
+      exhibitSlots.erase(slotIt);
+    }
 
     // Add to new exhibit
     Exhibit &newEx = em.getExhibitByIndex(newExIdx);
-    if (newEx.setAnimal(a.getName())) {
+    int slot = newEx.setAnimal(a.getId());
+    if (slot >= 0) {
       a.setAnimalExhibit(newEx.getExhibitName());
+      exhibitSlots[a.getId()] = slot;
     } else {
       std::cerr << "[Warning] Exhibit full—keeping old exhibit.\n";
-      em.getExhibitByName(oldExName).setAnimal(a.getName());
+      if (em.exhibitExists(oldExName)) {
+        exhibitSlots[a.getId()] =
+            em.getExhibitByName(oldExName).setAnimal(a.getId());
+      }
     }
   }
 }
 
 // removeAnimal
-//  - Erases the first animal matching the given ID from the in-memory list
-bool AnimalManager::removeAnimal(int id) {
-  for (auto it = animals.begin(); it != animals.end(); ++it) {
-    if (it->getId() == id) {
-      animals.erase(it);
-      return true;
+//  - Frees the animal's exhibit slot and erases it from the in-memory list
+//  - The animals after it shift down one position, and so do their index
+//    entries
+bool AnimalManager::removeAnimal(int id, ExhibitManager &em) {
+  auto indexIt = animalIndex.find(id);
+  if (indexIt == animalIndex.end()) {
+    return false; // Not found
+  }
+  const size_t pos = indexIt->second;
+  animalIndex.erase(indexIt);
+  auto slotIt = exhibitSlots.find(id);
+  if (slotIt != exhibitSlots.end()) {
+    em.getExhibitByName(animals[pos].getExhibit())
+        .removeAnimalAt(slotIt->second);
+    exhibitSlots.erase(slotIt);
+  }
+  animals.erase(animals.begin() + pos);
+  for (size_t i = pos; i < animals.size(); ++i) {
+    animalIndex[animals[i].getId()] = i;
+  }
+  return true;
+}
+
+// viewAnimalsInExhibit
+//  - Prints the animals housed in 'ex' with the slot each one occupies
+void AnimalManager::viewAnimalsInExhibit(const Exhibit &ex) const {
+  std::cout << "\n--- Animals in '" << ex.getExhibitName() << "' ---"
+            << std::endl;
+  bool any = false;
+  for (int slot = 0; slot < ex.getExhibitCapacity(); ++slot) {
+    const int id = ex.getAnimal(slot);
+    auto it = animalIndex.find(id);
+    if (id == Exhibit::EMPTY_SLOT || it == animalIndex.end()) {
+      continue;
+    }
+    const Animal &a = animals[it->second];
+    std::cout << "  " << slot << ") " << a.getName() << " (ID " << a.getId()
+              << ")" << std::endl;
+    any = true;
+  }
+  if (!any) {
+    std::cout << "(none)" << std::endl;
+  }
+  std::cout << "-------------------------------" << std::endl;
+}
+
+// residentsOf
+//  - Same slot walk as viewAnimalsInExhibit
+std::vector<const Animal *>
+AnimalManager::residentsOf(const Exhibit &ex) const {
+  std::vector<const Animal *> out;
+  for (int slot = 0; slot < ex.getExhibitCapacity(); ++slot) {
+    const int id = ex.getAnimal(slot);
+    auto it = animalIndex.find(id);
+    if (id != Exhibit::EMPTY_SLOT && it != animalIndex.end()) {
+      out.push_back(&animals[it->second]);
     }
   }
-  return false; // Not found
+  return out;
 }
 
 // getAnimalByIndex
@@ -175,11 +361,15 @@ void AnimalManager::loadFromDatabase(ExhibitManager &em, Database &db) {
 
     // Reconstruct Animal in memory
     Animal a(name, species, id, age, exhibit);
+    animalIndex[id] = animals.size();
     animals.push_back(a);
 
     // Place into exhibit if exists
     if (em.exhibitExists(exhibit)) {
-      em.getExhibitByName(exhibit).setAnimal(name);
+      int slot = em.getExhibitByName(exhibit).setAnimal(id);
+      if (slot >= 0) {
+        exhibitSlots[id] = slot;
+      }
     } else {
       std::cerr << "[Warning] Exhibit '" << exhibit
                 << "' not found for animal '" << name
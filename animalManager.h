@@ -8,7 +8,9 @@
 #include "animal.h"         // Definition of Animal class
 #include "database.h"       // Database wrapper for SQLite operations
 #include "exhibitManager.h" // ExhibitManager for exhibit assignments
+#include "rebalancePlanner.h" // RebalanceMove records applied by moveAnimals
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class AnimalManager {
@@ -16,6 +18,15 @@ public:
   // In-memory storage of Animal objects
   std::vector<Animal> animals;
 
+  // Reverse index: animal ID -> slot it occupies in its current exhibit.
+  // Kept in sync with Exhibit::setAnimal/removeAnimalAt so moves and removals
+  // never have to scan an exhibit.
+  std::unordered_map<int, int> exhibitSlots;
+
+  // ID index: animal ID -> position in 'animals'. Exhibit listings resolve
+  // each occupied slot through it instead of scanning every animal.
+  std::unordered_map<int, std::size_t> animalIndex;
+
   // Next ID to assign if auto-generating; currently unused since ID comes from
   // SQLite
   int nextId;
@@ -25,9 +36,24 @@ public:
 
   // Adds a new Animal both to the specified Exhibit and to the database
   //  - 'a' must have a valid ID, name, species, age, and exhibit
-  //  - Returns false if exhibit is full or invalid
+  //  - Returns false (changing nothing) if the ID is already in use, the
+  //    exhibit is full or invalid, or the database insert fails
   bool addAnimal(const Animal &a, Exhibit &homeExhibit, Database &db);
 
+  // Adds a batch of Animals according to 'exhibitOf' (exhibit index per
+  // animal, -1 to skip), inserting them all in a single transaction
+  //  - Returns the number added, or -1 if the transaction was rolled back
+  int addAnimals(const std::vector<Animal> &batch,
+                 const std::vector<int> &exhibitOf, ExhibitManager &em,
+                 Database &db);
+
+  // Applies exhibit moves (animal ID, from/to exhibit index) atomically:
+  // every Animals row is updated in one transaction, and memory is only
+  // touched after it commits
+  //  - Returns false (and changes nothing) if the transaction fails
+  bool moveAnimals(const std::vector<RebalanceMove> &moves, ExhibitManager &em,
+                   Database &db);
+
   // Loads all Animal records from the database, reconstructs Animal objects,
   // and places them into the appropriate Exhibit via ExhibitManager
   void loadFromDatabase(ExhibitManager &em, Database &db);
@@ -43,13 +69,21 @@ public:
   //  - idx: index in the 'animals' vector
   void updateAnimal(int idx, ExhibitManager &em);
 
-  // Removes an animal by its unique ID (not vector index)
+  // Removes an animal by its unique ID (not vector index) and frees its
+  // exhibit slot
   //  - Returns true if an Animal with that ID was found and erased
-  bool removeAnimal(int id);
+  bool removeAnimal(int id, ExhibitManager &em);
+
+  // Lists the animals housed in 'ex' by slot, with names and IDs
+  //  - O(capacity): reads the exhibit's slots, not the whole collection
+  void viewAnimalsInExhibit(const Exhibit &ex) const;
 
   // Returns a reference to an Animal by its vector index; throws if out of
   // range
   Animal &getAnimalByIndex(int idx);
+
+  // Animals currently housed in 'ex', in slot order; O(capacity)
+  std::vector<const Animal *> residentsOf(const Exhibit &ex) const;
 };
 
 #endif // ANIMAL_MANAGER_H
@@ -0,0 +1,42 @@
+// careAggregation.cpp
+// Implements ordering, hashing and sorting helpers for care aggregation
+// results.
+
+#include "careAggregation.h"
+#include <algorithm>  // std::sort
+#include <functional> // std::hash
+#include <tuple>      // std::tie for lexicographic comparison
+
+// operator<
+//  - Orders keys by time bucket first so reports read chronologically
+bool CareGroupKey::operator<(const CareGroupKey &o) const {
+  return std::tie(bucket, species, exhibit, animalId, foodType, vetName) <
+         std::tie(o.bucket, o.species, o.exhibit, o.animalId, o.foodType,
+                  o.vetName);
+}
+
+// CareGroupKeyHash
+//  - Boost-style hash_combine over every dimension
+std::size_t CareGroupKeyHash::operator()(const CareGroupKey &k) const {
+  std::size_t h = std::hash<int>{}(k.animalId);
+  auto mix = [&h](std::size_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+  };
+  mix(std::hash<time_t>{}(k.bucket));
+  mix(std::hash<std::string>{}(k.species));
+  mix(std::hash<std::string>{}(k.exhibit));
+  mix(std::hash<std::string>{}(k.foodType));
+  mix(std::hash<std::string>{}(k.vetName));
+  return h;
+}
+
+// sortedRows
+//  - Copies an aggregate into a vector ordered by key
+std::vector<std::pair<CareGroupKey, CareTotals>>
+sortedRows(const CareAggregate &agg) {
+  std::vector<std::pair<CareGroupKey, CareTotals>> rows(agg.begin(),
+                                                        agg.end());
+  std::sort(rows.begin(), rows.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  return rows;
+}
@@ -0,0 +1,84 @@
+// careAggregation.h
+// Declaration of the query, key and result types used by
+// AnimalCareManager::aggregate for grouped care statistics.
+
+#ifndef CARE_AGGREGATION_H
+#define CARE_AGGREGATION_H
+
+#include <cstddef>       // std::size_t
+#include <ctime>         // time_t
+#include <limits>        // Open-ended time range defaults
+#include <string>        // std::string
+#include <unordered_map> // Group -> totals
+#include <utility>       // std::pair
+#include <vector>        // Sorted result rows
+
+enum class CareType : int; // Defined in animalCare.h
+
+// Dimensions a care aggregation can group by; combine with |
+enum CareGroupBy : unsigned {
+  GROUP_NONE = 0,
+  GROUP_ANIMAL = 1 << 0,  // Animal ID
+  GROUP_SPECIES = 1 << 1, // Animal's species
+  GROUP_EXHIBIT = 1 << 2, // Animal's current exhibit
+  GROUP_FOOD = 1 << 3,    // Feeding food type (empty for health checks)
+  GROUP_VET = 1 << 4,     // Health check vet (empty for feedings)
+  GROUP_TIME = 1 << 5,    // Time bucket (see CareQuery::bucket)
+};
+
+// Width of a GROUP_TIME bucket (UTC)
+enum class TimeBucket { Day, Month };
+
+// What to aggregate
+struct CareQuery {
+  unsigned groupBy = GROUP_NONE;       // CareGroupBy flags
+  TimeBucket bucket = TimeBucket::Day; // Used with GROUP_TIME
+  CareType filter{};                   // Record kinds (CareType::Any)
+  time_t from = std::numeric_limits<time_t>::min(); // Inclusive
+  time_t to = std::numeric_limits<time_t>::max();   // Exclusive
+};
+
+// Group identity; dimensions not in the query keep their defaults
+struct CareGroupKey {
+  int animalId = -1;
+  std::string species;
+  std::string exhibit;
+  std::string foodType;
+  std::string vetName;
+  time_t bucket = 0;
+
+  bool operator==(const CareGroupKey &o) const {
+    return animalId == o.animalId && bucket == o.bucket &&
+           species == o.species && exhibit == o.exhibit &&
+           foodType == o.foodType && vetName == o.vetName;
+  }
+  bool operator<(const CareGroupKey &o) const;
+};
+
+struct CareGroupKeyHash {
+  std::size_t operator()(const CareGroupKey &k) const;
+};
+
+// Per-group totals
+struct CareTotals {
+  long count = 0;         // Records in the group
+  long feedings = 0;      // Of which feedings
+  long healthChecks = 0;  // Of which health checks
+  double kilograms = 0.0; // Total food fed
+
+  void merge(const CareTotals &o) {
+    count += o.count;
+    feedings += o.feedings;
+    healthChecks += o.healthChecks;
+    kilograms += o.kilograms;
+  }
+};
+
+using CareAggregate =
+    std::unordered_map<CareGroupKey, CareTotals, CareGroupKeyHash>;
+
+// Rows of an aggregate sorted by key, for display
+std::vector<std::pair<CareGroupKey, CareTotals>>
+sortedRows(const CareAggregate &agg);
+
+#endif // CARE_AGGREGATION_H
@@ -0,0 +1,485 @@
+// careArchive.cpp
+// Implements CareArchive: column encoding/decoding of monthly chunks and
+// their persistence in the CareArchive table.
+
+#include "careArchive.h"
+#include "animalCare.h"  // CareType values
+#include <algorithm>     // std::stable_sort, std::max
+#include <bit>           // std::bit_cast, std::bit_width
+#include <cstring>       // std::memcpy
+#include <iostream>      // std::cerr
+#include <string>        // Dictionary keys
+#include <unordered_map> // Value -> dictionary code
+
+namespace {
+
+// ===== Byte-level helpers =====
+struct ByteWriter {
+  std::vector<std::uint8_t> &out;
+
+  void varint(std::uint64_t v) {
+    while (v >= 0x80) {
+      out.push_back(static_cast<std::uint8_t>(v) | 0x80);
+      v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+  }
+  void raw(const void *p, std::size_t n) {
+    auto *b = static_cast<const std::uint8_t *>(p);
+    out.insert(out.end(), b, b + n);
+  }
+  void str(std::string_view s) {
+    varint(s.size());
+    raw(s.data(), s.size());
+  }
+  // One width byte, then each value in 'width' bits, LSB first
+  void bits(const std::vector<std::uint32_t> &values) {
+    std::uint32_t maxValue = 0;
+    for (std::uint32_t v : values)
+      maxValue = std::max(maxValue, v);
+    const int width = std::bit_width(maxValue);
+    out.push_back(static_cast<std::uint8_t>(width));
+    std::uint64_t acc = 0;
+    int used = 0;
+    for (std::uint32_t v : values) {
+      acc |= std::uint64_t{v} << used;
+      used += width;
+      while (used >= 8) {
+        out.push_back(static_cast<std::uint8_t>(acc));
+        acc >>= 8;
+        used -= 8;
+      }
+    }
+    if (used > 0)
+      out.push_back(static_cast<std::uint8_t>(acc));
+  }
+};
+
+// Bounds-checked reader; any overrun clears 'ok' and yields zeros
+struct ByteReader {
+  const std::uint8_t *p;
+  const std::uint8_t *end;
+  bool ok = true;
+
+  std::uint64_t varint() {
+    std::uint64_t v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+      std::uint8_t b = *p++;
+      v |= std::uint64_t{b & 0x7fu} << shift;
+      if (!(b & 0x80))
+        return v;
+    }
+    ok = false;
+    return 0;
+  }
+  bool raw(void *dst, std::size_t n) {
+    if (static_cast<std::size_t>(end - p) < n) {
+      ok = false;
+      return false;
+    }
+    std::memcpy(dst, p, n);
+    p += n;
+    return true;
+  }
+  std::string_view str() {
+    std::uint64_t n = varint();
+    if (!ok || static_cast<std::uint64_t>(end - p) < n) {
+      ok = false;
+      return {};
+    }
+    std::string_view s(reinterpret_cast<const char *>(p), n);
+    p += n;
+    return s;
+  }
+  void bits(std::size_t count, std::vector<std::uint32_t> &values) {
+    values.assign(count, 0);
+    if (p >= end) {
+      ok = false;
+      return;
+    }
+    const int width = *p++;
+    if (width > 32) {
+      ok = false;
+      return;
+    }
+    const std::size_t bytes = (count * width + 7) / 8;
+    if (static_cast<std::size_t>(end - p) < bytes) {
+      ok = false;
+      return;
+    }
+    const std::uint64_t mask = (std::uint64_t{1} << width) - 1;
+    std::uint64_t acc = 0;
+    int avail = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      while (avail < width) {
+        acc |= std::uint64_t{*p++} << avail;
+        avail += 8;
+      }
+      values[i] = static_cast<std::uint32_t>(acc & mask);
+      acc >>= width;
+      avail -= width;
+    }
+  }
+};
+
+// Dictionary-encodes 'values' (in first-seen order) followed by their codes
+void writeStrings(ByteWriter &w, const std::vector<std::string_view> &values) {
+  std::unordered_map<std::string_view, std::uint32_t> codeOf;
+  std::vector<std::string_view> dict;
+  std::vector<std::uint32_t> codes;
+  codes.reserve(values.size());
+  for (std::string_view v : values) {
+    auto [it, inserted] =
+        codeOf.try_emplace(v, static_cast<std::uint32_t>(dict.size()));
+    if (inserted)
+      dict.push_back(v);
+    codes.push_back(it->second);
+  }
+  w.varint(dict.size());
+  for (std::string_view s : dict)
+    w.str(s);
+  w.bits(codes);
+}
+
+// Same for doubles; values are keyed by bit pattern so decoding is exact
+void writeDoubles(ByteWriter &w, const std::vector<double> &values) {
+  std::unordered_map<std::uint64_t, std::uint32_t> codeOf;
+  std::vector<double> dict;
+  std::vector<std::uint32_t> codes;
+  codes.reserve(values.size());
+  for (double v : values) {
+    auto [it, inserted] =
+        codeOf.try_emplace(std::bit_cast<std::uint64_t>(v),
+                           static_cast<std::uint32_t>(dict.size()));
+    if (inserted)
+      dict.push_back(v);
+    codes.push_back(it->second);
+  }
+  w.varint(dict.size());
+  for (double d : dict)
+    w.raw(&d, sizeof(d));
+  w.bits(codes);
+}
+
+// A dictionary column read back; codes are checked against the dictionary
+template <typename T> struct DictColumn {
+  std::vector<T> dict;
+  std::vector<std::uint32_t> codes;
+
+  const T &operator[](std::size_t i) const { return dict[codes[i]]; }
+  bool valid() const {
+    for (std::uint32_t c : codes)
+      if (c >= dict.size())
+        return false;
+    return true;
+  }
+};
+
+bool readStrings(ByteReader &r, std::size_t count,
+                 DictColumn<std::string_view> &col) {
+  std::uint64_t n = r.varint();
+  if (!r.ok || n > static_cast<std::uint64_t>(r.end - r.p))
+    return false;
+  col.dict.resize(n);
+  for (auto &s : col.dict)
+    s = r.str();
+  r.bits(count, col.codes);
+  return r.ok && col.valid();
+}
+
+bool readDoubles(ByteReader &r, std::size_t count, DictColumn<double> &col) {
+  std::uint64_t n = r.varint();
+  if (!r.ok || n > static_cast<std::uint64_t>(r.end - r.p) / sizeof(double))
+    return false;
+  col.dict.resize(n);
+  for (auto &d : col.dict)
+    r.raw(&d, sizeof(d));
+  r.bits(count, col.codes);
+  return r.ok && col.valid();
+}
+
+// A chunk's columns; string views point into the chunk's bytes
+struct DecodedChunk {
+  std::vector<time_t> times;
+  std::vector<int> animals;
+  std::vector<std::uint32_t> isHealth; // 0 = feeding, 1 = health
+  DictColumn<std::string_view> food;   // Indexed by feeding ordinal
+  DictColumn<double> amount;           // Indexed by feeding ordinal
+  DictColumn<std::string_view> vet;    // Indexed by health ordinal
+  DictColumn<std::string_view> notes;  // Indexed by health ordinal
+  DictColumn<std::string_view> diagnosis;
+};
+
+void encode(const std::vector<ArchiveRow> &rows, ArchiveChunk &chunk) {
+  chunk.rows = rows.size();
+  chunk.minTime = rows.front().time;
+  chunk.maxTime = rows.back().time;
+  chunk.minAnimal = chunk.maxAnimal = rows.front().animalId;
+  for (const ArchiveRow &r : rows) {
+    chunk.minAnimal = std::min(chunk.minAnimal, r.animalId);
+    chunk.maxAnimal = std::max(chunk.maxAnimal, r.animalId);
+  }
+
+  std::vector<std::uint32_t> kinds, animals;
+  std::vector<std::string_view> food, vet, notes, diagnosis;
+  std::vector<double> amount;
+  for (const ArchiveRow &r : rows) {
+    bool health = r.kind == CareType::Health;
+    kinds.push_back(health);
+    animals.push_back(static_cast<std::uint32_t>(
+        static_cast<std::int64_t>(r.animalId) - chunk.minAnimal));
+    if (health) {
+      vet.push_back(r.vetName);
+      notes.push_back(r.notes);
+      diagnosis.push_back(r.diagnosis);
+    } else {
+      food.push_back(r.foodType);
+      amount.push_back(r.amount);
+    }
+  }
+
+  std::vector<std::uint8_t> out;
+  ByteWriter w{out};
+  w.varint(rows.size());
+  time_t prev = chunk.minTime;
+  for (const ArchiveRow &r : rows) {
+    w.varint(static_cast<std::uint64_t>(r.time - prev)); // Sorted: >= 0
+    prev = r.time;
+  }
+  w.bits(kinds);
+  w.bits(animals);
+  writeStrings(w, food);
+  writeDoubles(w, amount);
+  writeStrings(w, vet);
+  writeStrings(w, notes);
+  writeStrings(w, diagnosis);
+  out.shrink_to_fit();
+  chunk.data = std::move(out);
+}
+
+bool decode(const ArchiveChunk &chunk, DecodedChunk &d) {
+  ByteReader r{chunk.data.data(), chunk.data.data() + chunk.data.size()};
+  const std::uint64_t rows = r.varint();
+  // Every row needs at least one byte of timestamp
+  if (!r.ok || rows != chunk.rows ||
+      rows > static_cast<std::uint64_t>(r.end - r.p)) {
+    return false;
+  }
+  d.times.resize(rows);
+  time_t t = chunk.minTime;
+  for (auto &slot : d.times) {
+    t += static_cast<time_t>(r.varint());
+    slot = t;
+  }
+  r.bits(rows, d.isHealth);
+  std::vector<std::uint32_t> offsets;
+  r.bits(rows, offsets);
+  if (!r.ok)
+    return false;
+  d.animals.resize(rows);
+  std::size_t health = 0;
+  for (std::size_t i = 0; i < rows; ++i) {
+    d.animals[i] = static_cast<int>(chunk.minAnimal + std::int64_t{offsets[i]});
+    health += d.isHealth[i];
+  }
+  const std::size_t feeding = rows - health;
+  return readStrings(r, feeding, d.food) && readDoubles(r, feeding, d.amount) &&
+         readStrings(r, health, d.vet) && readStrings(r, health, d.notes) &&
+         readStrings(r, health, d.diagnosis);
+}
+
+// Emits every decoded row in order; the callback returns false to stop
+template <typename Fn> void forEachRow(const DecodedChunk &d, Fn &&fn) {
+  std::size_t fi = 0, hi = 0;
+  for (std::size_t i = 0; i < d.times.size(); ++i) {
+    ArchiveRow row{d.animals[i], d.times[i], CareType::Feeding, 0.0, {}, {},
+                   {}, {}};
+    if (d.isHealth[i]) {
+      row.kind = CareType::Health;
+      row.vetName = d.vet[hi];
+      row.notes = d.notes[hi];
+      row.diagnosis = d.diagnosis[hi];
+      ++hi;
+    } else {
+      row.amount = d.amount[fi];
+      row.foodType = d.food[fi];
+      ++fi;
+    }
+    if (!fn(row))
+      return;
+  }
+}
+
+} // namespace
+
+// monthStartOf
+//  - Times outside gmtime's range fall back to the value itself
+time_t CareArchive::monthStartOf(time_t t) {
+  std::tm tm{};
+  if (!gmtime_r(&t, &tm)) {
+    return t;
+  }
+  tm.tm_mday = 1;
+  tm.tm_hour = 0;
+  tm.tm_min = 0;
+  tm.tm_sec = 0;
+  return timegm(&tm);
+}
+
+// append
+//  - Decodes every existing chunk the rows touch before changing any, so a
+//    corrupt month leaves the whole archive as it was
+//  - Merges, sorts by time (stable, so same-second records keep their
+//    order) and re-encodes each month
+bool CareArchive::append(const std::vector<ArchiveRow> &rows) {
+  std::map<time_t, std::vector<ArchiveRow>> byMonth;
+  for (const ArchiveRow &r : rows) {
+    byMonth[monthStartOf(r.time)].push_back(r);
+  }
+
+  // Decoded chunks keep views into their chunk's bytes alive until that
+  // month is re-encoded
+  std::map<time_t, DecodedChunk> old;
+  for (const auto &[month, added] : byMonth) {
+    auto it = chunks.find(month);
+    if (it != chunks.end() && it->second.rows > 0 &&
+        !decode(it->second, old[month])) {
+      std::cerr << "[Error] Corrupt care archive chunk; nothing was "
+                   "archived.\n";
+      return false;
+    }
+  }
+
+  for (auto &[month, added] : byMonth) {
+    ArchiveChunk &chunk = chunks[month];
+    chunk.monthStart = month;
+    std::vector<ArchiveRow> merged;
+    auto prior = old.find(month);
+    if (prior != old.end()) {
+      merged.reserve(chunk.rows + added.size());
+      forEachRow(prior->second, [&](const ArchiveRow &r) {
+        merged.push_back(r);
+        return true;
+      });
+    }
+    merged.insert(merged.end(), added.begin(), added.end());
+    std::stable_sort(merged.begin(), merged.end(),
+                     [](const ArchiveRow &a, const ArchiveRow &b) {
+                       return a.time < b.time;
+                     });
+    encode(merged, chunk);
+    chunk.dirty = true;
+  }
+  return true;
+}
+
+// scan
+//  - Zone maps prune whole months; within a month the rows are filtered
+//    after decoding (the whole chunk is decoded at once)
+void CareArchive::scan(
+    int animalId, time_t from, time_t to,
+    const std::function<void(const ArchiveRow &)> &fn) const {
+  DecodedChunk d;
+  for (const auto &[month, chunk] : chunks) {
+    if (!chunk.mayContain(animalId, from, to)) {
+      continue;
+    }
+    if (!decode(chunk, d)) {
+      std::cerr << "[Error] Skipping corrupt care archive chunk.\n";
+      continue;
+    }
+    forEachRow(d, [&](const ArchiveRow &r) {
+      if (r.time >= to)
+        return false;
+      if (r.time >= from && (animalId < 0 || r.animalId == animalId))
+        fn(r);
+      return true;
+    });
+  }
+}
+
+std::size_t CareArchive::rowCount() const {
+  std::size_t n = 0;
+  for (const auto &[month, chunk] : chunks)
+    n += chunk.rows;
+  return n;
+}
+
+std::size_t CareArchive::encodedBytes() const {
+  std::size_t n = 0;
+  for (const auto &[month, chunk] : chunks)
+    n += chunk.data.size();
+  return n;
+}
+
+// ===== Persistence Layer =====
+// loadFromDatabase
+//  - Replaces any in-memory chunk for the same month
+bool CareArchive::loadFromDatabase(Database &db, time_t from, time_t to) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "SELECT month, min_time, max_time, min_animal, max_animal, row_count, "
+      "data FROM CareArchive WHERE max_time >= ? AND min_time < ? "
+      "ORDER BY month;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+  sqlite3_bind_int64(stmt, 1, from);
+  sqlite3_bind_int64(stmt, 2, to);
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    ArchiveChunk chunk;
+    chunk.monthStart = sqlite3_column_int64(stmt, 0);
+    chunk.minTime = sqlite3_column_int64(stmt, 1);
+    chunk.maxTime = sqlite3_column_int64(stmt, 2);
+    chunk.minAnimal = sqlite3_column_int(stmt, 3);
+    chunk.maxAnimal = sqlite3_column_int(stmt, 4);
+    chunk.rows = static_cast<std::size_t>(sqlite3_column_int64(stmt, 5));
+    auto *blob =
+        static_cast<const std::uint8_t *>(sqlite3_column_blob(stmt, 6));
+    chunk.data.assign(blob, blob + sqlite3_column_bytes(stmt, 6));
+    chunks[chunk.monthStart] = std::move(chunk);
+  }
+  sqlite3_finalize(stmt);
+  return true;
+}
+
+// saveToDatabase
+//  - One prepared INSERT OR REPLACE reused for every dirty chunk; callers
+//    wrap it in a transaction together with any related changes
+bool CareArchive::saveToDatabase(Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "INSERT OR REPLACE INTO CareArchive (month, min_time, max_time, "
+      "min_animal, max_animal, row_count, data) VALUES (?, ?, ?, ?, ?, ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+  bool ok = true;
+  for (auto &[month, chunk] : chunks) {
+    if (!chunk.dirty) {
+      continue;
+    }
+    sqlite3_bind_int64(stmt, 1, chunk.monthStart);
+    sqlite3_bind_int64(stmt, 2, chunk.minTime);
+    sqlite3_bind_int64(stmt, 3, chunk.maxTime);
+    sqlite3_bind_int(stmt, 4, chunk.minAnimal);
+    sqlite3_bind_int(stmt, 5, chunk.maxAnimal);
+    sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(chunk.rows));
+    sqlite3_bind_blob(stmt, 7, chunk.data.data(),
+                      static_cast<int>(chunk.data.size()), SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      std::cerr << "[Error] Failed to save care archive chunk: "
+                << sqlite3_errmsg(db.get()) << std::endl;
+      ok = false;
+      break;
+    }
+    chunk.dirty = false;
+    sqlite3_reset(stmt);
+  }
+  sqlite3_finalize(stmt);
+  return ok;
+}
@@ -0,0 +1,91 @@
+// careArchive.h
+// Declaration of CareArchive: historical care records stored as compressed
+// column chunks, one per UTC month, for bulk reporting.
+
+#ifndef CARE_ARCHIVE_H
+#define CARE_ARCHIVE_H
+
+#include "database.h"  // Chunk persistence (CareArchive table)
+#include <cstddef>     // std::size_t
+#include <cstdint>     // Encoded byte buffers
+#include <ctime>       // time_t
+#include <functional>  // Scan callback
+#include <limits>      // Open-ended load range defaults
+#include <map>         // Month -> chunk, oldest first
+#include <string_view> // Row string fields
+#include <vector>      // Rows and byte buffers
+
+enum class CareType : int; // Defined in animalCare.h
+
+// One archived record. The string fields view storage owned by the caller
+// (append) or by the decoded chunk (scan) and are only valid during the call.
+struct ArchiveRow {
+  int animalId;
+  time_t time;
+  CareType kind;              // Feeding or Health
+  double amount;              // Feeding only
+  std::string_view foodType;  // Feeding only
+  std::string_view vetName;   // Health only
+  std::string_view notes;     // Health only
+  std::string_view diagnosis; // Health only
+};
+
+// Encoded month of records, sorted by time. Column layout:
+//  - timestamps: varint deltas from minTime
+//  - kind: one bit per row
+//  - animal IDs: bit-packed offsets from minAnimal
+//  - food, amount, vet, notes, diagnosis: a dictionary plus bit-packed codes,
+//    stored only for the rows of the kind they belong to
+// The zone map (min/max time and animal) is kept outside the encoded bytes
+// so chunks can be pruned without decoding them.
+struct ArchiveChunk {
+  time_t monthStart = 0;
+  time_t minTime = 0;
+  time_t maxTime = 0;
+  int minAnimal = 0;
+  int maxAnimal = 0;
+  std::size_t rows = 0;
+  std::vector<std::uint8_t> data;
+  bool dirty = false; // Changed since it was loaded/saved
+
+  // True if the chunk may hold rows for 'animalId' (-1 = any) in [from, to)
+  bool mayContain(int animalId, time_t from, time_t to) const {
+    return minTime < to && maxTime >= from &&
+           (animalId < 0 || (animalId >= minAnimal && animalId <= maxAnimal));
+  }
+};
+
+class CareArchive {
+public:
+  // Start (00:00 UTC on the 1st) of the month containing 't'
+  static time_t monthStartOf(time_t t);
+
+  // Adds rows, re-encoding each month they touch (merged with rows already
+  // archived for that month)
+  //  - Returns false, changing nothing, if an existing chunk of one of those
+  //    months cannot be decoded
+  bool append(const std::vector<ArchiveRow> &rows);
+
+  // Calls 'fn' for each row of 'animalId' (-1 = all animals) with
+  // from <= time < to, oldest first. Months outside the range (or whose
+  // animal range excludes 'animalId') are skipped without decoding.
+  void scan(int animalId, time_t from, time_t to,
+            const std::function<void(const ArchiveRow &)> &fn) const;
+
+  std::size_t rowCount() const;
+  std::size_t encodedBytes() const;
+  bool empty() const { return chunks.empty(); }
+
+  // Database operations: chunks live in the CareArchive table keyed by
+  // month. Loading only the months overlapping [from, to) is done with the
+  // zone map columns.
+  bool loadFromDatabase(Database &db,
+                        time_t from = std::numeric_limits<time_t>::min(),
+                        time_t to = std::numeric_limits<time_t>::max());
+  bool saveToDatabase(Database &db); // Writes dirty chunks
+
+private:
+  std::map<time_t, ArchiveChunk> chunks;
+};
+
+#endif // CARE_ARCHIVE_H
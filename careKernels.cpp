@@ -0,0 +1,228 @@
+// careKernels.cpp
+// Implements the care column kernels. The AVX2 variants are compiled with a
+// per-function target attribute so the rest of the program needs no special
+// flags; the variant is chosen once at first use via cpuid.
+
+#include "careKernels.h"
+#include <algorithm> // std::min, std::max
+#include <cmath>     // std::floor
+
+#if defined(__x86_64__)
+#include <immintrin.h> // AVX2 intrinsics
+#define CARE_KERNELS_X86 1
+#endif
+
+// merge
+//  - Combines two summaries (used when stats span several histories)
+void AmountStats::merge(const AmountStats &o) {
+  if (o.count == 0)
+    return;
+  if (count == 0) {
+    *this = o;
+    return;
+  }
+  count += o.count;
+  sum += o.sum;
+  min = std::min(min, o.min);
+  max = std::max(max, o.max);
+}
+
+namespace {
+
+// ===== Scalar reference implementations =====
+AmountStats statsScalar(const time_t *times, const double *amounts,
+                        std::size_t n, time_t from, time_t to) {
+  AmountStats s;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (times[i] < from || times[i] >= to)
+      continue;
+    double a = amounts[i];
+    if (s.count == 0) {
+      s.min = s.max = a;
+    } else {
+      s.min = std::min(s.min, a);
+      s.max = std::max(s.max, a);
+    }
+    s.sum += a;
+    ++s.count;
+  }
+  return s;
+}
+
+// Multiplies by 1/width (rather than dividing) to match the AVX2 path exactly
+inline std::size_t bucketOf(double a, double lo, double invWidth,
+                            std::size_t buckets) {
+  double b = std::floor((a - lo) * invWidth);
+  if (!(b > 0))
+    return 0;
+  if (b >= static_cast<double>(buckets))
+    return buckets - 1;
+  return static_cast<std::size_t>(b);
+}
+
+void histogramScalar(const time_t *times, const double *amounts, std::size_t n,
+                     time_t from, time_t to, double lo, double width,
+                     long *counts, std::size_t buckets) {
+  const double invWidth = 1.0 / width;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (times[i] >= from && times[i] < to)
+      ++counts[bucketOf(amounts[i], lo, invWidth, buckets)];
+  }
+}
+
+std::size_t countScalar(const time_t *times, std::size_t n, time_t from,
+                        time_t to) {
+  std::size_t c = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    c += (times[i] >= from && times[i] < to);
+  return c;
+}
+
+#ifdef CARE_KERNELS_X86
+static_assert(sizeof(time_t) == 8, "AVX2 kernels assume 64-bit time_t");
+
+// In-range mask for four timestamps: !(from > t) && (to > t)
+__attribute__((target("avx2"))) inline __m256i
+rangeMask(const time_t *p, __m256i vfrom, __m256i vto) {
+  __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  return _mm256_andnot_si256(_mm256_cmpgt_epi64(vfrom, t),
+                             _mm256_cmpgt_epi64(vto, t));
+}
+
+// ===== AVX2 implementations (4 rows per iteration) =====
+__attribute__((target("avx2"))) AmountStats
+statsAvx2(const time_t *times, const double *amounts, std::size_t n,
+          time_t from, time_t to) {
+  const __m256i vfrom = _mm256_set1_epi64x(from);
+  const __m256i vto = _mm256_set1_epi64x(to);
+  __m256d vsum = _mm256_setzero_pd();
+  __m256d vmin = _mm256_set1_pd(__builtin_inf());
+  __m256d vmax = _mm256_set1_pd(-__builtin_inf());
+  long count = 0;
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d mask = _mm256_castsi256_pd(rangeMask(times + i, vfrom, vto));
+    __m256d a = _mm256_loadu_pd(amounts + i);
+    vsum = _mm256_add_pd(vsum, _mm256_and_pd(a, mask));
+    vmin = _mm256_blendv_pd(vmin, _mm256_min_pd(vmin, a), mask);
+    vmax = _mm256_blendv_pd(vmax, _mm256_max_pd(vmax, a), mask);
+    count += __builtin_popcount(_mm256_movemask_pd(mask));
+  }
+
+  alignas(32) double lanes[3][4];
+  _mm256_store_pd(lanes[0], vsum);
+  _mm256_store_pd(lanes[1], vmin);
+  _mm256_store_pd(lanes[2], vmax);
+  AmountStats s;
+  s.count = count;
+  if (count > 0) {
+    s.sum = (lanes[0][0] + lanes[0][1]) + (lanes[0][2] + lanes[0][3]);
+    s.min = std::min(std::min(lanes[1][0], lanes[1][1]),
+                     std::min(lanes[1][2], lanes[1][3]));
+    s.max = std::max(std::max(lanes[2][0], lanes[2][1]),
+                     std::max(lanes[2][2], lanes[2][3]));
+  }
+  s.merge(statsScalar(times + i, amounts + i, n - i, from, to));
+  return s;
+}
+
+__attribute__((target("avx2"))) void
+histogramAvx2(const time_t *times, const double *amounts, std::size_t n,
+              time_t from, time_t to, double lo, double width, long *counts,
+              std::size_t buckets) {
+  const __m256i vfrom = _mm256_set1_epi64x(from);
+  const __m256i vto = _mm256_set1_epi64x(to);
+  const __m256d vlo = _mm256_set1_pd(lo);
+  const __m256d vinv = _mm256_set1_pd(1.0 / width);
+  const __m256d vzero = _mm256_setzero_pd();
+  const __m256d vlast = _mm256_set1_pd(static_cast<double>(buckets - 1));
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int mask = _mm256_movemask_pd(
+        _mm256_castsi256_pd(rangeMask(times + i, vfrom, vto)));
+    if (mask == 0)
+      continue;
+    // Bucket index = clamp(floor((a - lo) / width), 0, buckets - 1)
+    __m256d b = _mm256_floor_pd(
+        _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(amounts + i), vlo), vinv));
+    b = _mm256_min_pd(_mm256_max_pd(b, vzero), vlast);
+    alignas(16) int idx[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(idx), _mm256_cvttpd_epi32(b));
+    // AVX2 has no scatter; the increments themselves stay scalar
+    for (int lane = 0; lane < 4; ++lane) {
+      if (mask & (1 << lane))
+        ++counts[idx[lane]];
+    }
+  }
+  histogramScalar(times + i, amounts + i, n - i, from, to, lo, width, counts,
+                  buckets);
+}
+
+__attribute__((target("avx2"))) std::size_t
+countAvx2(const time_t *times, std::size_t n, time_t from, time_t to) {
+  const __m256i vfrom = _mm256_set1_epi64x(from);
+  const __m256i vto = _mm256_set1_epi64x(to);
+  std::size_t c = 0;
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    c += __builtin_popcount(_mm256_movemask_pd(
+        _mm256_castsi256_pd(rangeMask(times + i, vfrom, vto))));
+  }
+  return c + countScalar(times + i, n - i, from, to);
+}
+
+bool detectAvx2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+#else
+bool detectAvx2() { return false; }
+#endif
+
+// Resolved once; static initialization is thread-safe
+bool haveAvx2() {
+  static const bool avx2 = detectAvx2();
+  return avx2;
+}
+
+} // namespace
+
+namespace careKernels {
+
+bool usingAvx2() { return haveAvx2(); }
+
+AmountStats maskedStats(const time_t *times, const double *amounts,
+                        std::size_t n, time_t from, time_t to) {
+#ifdef CARE_KERNELS_X86
+  if (haveAvx2())
+    return statsAvx2(times, amounts, n, from, to);
+#endif
+  return statsScalar(times, amounts, n, from, to);
+}
+
+void maskedHistogram(const time_t *times, const double *amounts,
+                     std::size_t n, time_t from, time_t to, double lo,
+                     double width, long *counts, std::size_t buckets) {
+  if (buckets == 0 || !(width > 0))
+    return;
+#ifdef CARE_KERNELS_X86
+  if (haveAvx2()) {
+    histogramAvx2(times, amounts, n, from, to, lo, width, counts, buckets);
+    return;
+  }
+#endif
+  histogramScalar(times, amounts, n, from, to, lo, width, counts, buckets);
+}
+
+std::size_t countInRange(const time_t *times, std::size_t n, time_t from,
+                         time_t to) {
+#ifdef CARE_KERNELS_X86
+  if (haveAvx2())
+    return countAvx2(times, n, from, to);
+#endif
+  return countScalar(times, n, from, to);
+}
+
+} // namespace careKernels
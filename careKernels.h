@@ -0,0 +1,44 @@
+// careKernels.h
+// Declaration of vectorized kernels over care record columns (feeding
+// amounts and timestamps). Each call picks an AVX2 implementation when the
+// CPU supports it and a scalar loop otherwise.
+
+#ifndef CARE_KERNELS_H
+#define CARE_KERNELS_H
+
+#include <cstddef> // std::size_t
+#include <ctime>   // time_t
+
+// Summary of the amounts whose timestamp falls in [from, to)
+struct AmountStats {
+  long count = 0;   // Matching rows
+  double sum = 0.0; // Total amount
+  double min = 0.0; // Smallest amount (0 if count == 0)
+  double max = 0.0; // Largest amount (0 if count == 0)
+
+  double mean() const { return count ? sum / count : 0.0; }
+  void merge(const AmountStats &o);
+};
+
+namespace careKernels {
+
+// True if the AVX2 kernels are in use on this machine
+bool usingAvx2();
+
+// Sum/min/max/count of amounts[i] where from <= times[i] < to
+AmountStats maskedStats(const time_t *times, const double *amounts,
+                        std::size_t n, time_t from, time_t to);
+
+// Adds to counts[b] for each amount in range, where
+// b = floor((amount - lo) / width), clamped to [0, buckets - 1]
+void maskedHistogram(const time_t *times, const double *amounts,
+                     std::size_t n, time_t from, time_t to, double lo,
+                     double width, long *counts, std::size_t buckets);
+
+// Number of timestamps with from <= times[i] < to
+std::size_t countInRange(const time_t *times, std::size_t n, time_t from,
+                         time_t to);
+
+} // namespace careKernels
+
+#endif // CARE_KERNELS_H
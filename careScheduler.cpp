@@ -0,0 +1,358 @@
+// careScheduler.cpp
+// Implements TimingWheel and CareScheduler.
+//  - A timer lives in level L, slot (expiry >> 6L) & 63, where L is the
+//    smallest level whose span covers its distance from the current tick
+//  - Whenever the current tick crosses a level-L slot boundary, that slot's
+//    timers are re-linked closer in (a cascade); level-0 slots fire
+//  - advance() jumps straight between ticks that have work, using a 64-bit
+//    occupancy mask per level, so idle stretches cost almost nothing
+
+#include "careScheduler.h"
+#include "animalCare.h" // CareType values
+#include <algorithm>    // std::max, std::fill, std::reverse
+#include <cstdio>       // std::sscanf for stored timestamps
+#include <iostream>     // std::cerr
+#include <string>       // std::string, std::to_string
+
+// ===== TimingWheel =====
+TimingWheel::TimingWheel(std::int64_t startTick) : now(startTick) {
+  for (auto &level : heads) {
+    std::fill(level, level + SLOTS, NIL);
+  }
+  std::fill(occupied, occupied + LEVELS, 0);
+}
+
+// link
+//  - Chooses the level by distance from 'now'; anything past the top
+//    level's span parks in the top slot visited last and is re-linked
+//    when that slot cascades
+void TimingWheel::link(std::int32_t n) {
+  Node &node = nodes[n];
+  std::int64_t delta = node.expiry - now;
+  int level = 0;
+  while (level < LEVELS &&
+         delta >= (std::int64_t{1} << (SLOT_BITS * (level + 1)))) {
+    ++level;
+  }
+  int slot;
+  if (level == LEVELS) {
+    level = LEVELS - 1;
+    slot = static_cast<int>(((now >> (SLOT_BITS * level)) - 1) & (SLOTS - 1));
+  } else if (delta <= 0) {
+    slot = static_cast<int>(now & (SLOTS - 1));
+  } else {
+    slot = static_cast<int>((node.expiry >> (SLOT_BITS * level)) &
+                            (SLOTS - 1));
+  }
+
+  node.level = static_cast<std::int16_t>(level);
+  node.slot = static_cast<std::int16_t>(slot);
+  node.prev = NIL;
+  node.next = heads[level][slot];
+  if (node.next != NIL) {
+    nodes[node.next].prev = n;
+  }
+  heads[level][slot] = n;
+  occupied[level] |= std::uint64_t{1} << slot;
+}
+
+void TimingWheel::unlink(std::int32_t n) {
+  Node &node = nodes[n];
+  if (node.prev != NIL) {
+    nodes[node.prev].next = node.next;
+  } else {
+    heads[node.level][node.slot] = node.next;
+    if (node.next == NIL) {
+      occupied[node.level] &= ~(std::uint64_t{1} << node.slot);
+    }
+  }
+  if (node.next != NIL) {
+    nodes[node.next].prev = node.prev;
+  }
+}
+
+void TimingWheel::release(std::int32_t n) {
+  nodes[n].level = -1;
+  ++nodes[n].generation;
+  freeNodes.push_back(n);
+  --pending;
+}
+
+// schedule
+//  - Handle = generation in the high 32 bits, node index + 1 in the low 32
+TimingWheel::Handle TimingWheel::schedule(std::int64_t expiryTick,
+                                          std::uint64_t payload) {
+  std::int32_t n;
+  if (!freeNodes.empty()) {
+    n = freeNodes.back();
+    freeNodes.pop_back();
+  } else {
+    n = static_cast<std::int32_t>(nodes.size());
+    nodes.push_back(Node{0, 0, NIL, NIL, 0, -1, 0});
+  }
+  // The current tick's slot has already been processed
+  nodes[n].expiry = std::max(expiryTick, now + 1);
+  nodes[n].payload = payload;
+  link(n);
+  ++pending;
+  return (std::uint64_t{nodes[n].generation} << 32) |
+         static_cast<std::uint32_t>(n + 1);
+}
+
+bool TimingWheel::cancel(Handle handle) {
+  std::uint32_t low = static_cast<std::uint32_t>(handle);
+  if (low == 0 || low > nodes.size()) {
+    return false;
+  }
+  std::int32_t n = static_cast<std::int32_t>(low - 1);
+  if (nodes[n].level < 0 || nodes[n].generation != (handle >> 32)) {
+    return false;
+  }
+  unlink(n);
+  release(n);
+  return true;
+}
+
+// cascade
+//  - Re-links every timer in the slot; they all land on lower levels
+void TimingWheel::cascade(int level, int slot) {
+  std::int32_t n = heads[level][slot];
+  heads[level][slot] = NIL;
+  occupied[level] &= ~(std::uint64_t{1} << slot);
+  while (n != NIL) {
+    std::int32_t next = nodes[n].next;
+    link(n);
+    n = next;
+  }
+}
+
+// fire
+//  - Collects the slot's timers in insertion order (slot lists are LIFO)
+void TimingWheel::fire(int slot, std::vector<std::uint64_t> &expired) {
+  std::int32_t n = heads[0][slot];
+  heads[0][slot] = NIL;
+  occupied[0] &= ~(std::uint64_t{1} << slot);
+  size_t first = expired.size();
+  while (n != NIL) {
+    std::int32_t next = nodes[n].next;
+    expired.push_back(nodes[n].payload);
+    release(n);
+    n = next;
+  }
+  std::reverse(expired.begin() + first, expired.end());
+}
+
+std::size_t TimingWheel::advance(std::int64_t tick,
+                                 std::vector<std::uint64_t> &expired) {
+  const std::size_t before = expired.size();
+  while (now < tick) {
+    if (pending == 0) {
+      now = tick;
+      break;
+    }
+    // Next tick with work: an occupied level-0 slot later in this lap, or
+    // the start of the next lap (where higher levels may cascade)
+    const int pos = static_cast<int>(now & (SLOTS - 1));
+    std::int64_t next = (now | (SLOTS - 1)) + 1;
+    std::uint64_t ahead =
+        pos == SLOTS - 1 ? 0 : occupied[0] & (~std::uint64_t{0} << (pos + 1));
+    if (ahead) {
+      next = (now & ~std::int64_t{SLOTS - 1}) + __builtin_ctzll(ahead);
+    }
+    if (next > tick) {
+      now = tick;
+      break;
+    }
+    now = next;
+
+    // Outermost first, so timers cascaded from level L+1 into level L's
+    // current slot are cascaded again on the same tick
+    for (int level = LEVELS - 1; level > 0; --level) {
+      std::int64_t mask = (std::int64_t{1} << (SLOT_BITS * level)) - 1;
+      if ((now & mask) == 0) {
+        cascade(level,
+                static_cast<int>((now >> (SLOT_BITS * level)) & (SLOTS - 1)));
+      }
+    }
+    fire(static_cast<int>(now & (SLOTS - 1)), expired);
+  }
+  return expired.size() - before;
+}
+
+// ===== CareScheduler =====
+// Rounds down/up to whole ticks (care times are never negative)
+static std::int64_t tickFloor(time_t t) {
+  return t / CareScheduler::TICK_SECONDS;
+}
+static std::int64_t tickCeil(time_t t) {
+  return (t + CareScheduler::TICK_SECONDS - 1) / CareScheduler::TICK_SECONDS;
+}
+
+CareScheduler::CareScheduler(time_t now) : wheel(tickFloor(now)) {}
+
+std::uint64_t CareScheduler::keyOf(int animalId, CareType kind) {
+  return (std::uint64_t{static_cast<std::uint32_t>(animalId)} << 1) |
+         (kind == CareType::Health ? 1u : 0u);
+}
+
+void CareScheduler::disarm(std::uint64_t key, const Plan &plan) {
+  if (plan.timer != 0) {
+    wheel.cancel(plan.timer);
+  } else {
+    due.erase({plan.nextDue, key});
+  }
+}
+
+void CareScheduler::arm(std::uint64_t key, Plan &plan) {
+  std::int64_t expiry = tickCeil(plan.nextDue);
+  if (expiry <= wheel.currentTick()) {
+    plan.timer = 0;
+    due.insert({plan.nextDue, key});
+  } else {
+    plan.timer = wheel.schedule(expiry, key);
+  }
+}
+
+void CareScheduler::setPlan(int animalId, CareType kind, time_t interval,
+                            time_t lastDone) {
+  std::uint64_t key = keyOf(animalId, kind);
+  auto [it, inserted] = plans.try_emplace(key);
+  if (!inserted) {
+    disarm(key, it->second);
+  }
+  it->second.interval = interval;
+  it->second.nextDue = lastDone + interval;
+  arm(key, it->second);
+}
+
+bool CareScheduler::removePlan(int animalId, CareType kind) {
+  std::uint64_t key = keyOf(animalId, kind);
+  auto it = plans.find(key);
+  if (it == plans.end()) {
+    return false;
+  }
+  disarm(key, it->second);
+  plans.erase(it);
+  return true;
+}
+
+void CareScheduler::removeAnimal(int animalId) {
+  removePlan(animalId, CareType::Feeding);
+  removePlan(animalId, CareType::Health);
+}
+
+// onCareRecorded
+//  - O(1): cancel the pending timer (or clear the due entry) and re-arm
+void CareScheduler::onCareRecorded(int animalId, CareType kind, time_t when) {
+  std::uint64_t key = keyOf(animalId, kind);
+  auto it = plans.find(key);
+  if (it == plans.end()) {
+    return;
+  }
+  disarm(key, it->second);
+  it->second.nextDue = when + it->second.interval;
+  arm(key, it->second);
+}
+
+void CareScheduler::advance(time_t now) {
+  expired.clear();
+  wheel.advance(tickFloor(now), expired);
+  for (std::uint64_t key : expired) {
+    Plan &plan = plans.at(key);
+    plan.timer = 0;
+    due.insert({plan.nextDue, key});
+  }
+}
+
+std::vector<DueCare> CareScheduler::dueCare(time_t now) {
+  advance(now);
+  std::vector<DueCare> out;
+  out.reserve(due.size());
+  for (const auto &[dueAt, key] : due) {
+    out.push_back({static_cast<int>(static_cast<std::uint32_t>(key >> 1)),
+                   (key & 1) ? CareType::Health : CareType::Feeding, dueAt});
+  }
+  return out;
+}
+
+time_t CareScheduler::planInterval(int animalId, CareType kind) const {
+  auto it = plans.find(keyOf(animalId, kind));
+  return it == plans.end() ? 0 : it->second.interval;
+}
+
+// ===== Persistence Layer =====
+static const char *typeName(CareType kind) {
+  return kind == CareType::Health ? "health" : "feeding";
+}
+
+// loadFromDatabase
+//  - The latest matching record per plan comes from the (animal_id,
+//    timestamp) index; plans with no record yet are due immediately
+void CareScheduler::loadFromDatabase(Database &db, time_t now) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "SELECT p.animal_id, p.type, p.interval_seconds, "
+      "(SELECT MAX(c.timestamp) FROM CareRecords c "
+      " WHERE c.animal_id = p.animal_id AND c.type = p.type) "
+      "FROM CarePlans p;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return;
+  }
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int animalId = sqlite3_column_int(stmt, 0);
+    std::string type =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+    time_t interval = sqlite3_column_int64(stmt, 2);
+    CareType kind = type == "health" ? CareType::Health : CareType::Feeding;
+
+    time_t lastDone = now - interval;
+    const unsigned char *last = sqlite3_column_text(stmt, 3);
+    std::tm tm{};
+    if (last && std::sscanf(reinterpret_cast<const char *>(last),
+                            "%d-%d-%d %d:%d:%d", &tm.tm_year, &tm.tm_mon,
+                            &tm.tm_mday, &tm.tm_hour, &tm.tm_min,
+                            &tm.tm_sec) == 6) {
+      tm.tm_year -= 1900;
+      tm.tm_mon -= 1;
+      lastDone = timegm(&tm); // Stored by datetime('now'), i.e. UTC
+    }
+    setPlan(animalId, kind, interval, lastDone);
+  }
+  sqlite3_finalize(stmt);
+}
+
+bool CareScheduler::savePlanToDatabase(int animalId, CareType kind,
+                                       time_t interval, Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql = "INSERT OR REPLACE INTO CarePlans "
+                    "(animal_id, type, interval_seconds) VALUES (?, ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+  sqlite3_bind_int(stmt, 1, animalId);
+  sqlite3_bind_text(stmt, 2, typeName(kind), -1, SQLITE_STATIC);
+  sqlite3_bind_int64(stmt, 3, interval);
+  bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+  if (!ok) {
+    std::cerr << "[Error] Failed to save care plan: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+  }
+  sqlite3_finalize(stmt);
+  return ok;
+}
+
+bool CareScheduler::removePlanFromDatabase(int animalId, CareType kind,
+                                           Database &db) {
+  return db.execute("DELETE FROM CarePlans WHERE animal_id = " +
+                    std::to_string(animalId) + " AND type = '" +
+                    typeName(kind) + "';");
+}
+
+bool CareScheduler::removePlansFromDatabase(int animalId, Database &db) {
+  return db.execute("DELETE FROM CarePlans WHERE animal_id = " +
+                    std::to_string(animalId) + ";");
+}
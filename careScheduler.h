@@ -0,0 +1,147 @@
+// careScheduler.h
+// Declaration of TimingWheel, a hierarchical timer wheel, and CareScheduler,
+// which uses it to track when each animal is next due for feeding or a
+// health check under its recurring care plan.
+
+#ifndef CARE_SCHEDULER_H
+#define CARE_SCHEDULER_H
+
+#include "database.h"    // Plan persistence
+#include <cstddef>       // std::size_t
+#include <cstdint>       // Fixed-width tick/handle types
+#include <ctime>         // time_t
+#include <set>           // Due care ordered by due time
+#include <unordered_map> // (animal, kind) -> plan
+#include <utility>       // std::pair
+#include <vector>        // Node pool, expired payloads
+
+enum class CareType : int; // Defined in animalCare.h
+
+// Four levels of 64 slots; level L holds timers due 64^L to 64^(L+1) ticks
+// out. Insert and cancel are O(1) (intrusive lists in a node pool), and each
+// tick costs O(1) plus the timers it fires or cascades one level down.
+class TimingWheel {
+public:
+  using Handle = std::uint64_t; // 0 is never a valid handle
+  static constexpr int LEVELS = 4;
+  static constexpr int SLOT_BITS = 6;
+  static constexpr int SLOTS = 1 << SLOT_BITS;
+
+  explicit TimingWheel(std::int64_t startTick = 0);
+
+  // Arms a timer carrying 'payload'; an expiry at or before the current tick
+  // fires on the next tick
+  Handle schedule(std::int64_t expiryTick, std::uint64_t payload);
+
+  // Disarms a pending timer
+  //  - Returns false if it already fired or was cancelled
+  bool cancel(Handle handle);
+
+  // Moves time forward to 'tick', appending the payload of every timer that
+  // expires on the way to 'expired' (in expiry order)
+  //  - Returns the number of timers fired
+  std::size_t advance(std::int64_t tick, std::vector<std::uint64_t> &expired);
+
+  std::int64_t currentTick() const { return now; }
+  std::size_t size() const { return pending; }
+
+private:
+  static constexpr std::int32_t NIL = -1;
+
+  struct Node {
+    std::int64_t expiry;
+    std::uint64_t payload;
+    std::int32_t prev;
+    std::int32_t next;
+    std::uint32_t generation; // Bumped on release so stale handles miss
+    std::int16_t level;       // -1 while on the free list
+    std::int16_t slot;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<std::int32_t> freeNodes;
+  std::int32_t heads[LEVELS][SLOTS];
+  std::uint64_t occupied[LEVELS]; // Bit s set if slot s is non-empty
+  std::int64_t now;
+  std::size_t pending = 0;
+
+  void link(std::int32_t n);
+  void unlink(std::int32_t n);
+  void release(std::int32_t n);
+  void cascade(int level, int slot);
+  void fire(int slot, std::vector<std::uint64_t> &expired);
+};
+
+// A recurring care plan that has come due and not yet been carried out
+struct DueCare {
+  int animalId;
+  CareType kind; // Feeding or Health
+  time_t dueAt;
+};
+
+// Per-animal recurring care plans. Each plan keeps one pending timer; when
+// it fires the plan moves to the due list, and recording that kind of care
+// (AnimalCareManager calls onCareRecorded) clears it and re-arms the timer.
+// Resolution is one minute.
+class CareScheduler {
+public:
+  static constexpr time_t TICK_SECONDS = 60;
+
+  explicit CareScheduler(time_t now = std::time(nullptr));
+
+  // Creates or replaces the plan for (animal, kind): next due 'interval'
+  // seconds after 'lastDone'
+  void setPlan(int animalId, CareType kind, time_t interval, time_t lastDone);
+
+  // Removes the plan for (animal, kind)
+  //  - Returns false if there was none
+  bool removePlan(int animalId, CareType kind);
+
+  // Removes every plan for the animal (e.g. when it leaves the zoo)
+  void removeAnimal(int animalId);
+
+  // Care was given at 'when': re-arms the plan for (animal, kind), if any
+  void onCareRecorded(int animalId, CareType kind, time_t when);
+
+  // Fires every timer up to 'now' and returns all outstanding due care,
+  // most overdue first
+  std::vector<DueCare> dueCare(time_t now);
+
+  // Interval of the plan for (animal, kind), or 0 if there is none
+  time_t planInterval(int animalId, CareType kind) const;
+
+  std::size_t planCount() const { return plans.size(); }
+
+  // Database operations (CarePlans table); loading resumes each plan from
+  // the animal's most recent matching CareRecords row
+  void loadFromDatabase(Database &db, time_t now = std::time(nullptr));
+  static bool savePlanToDatabase(int animalId, CareType kind, time_t interval,
+                                 Database &db);
+  static bool removePlanFromDatabase(int animalId, CareType kind,
+                                     Database &db);
+  static bool removePlansFromDatabase(int animalId, Database &db);
+
+private:
+  struct Plan {
+    time_t interval;
+    time_t nextDue;
+    TimingWheel::Handle timer; // 0 while due
+  };
+
+  std::unordered_map<std::uint64_t, Plan> plans;
+  std::set<std::pair<time_t, std::uint64_t>> due; // (due time, plan key)
+  TimingWheel wheel;
+  std::vector<std::uint64_t> expired; // Reused by advance()
+
+  static std::uint64_t keyOf(int animalId, CareType kind);
+
+  // Disarms the plan's timer or removes it from the due list
+  void disarm(std::uint64_t key, const Plan &plan);
+
+  // Arms the timer for plan.nextDue, or marks it due if that has passed
+  void arm(std::uint64_t key, Plan &plan);
+
+  void advance(time_t now);
+};
+
+#endif // CARE_SCHEDULER_H
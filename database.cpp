@@ -38,3 +38,11 @@ bool Database::execute(const std::string &sql) {
   }
   return true;
 }
+
+// Transaction helpers
+// - Wrap BEGIN/COMMIT/ROLLBACK so bulk writes share one journal sync
+bool Database::beginTransaction() { return execute("BEGIN TRANSACTION;"); }
+
+bool Database::commit() { return execute("COMMIT;"); }
+
+bool Database::rollback() { return execute("ROLLBACK;"); }
@@ -27,6 +27,12 @@ public:
   // execute: runs a non-query SQL statement (CREATE, INSERT, UPDATE, DELETE)
   // - Returns true on success, false on failure (and logs error)
   bool execute(const std::string &sql);
+
+  // Transaction helpers: group many statements into a single commit
+  // - Each returns true on success, false on failure (and logs error)
+  bool beginTransaction();
+  bool commit();
+  bool rollback();
 };
 
 #endif // DATABASE_H
@@ -0,0 +1,137 @@
+// ecs.cpp
+// Implements World: entity allocation with generations and swap-remove
+// packing of the component tables.
+
+#include "ecs.h"
+
+Entity World::allocate(Kind kind, std::int32_t row) {
+  std::uint32_t index;
+  if (!freeIndices.empty()) {
+    index = freeIndices.back();
+    freeIndices.pop_back();
+  } else {
+    index = static_cast<std::uint32_t>(slots.size());
+    slots.emplace_back();
+  }
+  slots[index].kind = kind;
+  slots[index].row = row;
+  return Entity{index, slots[index].generation};
+}
+
+void World::release(Entity e) {
+  Slot &slot = slots[e.index];
+  slot.kind = Kind::Free;
+  slot.row = -1;
+  ++slot.generation;
+  freeIndices.push_back(e.index);
+}
+
+int World::rowOf(Entity e) const {
+  if (e.index >= slots.size() || slots[e.index].generation != e.generation ||
+      slots[e.index].kind == Kind::Free) {
+    return -1;
+  }
+  return slots[e.index].row;
+}
+
+Entity World::createAnimal(int animalId, float ageDays, int exhibitRow) {
+  const auto row = static_cast<std::int32_t>(animals.size());
+  Entity e = allocate(Kind::Animal, row);
+  animals.entities.push_back(e);
+  animals.animalId.push_back(animalId);
+  animals.hunger.push_back(0.0f);
+  animals.health.push_back(1.0f);
+  animals.happiness.push_back(0.75f);
+  animals.ageDays.push_back(ageDays);
+  animals.exhibit.push_back(-1);
+  byAnimalId[animalId] = e;
+  setExhibit(row, exhibitRow);
+  return e;
+}
+
+Entity World::createExhibit(const std::string &name, int capacity,
+                            float appeal) {
+  const auto row = static_cast<std::int32_t>(exhibits.size());
+  Entity e = allocate(Kind::Exhibit, row);
+  exhibits.entities.push_back(e);
+  exhibits.name.push_back(name);
+  exhibits.capacity.push_back(capacity);
+  exhibits.occupancy.push_back(0);
+  exhibits.cleanliness.push_back(1.0f);
+  exhibits.appeal.push_back(appeal);
+  byExhibitName[name] = e;
+  return e;
+}
+
+void World::setExhibit(int animalRow, int exhibitRow) {
+  int &current = animals.exhibit[animalRow];
+  if (current >= 0) {
+    --exhibits.occupancy[current];
+  }
+  current = exhibitRow;
+  if (exhibitRow >= 0) {
+    ++exhibits.occupancy[exhibitRow];
+  }
+}
+
+// Moves the last element of 'v' into position 'row' and shrinks it
+template <typename T> static void swapRemove(std::vector<T> &v, int row) {
+  v[row] = std::move(v.back());
+  v.pop_back();
+}
+
+// destroy
+//  - Swap-remove keeps every table dense; the entity that moved into the
+//    vacated row has its slot (and, for exhibits, residents) re-pointed
+bool World::destroy(Entity e) {
+  const int row = rowOf(e);
+  if (row < 0) {
+    return false;
+  }
+  if (slots[e.index].kind == Kind::Animal) {
+    setExhibit(row, -1);
+    byAnimalId.erase(animals.animalId[row]);
+    const int last = static_cast<int>(animals.size()) - 1;
+    if (row != last) {
+      slots[animals.entities[last].index].row = row;
+    }
+    swapRemove(animals.entities, row);
+    swapRemove(animals.animalId, row);
+    swapRemove(animals.hunger, row);
+    swapRemove(animals.health, row);
+    swapRemove(animals.happiness, row);
+    swapRemove(animals.ageDays, row);
+    swapRemove(animals.exhibit, row);
+  } else {
+    const int last = static_cast<int>(exhibits.size()) - 1;
+    for (int &ex : animals.exhibit) {
+      if (ex == row) {
+        ex = -1;
+      } else if (ex == last) {
+        ex = row;
+      }
+    }
+    byExhibitName.erase(exhibits.name[row]);
+    if (row != last) {
+      slots[exhibits.entities[last].index].row = row;
+    }
+    swapRemove(exhibits.entities, row);
+    swapRemove(exhibits.name, row);
+    swapRemove(exhibits.capacity, row);
+    swapRemove(exhibits.occupancy, row);
+    swapRemove(exhibits.cleanliness, row);
+    swapRemove(exhibits.appeal, row);
+  }
+  release(e);
+  return true;
+}
+
+int World::animalRow(int animalId) const {
+  auto it = byAnimalId.find(animalId);
+  return it == byAnimalId.end() ? -1 : rowOf(it->second);
+}
+
+int World::exhibitRow(const std::string &name) const {
+  auto it = byExhibitName.find(name);
+  return it == byExhibitName.end() ? -1 : rowOf(it->second);
+}
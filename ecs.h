@@ -0,0 +1,96 @@
+// ecs.h
+// Declaration of the entity-component storage used by the simulation.
+// Entities are generation-checked handles; components live in packed,
+// structure-of-arrays tables (one per archetype) so systems stream over
+// dense arrays. Removing an entity swaps the last row into its place.
+
+#ifndef ECS_H
+#define ECS_H
+
+#include <cstddef>       // std::size_t
+#include <cstdint>       // Entity index/generation
+#include <string>        // Exhibit names
+#include <unordered_map> // Animal ID / exhibit name -> entity
+#include <vector>        // Component arrays
+
+// Handle to an entity; stale handles (entity destroyed) never resolve
+struct Entity {
+  std::uint32_t index = 0;
+  std::uint32_t generation = 0;
+
+  bool operator==(const Entity &o) const {
+    return index == o.index && generation == o.generation;
+  }
+};
+
+// Components of every simulated animal; row i of each array belongs to
+// entities[i]
+struct AnimalTable {
+  std::vector<Entity> entities;
+  std::vector<int> animalId;    // Link to the Animal record
+  std::vector<float> hunger;    // 0 = full, 1 = starving
+  std::vector<float> health;    // 0 = critical, 1 = perfect
+  std::vector<float> happiness; // 0 = miserable, 1 = thriving
+  std::vector<float> ageDays;   // Age in (simulated) days
+  std::vector<int> exhibit;     // Row in ExhibitTable, or -1
+
+  std::size_t size() const { return entities.size(); }
+};
+
+// Components of every simulated exhibit
+struct ExhibitTable {
+  std::vector<Entity> entities;
+  std::vector<std::string> name;
+  std::vector<int> capacity;
+  std::vector<int> occupancy;     // Simulated residents
+  std::vector<float> cleanliness; // 0 = filthy, 1 = spotless
+  std::vector<float> appeal;      // Draw of the exhibit type for visitors
+
+  std::size_t size() const { return entities.size(); }
+};
+
+class World {
+public:
+  AnimalTable animals;
+  ExhibitTable exhibits;
+
+  // Adds an animal entity (exhibitRow may be -1)
+  Entity createAnimal(int animalId, float ageDays, int exhibitRow);
+
+  // Adds an exhibit entity
+  Entity createExhibit(const std::string &name, int capacity,
+                       float appeal = 1.0f);
+
+  // Removes the animal/exhibit the handle refers to
+  //  - Returns false if the handle is stale
+  //  - Destroying an exhibit unlinks its residents (exhibit = -1)
+  bool destroy(Entity e);
+
+  // Row of a live entity in its table, or -1 if the handle is stale
+  int rowOf(Entity e) const;
+
+  // Lookups by the IDs the managers use; -1 if absent
+  int animalRow(int animalId) const;
+  int exhibitRow(const std::string &name) const;
+
+  // Moves an animal to another exhibit row (or -1), keeping occupancy
+  void setExhibit(int animalRow, int exhibitRow);
+
+private:
+  enum class Kind : std::uint8_t { Free, Animal, Exhibit };
+  struct Slot {
+    std::uint32_t generation = 0;
+    Kind kind = Kind::Free;
+    std::int32_t row = -1;
+  };
+
+  std::vector<Slot> slots;                 // Entity index -> table row
+  std::vector<std::uint32_t> freeIndices;  // Recycled entity indices
+  std::unordered_map<int, Entity> byAnimalId;
+  std::unordered_map<std::string, Entity> byExhibitName;
+
+  Entity allocate(Kind kind, std::int32_t row);
+  void release(Entity e);
+};
+
+#endif // ECS_H
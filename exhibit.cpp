@@ -2,53 +2,58 @@
 #include "exhibit.h"
 #include <iostream>
 
-Exhibit::Exhibit() : name(""), type(""), capacity(0), animals() {
+Exhibit::Exhibit()
+    : name(""), type(""), capacity(0), count(0), animals(), freeSlots() {
   std::cerr << "[WARNING] Default Exhibit constructor called — animals array "
                "not allocated!\n";
 }
 
 Exhibit::Exhibit(const string &n, const string &t, int c)
-    : name(n), type(t), capacity(c), animals(c, "") {}
+    : name(n), type(t), capacity(c), count(0), animals(c, EMPTY_SLOT),
+      freeSlots() {
+  // Push slots in reverse so the lowest free slot is handed out first
+  freeSlots.reserve(c);
+  for (int slot = c - 1; slot >= 0; --slot) {
+    freeSlots.push_back(slot);
+  }
+}
 
 Exhibit::~Exhibit() {}
 
 string Exhibit::getExhibitName() const { return name; }
 string Exhibit::getExhibitType() const { return type; }
 int Exhibit::getExhibitCapacity() const { return capacity; }
-int Exhibit::getAnimalCount() const { return static_cast<int>(animals.size()); }
+int Exhibit::getAnimalCount() const { return count; }
 
-string Exhibit::getAnimal(int index) const {
-  if (index >= 0 && index < static_cast<int>(animals.size())) {
-    return animals[index];
+int Exhibit::getAnimal(int slot) const {
+  if (slot >= 0 && slot < static_cast<int>(animals.size())) {
+    return animals[slot];
   }
-  return "";
+  return EMPTY_SLOT;
 }
 
-bool Exhibit::setAnimal(const string &a) {
-  for (const auto &existing : animals) {
-    if (existing == "") {
-      for (auto &slot : animals) {
-        if (slot == "") {
-          slot = a;
-          return true;
-        }
-      }
-    }
+int Exhibit::setAnimal(int animalId) {
+  if (freeSlots.empty()) {
+    std::cerr << "[Error] Exhibit '" << name << "' is full! Cannot add animal "
+              << animalId << ".\n";
+    return -1;
   }
-  std::cerr << "[Error] Exhibit '" << name << "' is full! Cannot add '" << a
-            << "'.\n";
-  return false;
+  int slot = freeSlots.back();
+  freeSlots.pop_back();
+  animals[slot] = animalId;
+  ++count;
+  return slot;
 }
 
 void Exhibit::viewAnimals() const {
   bool any = false;
   for (int i = 0; i < static_cast<int>(animals.size()); ++i) {
-    if (!animals[i].empty()) {
+    if (animals[i] != EMPTY_SLOT) {
       if (!any) {
         std::cout << "Animals in exhibit '" << name << "':" << std::endl;
         any = true;
       }
-      std::cout << "  " << i << ") " << animals[i] << std::endl;
+      std::cout << "  " << i << ") Animal ID " << animals[i] << std::endl;
     }
   }
   if (!any) {
@@ -56,14 +61,15 @@ void Exhibit::viewAnimals() const {
   }
 }
 
-bool Exhibit::removeAnimal(const string &animalName) {
-  for (auto &slot : animals) {
-    if (slot == animalName) {
-      slot = "";
-      return true;
-    }
+bool Exhibit::removeAnimalAt(int slot) {
+  if (slot < 0 || slot >= static_cast<int>(animals.size()) ||
+      animals[slot] == EMPTY_SLOT) {
+    std::cout << "[Warning] Slot " << slot << " is empty in exhibit '" << name
+              << "'." << std::endl;
+    return false;
   }
-  std::cout << "[Warning] Animal '" << animalName << "' not found in exhibit '"
-            << name << "'." << std::endl;
-  return false;
+  animals[slot] = EMPTY_SLOT;
+  freeSlots.push_back(slot);
+  --count;
+  return true;
 }
@@ -1,6 +1,6 @@
 // exhibit.h
 // Declaration of the Exhibit class: manages a fixed-size collection of animal
-// names.
+// IDs.
 
 #ifndef EXHIBIT_H
 #define EXHIBIT_H
@@ -16,34 +16,39 @@ private:
   string type; // Exhibit type or habitat (e.g., "Grassland")
 
   // Storage
-  int capacity;                // Maximum number of animals allowed
-  std::vector<string> animals; // Dynamic array of animal names
+  int capacity;               // Maximum number of animals allowed
+  int count;                  // Number of occupied slots
+  std::vector<int> animals;   // Slots of animal IDs (EMPTY_SLOT when unused)
+  std::vector<int> freeSlots; // Stack of unused slot indices
 
 public:
+  // Marker stored in a slot that holds no animal
+  static constexpr int EMPTY_SLOT = -1;
+
   // Default constructor: initializes an empty exhibit
   Exhibit();
-  // Constructor: allocates 'capacity' slots and initializes count to 0
+  // Constructor: allocates 'capacity' empty slots
   Exhibit(const string &n, const string &t, int c);
 
   // Destructor: frees the dynamic array
   ~Exhibit();
 
   // ——— Accessors —————————————————————————————
-  string getExhibitName() const;     // Returns name
-  string getExhibitType() const;     // Returns type
-  int getExhibitCapacity() const;    // Returns capacity
-  int getAnimalCount() const;        // Returns current count
-  string getAnimal(int index) const; // Returns animal at index i
+  string getExhibitName() const;  // Returns name
+  string getExhibitType() const;  // Returns type
+  int getExhibitCapacity() const; // Returns capacity
+  int getAnimalCount() const;     // Returns number of occupied slots
+  int getAnimal(int slot) const;  // Returns animal ID in slot or EMPTY_SLOT
 
   // ——— Mutators —————————————————————————————
-  // Attempts to add an animal name; returns false if exhibit is full
-  bool setAnimal(const string &a);
+  // Places an animal ID in a free slot; returns the slot, or -1 if full
+  int setAnimal(int animalId);
 
-  // Removes the named animal if found; shifts remaining names; returns success
-  bool removeAnimal(const string &animalName);
+  // Clears the given slot; returns false if the slot was already empty
+  bool removeAnimalAt(int slot);
 
   // ——— Utility —————————————————————————————
-  // Prints a list of current animal names to the console
+  // Prints a list of current animal IDs to the console
   void viewAnimals() const;
 };
 
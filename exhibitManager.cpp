@@ -1,6 +1,6 @@
 // exhibitManager.cpp
-// Implements ExhibitManager: manages a global list of Exhibits, handles I/O
-// menus, and synchronizes with the database. Dependencies:
+// Implements ExhibitManager: owns the exhibit registry, handles I/O menus, and
+// synchronizes with the database. Dependencies:
 //  - exhibitManager.h: Class declaration and interface
 //  - database.h: For persistence methods (load/save)
 //  - sqlite3.h: For direct SQLite prepare/step/finalize
@@ -11,22 +11,42 @@
 #include <sstream>    // std::ostringstream for SQL statement building
 #include <stdexcept>  // std::out_of_range
 
-// Definition of the static member that holds all Exhibit objects
-std::vector<Exhibit> ExhibitManager::exhibits;
+// Constructor: publishes an empty snapshot so readers never see null
+ExhibitManager::ExhibitManager()
+    : current(std::make_shared<const Snapshot>()) {}
 
-// Constructor: currently no initialization needed
-ExhibitManager::ExhibitManager() {}
+// snapshot
+//  - Atomically loads the currently published registry view
+std::shared_ptr<const ExhibitManager::Snapshot>
+ExhibitManager::snapshot() const {
+  return current.load(std::memory_order_acquire);
+}
+
+// appendLocked
+//  - Stores the exhibit and records it in the snapshot being built
+void ExhibitManager::appendLocked(const Exhibit &ex, Snapshot &next) {
+  exhibits.push_back(ex);
+  int idx = static_cast<int>(next.byIndex.size());
+  next.byIndex.push_back(&exhibits.back());
+  next.byName.emplace(ex.getExhibitName(), idx);
+}
 
 // addExhibit
-//  - Adds a new Exhibit to the global list (both in-memory and later saved to
-//  DB)
-void ExhibitManager::addExhibit(const Exhibit &ex) { exhibits.push_back(ex); }
+//  - Adds a new Exhibit to the registry (both in-memory and later saved to
+//  DB) and publishes a snapshot that includes it
+void ExhibitManager::addExhibit(const Exhibit &ex) {
+  std::lock_guard<std::mutex> lock(writeMutex);
+  auto next = std::make_shared<Snapshot>(*snapshot());
+  appendLocked(ex, *next);
+  current.store(std::move(next), std::memory_order_release);
+}
 
 // viewExhibits
 //  - Prints all exhibits with index, name, type, and capacity
 void ExhibitManager::viewExhibits() const {
-  for (int idx = 0; idx < static_cast<int>(exhibits.size()); ++idx) {
-    const Exhibit &exhibit = exhibits[idx];
+  auto snap = snapshot();
+  for (int idx = 0; idx < static_cast<int>(snap->byIndex.size()); ++idx) {
+    const Exhibit &exhibit = *snap->byIndex[idx];
     std::cout << idx << ") Exhibit Name: " << exhibit.getExhibitName()
               << std::endl;
     std::cout << "   Type: " << exhibit.getExhibitType() << std::endl;
@@ -39,9 +59,11 @@ void ExhibitManager::viewExhibits() const {
 //  - Lists exhibits by index and prompts the user to choose one
 //  - Validates input and loops until a valid index is entered
 int ExhibitManager::selectExhibit() const {
-  int num = exhibits.size();
+  auto snap = snapshot();
+  int num = static_cast<int>(snap->byIndex.size());
   for (int i = 0; i < num; ++i) {
-    std::cout << "(" << i << ") " << exhibits[i].getExhibitName() << std::endl;
+    std::cout << "(" << i << ") " << snap->byIndex[i]->getExhibitName()
+              << std::endl;
   }
 
   int ans;
@@ -66,46 +88,47 @@ int ExhibitManager::selectExhibit() const {
 // viewSelectedExhibit
 //  - Displays all animals within the exhibit at index 'ex'
 void ExhibitManager::viewSelectedExhibit(int ex) const {
-  if (ex < 0 || ex >= static_cast<int>(exhibits.size())) {
+  auto snap = snapshot();
+  if (ex < 0 || ex >= static_cast<int>(snap->byIndex.size())) {
     std::cerr << "[Error] Invalid exhibit number. Please try again."
               << std::endl;
     return;
   }
-  exhibits[ex].viewAnimals();
+  snap->byIndex[ex]->viewAnimals();
 }
 
 // exhibitExists
-//  - Checks if an exhibit with the given name exists
-bool ExhibitManager::exhibitExists(const std::string &ex) {
-  for (const Exhibit &e : exhibits) {
-    if (e.getExhibitName() == ex)
-      return true;
-  }
-  return false;
+//  - Checks if an exhibit with the given name exists (hash lookup)
+bool ExhibitManager::exhibitExists(std::string_view ex) const {
+  auto snap = snapshot();
+  return snap->byName.find(ex) != snap->byName.end();
 }
 
 // getExhibitCount
 //  - Returns the number of exhibits in memory
 int ExhibitManager::getExhibitCount() const {
-  return static_cast<int>(exhibits.size());
+  return static_cast<int>(snapshot()->byIndex.size());
 }
 
 // viewAnimalsInExhibit
 //  - Lists animals in the exhibit at index 'idx'
 void ExhibitManager::viewAnimalsInExhibit(int idx) const {
-  if (idx < 0 || idx >= getExhibitCount()) {
+  auto snap = snapshot();
+  if (idx < 0 || idx >= static_cast<int>(snap->byIndex.size())) {
     std::cerr << "[Error] Invalid exhibit index" << std::endl;
     return;
   }
-  const Exhibit &e = exhibits[idx];
-  int n = e.getAnimalCount();
+  const Exhibit &e = *snap->byIndex[idx];
   std::cout << "\n--- Animals in '" << e.getExhibitName() << "' ---"
             << std::endl;
-  if (n == 0) {
+  if (e.getAnimalCount() == 0) {
     std::cout << "(none)" << std::endl;
   } else {
-    for (int i = 0; i < n; ++i) {
-      std::cout << "  " << i << ") " << e.getAnimal(i) << std::endl;
+    for (int slot = 0; slot < e.getExhibitCapacity(); ++slot) {
+      int animalId = e.getAnimal(slot);
+      if (animalId != Exhibit::EMPTY_SLOT) {
+        std::cout << "  " << slot << ") Animal ID " << animalId << std::endl;
+      }
     }
   }
   std::cout << "-------------------------------" << std::endl;
@@ -114,40 +137,47 @@ void ExhibitManager::viewAnimalsInExhibit(int idx) const {
 // getExhibitByIndex
 //  - Returns a reference to exhibit at 'index'; throws if out of range
 Exhibit &ExhibitManager::getExhibitByIndex(int index) {
-  return exhibits.at(index);
+  // Storage positions match snapshot positions: exhibits are only appended
+  if (index < 0 || index >= getExhibitCount()) {
+    throw std::out_of_range("Exhibit index out of range");
+  }
+  return exhibits[index];
 }
 
 const Exhibit &ExhibitManager::getExhibitByIndex(int index) const {
-  return exhibits.at(index);
+  return *snapshot()->byIndex.at(index);
 }
 
 // findExhibitIndex
 //  - Returns the index of an exhibit by name or -1 if not found
-int ExhibitManager::findExhibitIndex(const std::string &name) const {
-  for (int i = 0; i < getExhibitCount(); ++i) {
-    if (exhibits[i].getExhibitName() == name)
-      return i;
-  }
-  return -1;
+int ExhibitManager::findExhibitIndex(std::string_view name) const {
+  auto snap = snapshot();
+  auto it = snap->byName.find(name);
+  return it == snap->byName.end() ? -1 : it->second;
 }
 
 // getExhibitByName
 //  - Returns a reference to the exhibit with matching name; throws if not found
-Exhibit &ExhibitManager::getExhibitByName(const std::string &name) {
-  int idx = findExhibitIndex(name);
-  if (idx < 0) {
-    throw std::out_of_range("Exhibit not found: " + name);
+Exhibit &ExhibitManager::getExhibitByName(std::string_view name) {
+  auto snap = snapshot();
+  auto it = snap->byName.find(name);
+  if (it == snap->byName.end()) {
+    throw std::out_of_range("Exhibit not found: " + std::string(name));
   }
-  return exhibits[idx];
+  return exhibits[it->second];
 }
 
 // loadFromDatabase
 //  - Loads exhibits from the database table 'Exhibits'
+//  - Builds a single snapshot for the whole batch and publishes it once
 void ExhibitManager::loadFromDatabase(Database &db) {
   sqlite3_stmt *stmt;
   std::string sql = "SELECT name, type, capacity FROM Exhibits;";
   sqlite3_prepare_v2(db.get(), sql.c_str(), -1, &stmt, nullptr);
 
+  std::lock_guard<std::mutex> lock(writeMutex);
+  auto next = std::make_shared<Snapshot>(*snapshot());
+
   while (sqlite3_step(stmt) == SQLITE_ROW) {
     std::string name = (const char *)sqlite3_column_text(stmt, 0);
     std::string type = (const char *)sqlite3_column_text(stmt, 1);
@@ -156,10 +186,11 @@ void ExhibitManager::loadFromDatabase(Database &db) {
     // ✅ This constructor allocates the animals array
     Exhibit ex(name, type, capacity);
 
-    exhibits.push_back(ex);
+    appendLocked(ex, *next);
   }
 
   sqlite3_finalize(stmt);
+  current.store(std::move(next), std::memory_order_release);
 }
 
 // saveExhibitToDatabase
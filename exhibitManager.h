@@ -1,5 +1,5 @@
 // exhibitManager.h
-// Declaration of ExhibitManager: manages global list of exhibits and their
+// Declaration of ExhibitManager: owns the registry of exhibits and their
 // persistence.
 
 #ifndef EXHIBIT_MANAGER_H
@@ -7,33 +7,84 @@
 
 #include "database.h" // SQLite database wrapper
 #include "exhibit.h"  // Exhibit class definition
+#include <atomic>     // std::atomic<std::shared_ptr> for snapshot publishing
+#include <cstddef>
+#include <deque>      // Reference-stable exhibit storage
+#include <functional>
+#include <memory>     // std::shared_ptr snapshots
+#include <mutex>      // Serializes writers
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+// Transparent hash so the name index can be probed with a std::string_view
+// (or string literal) without building a temporary std::string
+struct ExhibitNameHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view name) const {
+    return std::hash<std::string_view>{}(name);
+  }
+};
+
 class ExhibitManager {
+public:
+  // Immutable view of the registry: which exhibits exist, by position and
+  // by name. Readers grab the current snapshot and use it without locking;
+  // addExhibit/loadFromDatabase build a new one and publish it, so a
+  // snapshot stays valid for as long as a reader holds it.
+  //  - Only the index is published this way. An exhibit's membership (its
+  //    slots and count) is changed in place by AnimalManager through the
+  //    mutable getters below, so it is only safe to read on the thread
+  //    that places animals (or while no placement can run).
+  struct Snapshot {
+    // Position -> exhibit (points into storage; read-only through here)
+    std::vector<const Exhibit *> byIndex;
+    std::unordered_map<std::string, int, ExhibitNameHash, std::equal_to<>>
+        byName; // Name -> position
+  };
+
 private:
-  // Static in-memory list of all Exhibit instances
-  static std::vector<Exhibit> exhibits;
+  // Owned exhibit storage; a deque never relocates existing elements on
+  // push_back, so Exhibit& handed out earlier stay valid as the zoo grows
+  std::deque<Exhibit> exhibits;
+
+  // Currently published snapshot (RCU-style: copy, modify, swap)
+  std::atomic<std::shared_ptr<const Snapshot>> current;
+
+  // Serializes writers; readers never take it
+  std::mutex writeMutex;
+
+  // Appends to storage and 'next' (caller holds writeMutex)
+  void appendLocked(const Exhibit &ex, Snapshot &next);
 
 public:
-  // Constructor: can load exhibits from database if desired
+  // Constructor: starts with an empty registry
   ExhibitManager();
 
+  // Registry owns its exhibits; copying would alias the published pointers
+  ExhibitManager(const ExhibitManager &) = delete;
+  ExhibitManager &operator=(const ExhibitManager &) = delete;
+
+  // Returns the current snapshot; safe to call from any thread
+  std::shared_ptr<const Snapshot> snapshot() const;
+
   // In-memory operations:
   void addExhibit(const Exhibit &ex);     // Add to list
   void viewExhibits() const;              // Print all exhibits
   int selectExhibit() const;              // Interactive selection
   void viewSelectedExhibit(int ex) const; // Print animals in selected exhibit
-  static bool exhibitExists(const std::string &ex); // Check existence by name
-  int getExhibitCount() const;                      // Return count of exhibits
+  bool exhibitExists(std::string_view ex) const; // Check existence by name
+  int getExhibitCount() const;                    // Return count of exhibits
   void viewAnimalsInExhibit(int idx) const; // Print animals in exhibit idx
 
-  // Accessors:
+  // Accessors (the modifiable ones are for the thread that places animals;
+  // see Snapshot):
   Exhibit &getExhibitByIndex(int index); // Return modifiable exhibit
   const Exhibit &getExhibitByIndex(int index) const;   // Return const reference
-  int findExhibitIndex(const std::string &name) const; // Find index by name
-  Exhibit &getExhibitByName(
-      const std::string &name); // Return by name (throws if not found)
+  int findExhibitIndex(std::string_view name) const; // Find index by name
+  Exhibit &
+  getExhibitByName(std::string_view name); // Return by name (throws if absent)
 
   // Database persistence:
   void loadFromDatabase(Database &db); // Load exhibits at startup
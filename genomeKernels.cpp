@@ -0,0 +1,137 @@
+// genomeKernels.cpp
+// Implements the genome kernels. As with the care kernels, the AVX2
+// variants are compiled with a per-function target attribute and chosen
+// once at first use via cpuid. A genome is exactly one 256-bit register.
+
+#include "genomeKernels.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h> // AVX2 intrinsics
+#define GENOME_KERNELS_X86 1
+#endif
+
+namespace {
+
+// ===== Scalar reference implementations =====
+void recombineScalar(const Genome *sire, const Genome *dam,
+                     const Genome *mask, const Genome *noise, Genome *child,
+                     std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const Genome *ns = noise + i * MUTATION_NOISE;
+    for (int w = 0; w < GENOME_WORDS; ++w) {
+      std::uint64_t flips = ~0ull;
+      for (int k = 0; k < MUTATION_NOISE; ++k) {
+        flips &= ns[k].words[w];
+      }
+      const std::uint64_t m = mask[i].words[w];
+      child[i].words[w] =
+          ((sire[i].words[w] & m) | (dam[i].words[w] & ~m)) ^ flips;
+    }
+  }
+}
+
+void distancesScalar(const Genome &g, const Genome *others, std::size_t n,
+                     std::uint16_t *out) {
+  for (std::size_t i = 0; i < n; ++i) {
+    int bits = 0;
+    for (int w = 0; w < GENOME_WORDS; ++w) {
+      bits += __builtin_popcountll(g.words[w] ^ others[i].words[w]);
+    }
+    out[i] = static_cast<std::uint16_t>(bits);
+  }
+}
+
+#ifdef GENOME_KERNELS_X86
+static_assert(GENOME_BITS == 256, "AVX2 kernels hold a genome per register");
+
+__attribute__((target("avx2"))) inline __m256i load(const Genome &g) {
+  return _mm256_load_si256(reinterpret_cast<const __m256i *>(g.words));
+}
+
+// ===== AVX2 implementations (one genome per register) =====
+__attribute__((target("avx2"))) void
+recombineAvx2(const Genome *sire, const Genome *dam, const Genome *mask,
+              const Genome *noise, Genome *child, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const Genome *ns = noise + i * MUTATION_NOISE;
+    __m256i flips = load(ns[0]);
+    for (int k = 1; k < MUTATION_NOISE; ++k) {
+      flips = _mm256_and_si256(flips, load(ns[k]));
+    }
+    const __m256i m = load(mask[i]);
+    const __m256i mixed = _mm256_or_si256(_mm256_and_si256(load(sire[i]), m),
+                                          _mm256_andnot_si256(m, load(dam[i])));
+    _mm256_store_si256(reinterpret_cast<__m256i *>(child[i].words),
+                       _mm256_xor_si256(mixed, flips));
+  }
+}
+
+// Population count per byte by nibble lookup, summed per 64-bit lane
+__attribute__((target("avx2"))) inline __m256i popcount64(__m256i v) {
+  const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+                                         2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                         1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0F);
+  const __m256i bytes = _mm256_add_epi8(
+      _mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+      _mm256_shuffle_epi8(table,
+                          _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+  return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2"))) void
+distancesAvx2(const Genome &g, const Genome *others, std::size_t n,
+              std::uint16_t *out) {
+  const __m256i vg = load(g);
+  for (std::size_t i = 0; i < n; ++i) {
+    const __m256i lanes = popcount64(_mm256_xor_si256(vg, load(others[i])));
+    const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(lanes),
+                                       _mm256_extracti128_si256(lanes, 1));
+    out[i] = static_cast<std::uint16_t>(_mm_cvtsi128_si64(half) +
+                                        _mm_extract_epi64(half, 1));
+  }
+}
+
+bool detectAvx2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+#else
+bool detectAvx2() { return false; }
+#endif
+
+// Resolved once; static initialization is thread-safe
+bool haveAvx2() {
+  static const bool avx2 = detectAvx2();
+  return avx2;
+}
+
+} // namespace
+
+namespace genomeKernels {
+
+bool usingAvx2() { return haveAvx2(); }
+
+void recombine(const Genome *sire, const Genome *dam, const Genome *mask,
+               const Genome *noise, Genome *child, std::size_t n) {
+#ifdef GENOME_KERNELS_X86
+  if (haveAvx2()) {
+    recombineAvx2(sire, dam, mask, noise, child, n);
+    return;
+  }
+#endif
+  recombineScalar(sire, dam, mask, noise, child, n);
+}
+
+void distances(const Genome &g, const Genome *others, std::size_t n,
+               std::uint16_t *out) {
+#ifdef GENOME_KERNELS_X86
+  if (haveAvx2()) {
+    distancesAvx2(g, others, n, out);
+    return;
+  }
+#endif
+  distancesScalar(g, others, n, out);
+}
+
+} // namespace genomeKernels
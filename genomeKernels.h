@@ -0,0 +1,46 @@
+// genomeKernels.h
+// Declaration of Genome, a fixed-width bitset of gene variants, and the
+// bit kernels breeding runs on: recombining two parents into a child and
+// counting the bits in which genomes differ. Each call picks an AVX2
+// implementation when the CPU supports it and a scalar loop otherwise.
+
+#ifndef GENOME_KERNELS_H
+#define GENOME_KERNELS_H
+
+#include <cstddef> // std::size_t
+#include <cstdint> // Genome words, distances
+
+constexpr int GENOME_BITS = 256;
+constexpr int GENOME_WORDS = GENOME_BITS / 64;
+
+// A child's mutations come from this many random genomes per child: a bit
+// flips only where all of them are set, i.e. with probability 1/256
+constexpr int MUTATION_NOISE = 8;
+
+// One animal's genes; bit i is the variant it carries at locus i. Bit 0 is
+// the sex locus (set = male).
+struct alignas(32) Genome {
+  std::uint64_t words[GENOME_WORDS] = {};
+
+  bool bit(int i) const { return (words[i / 64] >> (i % 64)) & 1; }
+};
+
+namespace genomeKernels {
+
+// True if the AVX2 kernels are in use on this machine
+bool usingAvx2();
+
+// For each of 'n' children:
+//   child[i] = ((sire[i] & mask[i]) | (dam[i] & ~mask[i])) ^ flips
+// where flips is the AND of noise[i * MUTATION_NOISE ...] (the next
+// MUTATION_NOISE genomes)
+void recombine(const Genome *sire, const Genome *dam, const Genome *mask,
+               const Genome *noise, Genome *child, std::size_t n);
+
+// out[i] = number of bits in which 'g' and others[i] differ
+void distances(const Genome &g, const Genome *others, std::size_t n,
+               std::uint16_t *out);
+
+} // namespace genomeKernels
+
+#endif // GENOME_KERNELS_H
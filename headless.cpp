@@ -0,0 +1,226 @@
+// headless.cpp
+// Implements the headless fast-forward mode.
+
+#include "headless.h"
+#include "animalCare.h"     // Care plans, feeding records
+#include "animalManager.h"  // Animals to simulate
+#include "database.h"       // Database wrapper for SQLite
+#include "exhibitManager.h" // Exhibits to simulate
+#include "jobSystem.h"      // Worker pool for simulation stages
+#include "simulation.h"     // Tick-based simulation of animal state
+#include "userInterface.h"  // initializeDatabase
+
+#include <chrono>   // Wall-clock timing of the run
+#include <iomanip>  // std::setprecision for progress output
+#include <iostream> // Progress output
+
+// Simulated days of care history kept uncompressed in memory; older days
+// are moved into the in-memory archive at every save
+static constexpr time_t kLiveHistoryDays = 30;
+
+// Prints one progress line describing the World and the visitor economy
+// after 'day' days
+static void printProgress(int day, int days, const World &world,
+                          const VisitorEconomy &economy, size_t feedings,
+                          double kg, double seconds) {
+  const AnimalTable &a = world.animals;
+  double health = 0.0, hunger = 0.0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    health += a.health[i];
+    hunger += a.hunger[i];
+  }
+  const double n = a.size() ? static_cast<double>(a.size()) : 1.0;
+  int overCapacity = 0;
+  for (size_t i = 0; i < world.exhibits.size(); ++i) {
+    if (world.exhibits.occupancy[i] > world.exhibits.capacity[i]) {
+      ++overCapacity;
+    }
+  }
+  std::cout << "[Day " << day << "/" << days << "] " << feedings
+            << " feeding(s), " << kg << " kg since last save; avg health "
+            << int(health / n * 100) << "%, avg hunger "
+            << int(hunger / n * 100) << "%, " << overCapacity
+            << " exhibit(s) over capacity; " << economy.attendanceToday
+            << " visitor(s) today, reputation "
+            << int(economy.reputation * 100) << "%, revenue $" << std::fixed
+            << std::setprecision(0) << economy.revenueTotal << " ("
+            << std::setprecision(2) << seconds << " s)\n"
+            << std::defaultfloat << std::setprecision(6);
+}
+
+// copyDatabase
+//  - SQLite's online backup copies every page of 'from' into 'to', replacing
+//    what 'to' held; the source is opened read-only, so it is never created
+static bool copyDatabase(const std::string &from, const std::string &to) {
+  sqlite3 *source = nullptr;
+  if (sqlite3_open_v2(from.c_str(), &source, SQLITE_OPEN_READONLY, nullptr) !=
+      SQLITE_OK) {
+    std::cerr << "[Error] Can't open " << from << ": "
+              << sqlite3_errmsg(source) << std::endl;
+    sqlite3_close(source);
+    return false;
+  }
+  Database copy(to);
+  bool ok = false;
+  if (copy.get()) {
+    sqlite3_backup *backup =
+        sqlite3_backup_init(copy.get(), "main", source, "main");
+    ok = backup && sqlite3_backup_step(backup, -1) == SQLITE_DONE;
+    sqlite3_backup_finish(backup);
+    if (!ok) {
+      std::cerr << "[Error] Failed to copy " << from << " to " << to << ": "
+                << sqlite3_errmsg(copy.get()) << std::endl;
+    }
+  }
+  sqlite3_close(source);
+  return ok;
+}
+
+// runHeadless
+//  - The scheduler runs on the simulated clock: after every tick the due
+//    feedings are carried out at that tick's time, which also re-arms them
+//  - Keepers clean every exhibit at the end of each cleaning-rota day
+//  - Feedings are recorded in memory straight away and only written to the
+//    database at the save points
+int runHeadless(const HeadlessOptions &options) {
+  if (options.days <= 0 || options.saveEveryDays <= 0 ||
+      options.rationKg <= 0 || options.cleanEveryDays < 0) {
+    std::cerr << "[Error] Headless mode needs positive days, save interval "
+                 "and ration, and a non-negative cleaning interval"
+              << std::endl;
+    return 1;
+  }
+  const bool inPlace = !options.dbPath.empty();
+  const std::string &path = inPlace ? options.dbPath : options.copyPath;
+  if (!inPlace && !copyDatabase(options.sourcePath, path)) {
+    return 1;
+  }
+  Database db(path);
+  if (!db.get()) {
+    return 1;
+  }
+  initializeDatabase(db);
+  if (inPlace) {
+    std::cout << "Updating " << path << " in place\n";
+  } else {
+    std::cout << "Working on a copy of " << options.sourcePath << " in "
+              << path << "\n";
+  }
+
+  ExhibitManager exhibitMgr;
+  AnimalManager animalMgr;
+  AnimalCareManager careMgr;
+  JobSystem jobs;
+  Simulation sim;
+  sim.setJobSystem(&jobs);
+
+  exhibitMgr.loadFromDatabase(db);
+  animalMgr.loadFromDatabase(exhibitMgr, db);
+  careMgr.loadFromDatabase(db);
+  sim.loadFromDatabase(db);
+  sim.sync(animalMgr, exhibitMgr);
+  if (options.seed) {
+    sim.setSeed(options.seed);
+  }
+  if (!options.recordPath.empty() && !sim.startRecording(options.recordPath)) {
+    return 1;
+  }
+  CareScheduler &scheduler = careMgr.getScheduler();
+  scheduler.loadFromDatabase(db, sim.getTime());
+
+  std::cout << "Fast-forwarding " << options.days << " day(s): "
+            << sim.getWorld().animals.size() << " animal(s), "
+            << sim.getWorld().exhibits.size() << " exhibit(s), "
+            << scheduler.planCount() << " care plan(s), "
+            << jobs.getThreadCount() << " thread(s)\n";
+
+  const auto started = std::chrono::steady_clock::now();
+  auto elapsed = [&] {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         started)
+        .count();
+  };
+
+  size_t totalFeedings = 0, intakeAlerts = 0;
+  double totalKg = 0.0, batchKg = 0.0;
+  for (int day = 1; day <= options.days; ++day) {
+    for (int hour = 0; hour < Simulation::TICKS_PER_DAY; ++hour) {
+      sim.step();
+      const time_t now = sim.getTime();
+      for (const DueCare &due : scheduler.dueCare(now)) {
+        if (due.kind != CareType::Feeding) {
+          continue; // Health checks need a vet; they stay due
+        }
+        careMgr.recordFeeding(due.animalId, options.food, options.rationKg,
+                              now);
+        sim.feed(due.animalId, options.rationKg);
+        batchKg += options.rationKg;
+      }
+    }
+    if (options.cleanEveryDays > 0 && day % options.cleanEveryDays == 0) {
+      World &world = sim.getWorld();
+      for (size_t i = 0; i < world.exhibits.size(); ++i) {
+        sim.cleanExhibit(world.exhibits.name[i]);
+      }
+    }
+
+    if (day % options.saveEveryDays != 0 && day != options.days) {
+      continue;
+    }
+    // The last save is a base, so the chain left behind needs no replay
+    // under this build
+    const int saved = careMgr.saveToDatabase(db);
+    if (saved < 0 || !sim.saveToDatabase(db, day == options.days)) {
+      std::cerr << "[Error] Headless save failed on day " << day
+                << std::endl;
+      return 1;
+    }
+    careMgr.archiveBefore(sim.getTime() -
+                          kLiveHistoryDays * CarePeriod::SECONDS_PER_DAY);
+    printProgress(day, options.days, sim.getWorld(),
+                  sim.getCrowd().getEconomy(), static_cast<size_t>(saved),
+                  batchKg, elapsed());
+    totalFeedings += static_cast<size_t>(saved);
+    intakeAlerts += careMgr.takeAlerts().size(); // Counted, not printed
+    totalKg += batchKg;
+    batchKg = 0.0;
+  }
+
+  size_t healthDue = 0;
+  for (const DueCare &due : scheduler.dueCare(sim.getTime())) {
+    if (due.kind == CareType::Health) {
+      ++healthDue;
+    }
+  }
+  sim.stopRecording();
+  const double seconds = elapsed();
+  std::cout << "Done: " << options.days << " day(s) (" << sim.getTick()
+            << " ticks total) in " << seconds << " s; " << totalFeedings
+            << " feeding(s), " << totalKg << " kg of " << options.food
+            << " (" << intakeAlerts << " intake alert(s)); " << healthDue
+            << " health check(s) overdue; state hash "
+            << std::hex << sim.stateHash() << std::dec << "\n";
+  return 0;
+}
+
+// runReplay
+//  - The hash must not depend on 'threads'; comparing runs with different
+//    counts checks exactly that
+int runReplay(const std::string &path, unsigned threads) {
+  JobSystem jobs(threads);
+  Simulation sim;
+  sim.setJobSystem(&jobs);
+  const auto started = std::chrono::steady_clock::now();
+  const long long applied = sim.replay(path);
+  if (applied < 0) {
+    return 1;
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - started)
+                             .count();
+  std::cout << "Replayed " << applied << " command(s) to tick "
+            << sim.getTick() << " on " << jobs.getThreadCount()
+            << " thread(s) in " << seconds << " s; state hash " << std::hex
+            << sim.stateHash() << std::dec << "\n";
+  return 0;
+}
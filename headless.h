@@ -0,0 +1,38 @@
+// headless.h
+// Declaration of the headless (non-interactive) modes: the fast-forward,
+// which loads the zoo, runs the simulation flat out for a number of
+// simulated days with keepers carrying out due feeding plans and persists
+// progress in batches; and the replay of a recorded input log.
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <string> // Food name, database path
+
+struct HeadlessOptions {
+  int days = 0;                             // Simulated days to run
+  int saveEveryDays = 30;                   // Persistence/progress interval
+  double rationKg = 5.0;                    // Amount given per due feeding
+  int cleanEveryDays = 1;                   // Cleaning rota; 0 = never
+  std::string food = "Standard ration";     // Food recorded for feedings
+  std::string sourcePath = "zoo.db";        // Save the scenario starts from
+  std::string copyPath = "zoo-headless.db"; // Copy of it the run updates
+  std::string dbPath;                       // Update in place; "" = copy
+  std::string recordPath;                   // Input log to write; "" = none
+  unsigned long long seed = 0;              // Simulation seed; 0 = keep saved
+};
+
+// Runs the fast-forward. Unless 'dbPath' names a database to update, the
+// live save is left alone: it is copied to 'copyPath' and the run works on
+// the copy. Every 'saveEveryDays' simulated days the feedings given since
+// the last save are inserted in one transaction, the simulation state is
+// saved, and a progress line is printed.
+//  - Returns a process exit code (0 on success)
+int runHeadless(const HeadlessOptions &options);
+
+// Replays the input log at 'path' on 'threads' threads (0 = all cores) and
+// prints the resulting state hash. Touches no database.
+//  - Returns a process exit code (0 on success)
+int runReplay(const std::string &path, unsigned threads);
+
+#endif // HEADLESS_H
@@ -0,0 +1,122 @@
+// intakeMonitor.cpp
+// Implements IntakeMonitor using the incremental EWMA mean/variance update:
+//   diff = x - mean;  mean += alpha * diff;
+//   variance = (1 - alpha) * (variance + alpha * diff * diff)
+
+#include "intakeMonitor.h"
+#include <algorithm> // std::max
+#include <cmath>     // std::sqrt, std::fabs
+#include <iostream>  // std::cerr for database errors
+#include <sqlite3.h> // Prepared statements
+
+// Spread never drops below this (kg, or fraction of the mean), so a run of
+// identical feedings does not turn every small change into an alert
+static constexpr double kMinStdDevKg = 0.1;
+static constexpr double kMinStdDevFraction = 0.05;
+
+IntakeMonitor::IntakeMonitor(double alpha, double zThreshold, long warmup)
+    : alpha(alpha), zThreshold(zThreshold), warmup(warmup) {}
+
+// observe
+//  - The first feeding seeds the mean; later ones are scored against the
+//    baseline as it stood before them
+std::optional<IntakeAlert> IntakeMonitor::observe(int animalId, time_t time,
+                                                  double amount) {
+  IntakeBaseline &b = baselines[animalId];
+  changed.insert(animalId);
+  std::optional<IntakeAlert> alert;
+  if (b.samples == 0) {
+    b.mean = amount;
+    b.variance = 0.0;
+    b.samples = 1;
+    return alert;
+  }
+
+  const double diff = amount - b.mean;
+  if (b.samples >= warmup) {
+    double stdDev = std::max({std::sqrt(b.variance), kMinStdDevKg,
+                              kMinStdDevFraction * std::fabs(b.mean)});
+    double z = diff / stdDev;
+    if (std::fabs(z) > zThreshold) {
+      alert = IntakeAlert{animalId, time, amount, b.mean, stdDev, z};
+    }
+  }
+
+  const double incr = alpha * diff;
+  b.mean += incr;
+  b.variance = (1.0 - alpha) * (b.variance + diff * incr);
+  ++b.samples;
+  return alert;
+}
+
+const IntakeBaseline *IntakeMonitor::baseline(int animalId) const {
+  auto it = baselines.find(animalId);
+  return it == baselines.end() ? nullptr : &it->second;
+}
+
+// loadFromDatabase
+//  - One row per animal; nothing loaded counts as changed
+bool IntakeMonitor::loadFromDatabase(Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "SELECT animal_id, mean, variance, samples FROM IntakeBaselines;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+  baselines.clear();
+  changed.clear();
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    IntakeBaseline &b = baselines[sqlite3_column_int(stmt, 0)];
+    b.mean = sqlite3_column_double(stmt, 1);
+    b.variance = sqlite3_column_double(stmt, 2);
+    b.samples = static_cast<long>(sqlite3_column_int64(stmt, 3));
+  }
+  sqlite3_finalize(stmt);
+  return true;
+}
+
+// saveToDatabase
+//  - An INSERT OR REPLACE per changed baseline, a DELETE per forgotten one
+bool IntakeMonitor::saveToDatabase(Database &db) const {
+  if (changed.empty()) {
+    return true;
+  }
+  sqlite3_stmt *upsert = nullptr;
+  sqlite3_stmt *remove = nullptr;
+  if (sqlite3_prepare_v2(db.get(),
+                         "INSERT OR REPLACE INTO IntakeBaselines (animal_id, "
+                         "mean, variance, samples) VALUES (?, ?, ?, ?);",
+                         -1, &upsert, nullptr) != SQLITE_OK ||
+      sqlite3_prepare_v2(db.get(),
+                         "DELETE FROM IntakeBaselines WHERE animal_id = ?;",
+                         -1, &remove, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    sqlite3_finalize(upsert);
+    sqlite3_finalize(remove);
+    return false;
+  }
+  bool ok = true;
+  for (int id : changed) {
+    auto it = baselines.find(id);
+    sqlite3_stmt *stmt = it == baselines.end() ? remove : upsert;
+    sqlite3_bind_int(stmt, 1, id);
+    if (it != baselines.end()) {
+      sqlite3_bind_double(stmt, 2, it->second.mean);
+      sqlite3_bind_double(stmt, 3, it->second.variance);
+      sqlite3_bind_int64(stmt, 4, it->second.samples);
+    }
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      std::cerr << "[Error] Failed to save intake baseline: "
+                << sqlite3_errmsg(db.get()) << std::endl;
+      ok = false;
+      break;
+    }
+    sqlite3_reset(stmt);
+  }
+  sqlite3_finalize(upsert);
+  sqlite3_finalize(remove);
+  return ok;
+}
@@ -0,0 +1,72 @@
+// intakeMonitor.h
+// Declaration of IntakeMonitor: streaming per-animal feeding baselines that
+// flag intake far from an animal's recent norm (an early illness signal).
+// Baselines are saved (IntakeBaselines table) so they survive restarts
+// instead of warming up again each session.
+
+#ifndef INTAKE_MONITOR_H
+#define INTAKE_MONITOR_H
+
+#include "database.h"    // IntakeBaselines table
+#include <ctime>         // time_t
+#include <optional>      // Alert or nothing
+#include <unordered_map> // Animal ID -> baseline
+#include <unordered_set> // Animals changed since the last save
+
+// Exponentially weighted mean/variance of one animal's feeding amounts
+struct IntakeBaseline {
+  double mean = 0.0;
+  double variance = 0.0;
+  long samples = 0;
+};
+
+// A feeding whose amount was an outlier against the animal's baseline
+struct IntakeAlert {
+  int animalId;
+  time_t time;
+  double amount;
+  double mean;   // Baseline before this feeding
+  double stdDev; // Baseline spread before this feeding (after the floor)
+  double zScore; // (amount - mean) / stdDev
+};
+
+class IntakeMonitor {
+public:
+  // alpha: weight of each new feeding (0 < alpha <= 1)
+  // zThreshold: |z| above which a feeding is flagged
+  // warmup: feedings observed before any alert can fire
+  explicit IntakeMonitor(double alpha = 0.2, double zThreshold = 3.0,
+                         long warmup = 5);
+
+  // Scores 'amount' against the animal's baseline, then folds it in.
+  // O(1) time and O(1) memory per animal; history is never rescanned.
+  //  - Returns the alert if the feeding was an outlier
+  std::optional<IntakeAlert> observe(int animalId, time_t time, double amount);
+
+  // Current baseline, or nullptr if the animal has never been fed
+  const IntakeBaseline *baseline(int animalId) const;
+
+  void forget(int animalId) {
+    baselines.erase(animalId);
+    changed.insert(animalId);
+  }
+
+  // Database operations:
+  //  - loadFromDatabase replaces the baselines with the saved ones
+  //  - saveToDatabase writes the baselines changed since markSaved (and
+  //    deletes forgotten ones); callers wrap it in their transaction and
+  //    call markSaved once that commits
+  bool loadFromDatabase(Database &db);
+  bool saveToDatabase(Database &db) const;
+  void markSaved() { changed.clear(); }
+  bool hasUnsaved() const { return !changed.empty(); }
+
+private:
+  double alpha;
+  double zThreshold;
+  long warmup;
+  std::unordered_map<int, IntakeBaseline> baselines;
+  std::unordered_set<int> changed; // Dirty tracking for saveToDatabase
+};
+
+#endif // INTAKE_MONITOR_H
@@ -0,0 +1,214 @@
+// jobSystem.cpp
+// Implements JobSystem and its Chase-Lev deques.
+
+#include "jobSystem.h"
+#include <algorithm> // std::min, std::max
+
+// Worker index of the current thread within 'tlsPool' (threads outside any
+// pool have tlsPool == nullptr)
+static thread_local const JobSystem *tlsPool = nullptr;
+static thread_local unsigned tlsIndex = 0;
+
+// Idle rounds (steal attempts over every victim) before a worker sleeps
+static constexpr int kSpinRounds = 64;
+
+// ===== Deque =====
+JobSystem::Deque::Buffer::Buffer(std::int64_t cap)
+    : capacity(cap), slots(new std::atomic<Job *>[cap]) {}
+
+JobSystem::Deque::Deque() {
+  buffers.push_back(std::make_unique<Buffer>(256));
+  buffer.store(buffers.back().get(), std::memory_order_relaxed);
+}
+
+void JobSystem::Deque::push(Job *job) {
+  std::int64_t b = bottom.load(std::memory_order_relaxed);
+  std::int64_t t = top.load(std::memory_order_acquire);
+  Buffer *buf = buffer.load(std::memory_order_relaxed);
+  if (b - t > buf->capacity - 1) {
+    // Full: copy live entries into a buffer twice the size
+    auto bigger = std::make_unique<Buffer>(buf->capacity * 2);
+    for (std::int64_t i = t; i < b; ++i) {
+      bigger->put(i, buf->get(i));
+    }
+    buf = bigger.get();
+    buffers.push_back(std::move(bigger));
+    buffer.store(buf, std::memory_order_release);
+  }
+  buf->put(b, job);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+JobSystem::Job *JobSystem::Deque::pop() {
+  std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+  Buffer *buf = buffer.load(std::memory_order_relaxed);
+  bottom.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t t = top.load(std::memory_order_relaxed);
+  if (t > b) { // Empty
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  Job *job = buf->get(b);
+  if (t == b) { // Last entry: race any thief for it
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      job = nullptr;
+    }
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+  return job;
+}
+
+JobSystem::Job *JobSystem::Deque::steal() {
+  std::int64_t t = top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t b = bottom.load(std::memory_order_acquire);
+  if (t >= b) {
+    return nullptr;
+  }
+  Buffer *buf = buffer.load(std::memory_order_acquire);
+  Job *job = buf->get(t);
+  if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                   std::memory_order_relaxed)) {
+    return nullptr; // Lost the race; the caller just tries again
+  }
+  return job;
+}
+
+// ===== JobSystem =====
+JobSystem::JobSystem(unsigned count) {
+  if (count == 0) {
+    count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (unsigned i = 0; i < count; ++i) {
+    deques.push_back(std::make_unique<Deque>());
+  }
+  tlsPool = this;
+  tlsIndex = 0;
+  threads.reserve(count - 1);
+  for (unsigned i = 1; i < count; ++i) {
+    threads.emplace_back(&JobSystem::workerLoop, this, i);
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping.store(true);
+  }
+  wake.notify_all();
+  for (auto &t : threads) {
+    t.join();
+  }
+  if (tlsPool == this) {
+    tlsPool = nullptr;
+  }
+}
+
+void JobSystem::execute(Job *job) {
+  job->run(job->ctx, job->begin, job->end);
+  job->remaining->fetch_sub(1, std::memory_order_release);
+}
+
+// findWork
+//  - Own deque first (LIFO, cache-warm), then one pass over the other
+//    deques starting at a random victim
+JobSystem::Job *JobSystem::findWork(unsigned self, std::uint64_t &rng) {
+  if (Job *job = deques[self]->pop()) {
+    return job;
+  }
+  const unsigned n = static_cast<unsigned>(deques.size());
+  rng ^= rng << 13; // xorshift64
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  const unsigned start = static_cast<unsigned>(rng % n);
+  for (unsigned k = 0; k < n; ++k) {
+    unsigned victim = (start + k) % n;
+    if (victim == self) {
+      continue;
+    }
+    if (Job *job = deques[victim]->steal()) {
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+// workerLoop
+//  - Spins for a while when idle, then sleeps until 'epoch' moves; reading
+//    the epoch before searching means a push made during the search is
+//    never slept through
+void JobSystem::workerLoop(unsigned index) {
+  tlsPool = this;
+  tlsIndex = index;
+  std::uint64_t rng = 0x9E3779B97F4A7C15ull * (index + 1);
+  int idle = 0;
+  while (!stopping.load(std::memory_order_relaxed)) {
+    const std::uint64_t seen = epoch.load(std::memory_order_acquire);
+    if (Job *job = findWork(index, rng)) {
+      execute(job);
+      idle = 0;
+      continue;
+    }
+    if (++idle < kSpinRounds) {
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wake.wait(lock, [&] {
+      return stopping.load() || epoch.load(std::memory_order_acquire) != seen;
+    });
+    idle = 0;
+  }
+}
+
+// run
+//  - Chunks are pushed onto the caller's own deque (pushed in reverse so
+//    the owner pops them front to back while thieves take from the far
+//    end), then the caller helps until the shared counter drains
+void JobSystem::run(const RangeTask *tasks, std::size_t numTasks,
+                    std::size_t grain) {
+  grain = std::max<std::size_t>(grain, 1);
+  if (tlsPool != this || deques.size() == 1) {
+    for (std::size_t i = 0; i < numTasks; ++i) {
+      if (tasks[i].count > 0) {
+        tasks[i].run(tasks[i].ctx, 0, tasks[i].count);
+      }
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> remaining{0};
+  std::vector<Job> jobs;
+  for (std::size_t i = 0; i < numTasks; ++i) {
+    for (std::size_t b = 0; b < tasks[i].count; b += grain) {
+      jobs.push_back({tasks[i].run, tasks[i].ctx, b,
+                      std::min(tasks[i].count, b + grain), &remaining});
+    }
+  }
+  if (jobs.empty()) {
+    return;
+  }
+  remaining.store(jobs.size(), std::memory_order_relaxed);
+
+  const unsigned self = tlsIndex;
+  for (auto it = jobs.rbegin(); it != jobs.rend(); ++it) {
+    deques[self]->push(&*it);
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    epoch.fetch_add(1, std::memory_order_release);
+  }
+  wake.notify_all();
+
+  std::uint64_t rng = 0x2545F4914F6CDD1Dull + self;
+  while (remaining.load(std::memory_order_acquire) > 0) {
+    if (Job *job = findWork(self, rng)) {
+      execute(job);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
@@ -0,0 +1,114 @@
+// jobSystem.h
+// Declaration of JobSystem: a work-stealing thread pool. Every worker owns
+// a Chase-Lev deque; it pushes and pops at the bottom, and idle workers steal
+// from the top of a random victim's deque. Work is submitted as index
+// ranges split into chunks, and the submitting thread helps run them while
+// it waits.
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>             // Deque indices, counters
+#include <condition_variable> // Idle workers sleep until work arrives
+#include <cstddef>            // std::size_t
+#include <cstdint>            // Deque indices
+#include <memory>             // Deque buffers
+#include <mutex>              // Guards the sleep condition
+#include <thread>             // Worker threads
+#include <vector>             // Workers, pending chunks
+
+// Body of a range task: processes indices [begin, end)
+using RangeFn = void (*)(const void *ctx, std::size_t begin, std::size_t end);
+
+// One index range to split into chunks
+struct RangeTask {
+  RangeFn run;
+  const void *ctx;
+  std::size_t count;
+};
+
+class JobSystem {
+public:
+  // threads: total threads including the caller; 0 uses
+  // std::thread::hardware_concurrency(). The constructing thread becomes
+  // worker 0 and is the only non-worker thread allowed to submit work.
+  explicit JobSystem(unsigned threads = 0);
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  // Runs every task's range in chunks of at most 'grain' indices and
+  // returns once all of them have finished. Chunks of different tasks may
+  // run concurrently. Called from a thread that is not part of this pool,
+  // the tasks simply run inline.
+  void run(const RangeTask *tasks, std::size_t numTasks, std::size_t grain);
+
+  // Convenience wrapper: fn(begin, end) over [0, count)
+  template <typename Fn>
+  void parallelFor(std::size_t count, std::size_t grain, const Fn &fn) {
+    RangeTask task{[](const void *ctx, std::size_t b, std::size_t e) {
+                     (*static_cast<const Fn *>(ctx))(b, e);
+                   },
+                   &fn, count};
+    run(&task, 1, grain);
+  }
+
+  unsigned getThreadCount() const {
+    return static_cast<unsigned>(deques.size());
+  }
+
+private:
+  struct Job {
+    RangeFn run;
+    const void *ctx;
+    std::size_t begin;
+    std::size_t end;
+    std::atomic<std::size_t> *remaining;
+  };
+
+  // Chase-Lev work-stealing deque ("Correct and Efficient Work-Stealing for
+  // Weak Memory Models", Le et al. 2013). Grows when full; retired buffers
+  // are kept until destruction because a thief may still be reading one.
+  // Slots use acquire/release rather than the paper's relaxed accesses so
+  // the job a thief takes is visibly published without relying on fences.
+  class Deque {
+  public:
+    Deque();
+    void push(Job *job); // Owner only
+    Job *pop();          // Owner only
+    Job *steal();        // Any thread
+
+  private:
+    struct Buffer {
+      std::int64_t capacity;
+      std::unique_ptr<std::atomic<Job *>[]> slots;
+      explicit Buffer(std::int64_t cap);
+      Job *get(std::int64_t i) const {
+        return slots[i & (capacity - 1)].load(std::memory_order_acquire);
+      }
+      void put(std::int64_t i, Job *job) {
+        slots[i & (capacity - 1)].store(job, std::memory_order_release);
+      }
+    };
+
+    alignas(64) std::atomic<std::int64_t> top{0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+    std::atomic<Buffer *> buffer;
+    std::vector<std::unique_ptr<Buffer>> buffers; // Current + retired
+  };
+
+  std::vector<std::unique_ptr<Deque>> deques; // One per worker
+  std::vector<std::thread> threads;           // Workers 1..N-1
+
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  std::atomic<std::uint64_t> epoch{0}; // Bumped whenever work is pushed
+  std::atomic<bool> stopping{false};
+
+  void workerLoop(unsigned index);
+  Job *findWork(unsigned self, std::uint64_t &rng);
+  static void execute(Job *job);
+};
+
+#endif // JOB_SYSTEM_H
@@ -1,10 +1,91 @@
 // main.cpp
 // Entry point for the Zoo Management application
+//  - No arguments: interactive console UI
+//  - --record FILE: interactive UI, recording simulation inputs to FILE
+//  - --headless DAYS [options]: fast-forward the simulation without the UI
+//  - --replay FILE [--threads N]: replay a recorded input log
 
+#include "headless.h"      // Declares runHeadless(), runReplay()
 #include "userInterface.h" // Declares runUserInterface()
 
-int main() {
-  // Launches the console-based UI; will not return until user exits
-  runUserInterface();
-  return 0; // Indicates successful termination
+#include <cstdlib>  // std::strtol, std::strtod, std::strtoull
+#include <cstring>  // std::strcmp
+#include <iostream> // Usage message
+
+static void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " [--record FILE]\n"
+            << "       " << program
+            << " --headless DAYS [--save-every K] [--ration KG]"
+               " [--clean-every D] [--copy-to FILE | --db FILE]"
+               " [--record FILE] [--seed N]\n"
+            << "       " << program << " --replay FILE [--threads N]\n"
+            << "       (--clean-every 0 disables exhibit cleaning; headless"
+               " runs work on a copy of zoo.db, zoo-headless.db by default,"
+               " unless --db names a database to update in place)"
+            << std::endl;
+}
+
+// Parses a non-negative integer argument; returns -1 if it is not one
+static int parseCount(const char *text) {
+  char *end = nullptr;
+  long v = std::strtol(text, &end, 10);
+  return (*end == '\0' && v >= 0 && v <= 1000000) ? static_cast<int>(v) : -1;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc == 1) {
+    // Launches the console-based UI; will not return until user exits
+    runUserInterface();
+    return 0; // Indicates successful termination
+  }
+  if (argc == 3 && std::strcmp(argv[1], "--record") == 0) {
+    runUserInterface(argv[2]);
+    return 0;
+  }
+  if (std::strcmp(argv[1], "--replay") == 0) {
+    int threads = 0;
+    if (argc == 5 && std::strcmp(argv[3], "--threads") == 0) {
+      threads = parseCount(argv[4]);
+    } else if (argc != 3) {
+      threads = -1;
+    }
+    if (threads < 0) {
+      printUsage(argv[0]);
+      return 1;
+    }
+    return runReplay(argv[2], static_cast<unsigned>(threads));
+  }
+
+  HeadlessOptions options;
+  if (std::strcmp(argv[1], "--headless") != 0 || argc < 3 ||
+      (options.days = parseCount(argv[2])) <= 0) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  for (int i = 3; i < argc; i += 2) {
+    if (i + 1 >= argc) {
+      printUsage(argv[0]);
+      return 1;
+    }
+    const char *value = argv[i + 1];
+    if (std::strcmp(argv[i], "--save-every") == 0) {
+      options.saveEveryDays = parseCount(value);
+    } else if (std::strcmp(argv[i], "--ration") == 0) {
+      options.rationKg = std::strtod(value, nullptr);
+    } else if (std::strcmp(argv[i], "--clean-every") == 0) {
+      options.cleanEveryDays = parseCount(value);
+    } else if (std::strcmp(argv[i], "--db") == 0) {
+      options.dbPath = value;
+    } else if (std::strcmp(argv[i], "--copy-to") == 0) {
+      options.copyPath = value;
+    } else if (std::strcmp(argv[i], "--record") == 0) {
+      options.recordPath = value;
+    } else if (std::strcmp(argv[i], "--seed") == 0) {
+      options.seed = std::strtoull(value, nullptr, 10);
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  return runHeadless(options);
 }
@@ -0,0 +1,300 @@
+// outbreak.cpp
+// Implements OutbreakModel: the contact graph, seeding from diagnoses and
+// the daily frontier update.
+
+#include "outbreak.h"
+#include <algorithm>     // std::search, std::clamp
+#include <cctype>        // std::tolower
+#include <cmath>         // std::exp
+#include <cstdlib>       // std::abs
+#include <string_view>   // Diagnosis text
+#include <unordered_map> // Animal ID -> row when seeding
+
+// Salt of the infectious-period stream within a day's stream
+static constexpr std::uint64_t kPeriodSalt = 1;
+
+// True if 'text' contains 'needle' (already lower case), ignoring case
+static bool containsIgnoreCase(std::string_view text,
+                               const std::string &needle) {
+  return std::search(text.begin(), text.end(), needle.begin(), needle.end(),
+                     [](char a, char b) {
+                       return std::tolower(static_cast<unsigned char>(a)) == b;
+                     }) != text.end();
+}
+
+// fromMap
+//  - Walking distance is never shorter than the straight (Manhattan) one,
+//    so with buckets 'rangeTiles' wide only the 3x3 buckets around an
+//    entrance can hold contacts
+ContactGraph ContactGraph::fromMap(const ZooMap &map, int rangeTiles) {
+  const int n = static_cast<int>(map.plotCount());
+  const int cell = std::max(rangeTiles, 1);
+  const int cols = map.getWidth() / cell + 1;
+  const int rows = map.getHeight() / cell + 1;
+  std::vector<std::vector<int>> buckets(static_cast<std::size_t>(cols) *
+                                        rows);
+  for (int r = 0; r < n; ++r) {
+    if (map.getPlot(r).placed()) {
+      const MapPoint e = map.getPlot(r).entrance();
+      buckets[(e.y / cell) * cols + e.x / cell].push_back(r);
+    }
+  }
+
+  struct Edge {
+    int a;
+    int b;
+    float weight;
+  };
+  std::vector<Edge> edges;
+  for (int a = 0; a < n; ++a) {
+    if (!map.getPlot(a).placed()) {
+      continue;
+    }
+    const MapPoint ea = map.getPlot(a).entrance();
+    const int cx = ea.x / cell, cy = ea.y / cell;
+    for (int by = std::max(cy - 1, 0); by <= std::min(cy + 1, rows - 1);
+         ++by) {
+      for (int bx = std::max(cx - 1, 0); bx <= std::min(cx + 1, cols - 1);
+           ++bx) {
+        for (int b : buckets[by * cols + bx]) {
+          const MapPoint eb = map.getPlot(b).entrance();
+          if (b <= a ||
+              std::abs(ea.x - eb.x) + std::abs(ea.y - eb.y) > rangeTiles) {
+            continue;
+          }
+          const int d = map.distance(a, b);
+          if (d != ZooMap::UNREACHABLE && d <= rangeTiles) {
+            edges.push_back(
+                {a, b, 1.0f - static_cast<float>(d) / (rangeTiles + 1)});
+          }
+        }
+      }
+    }
+  }
+
+  ContactGraph g;
+  g.offsets.assign(n + 1, 0);
+  for (const Edge &e : edges) {
+    ++g.offsets[e.a + 1];
+    ++g.offsets[e.b + 1];
+  }
+  for (int r = 0; r < n; ++r) {
+    g.offsets[r + 1] += g.offsets[r];
+  }
+  g.neighbours.resize(edges.size() * 2);
+  g.weight.resize(edges.size() * 2);
+  std::vector<int> next(g.offsets.begin(), g.offsets.end() - 1);
+  for (const Edge &e : edges) {
+    g.neighbours[next[e.a]] = e.b;
+    g.weight[next[e.a]++] = e.weight;
+    g.neighbours[next[e.b]] = e.a;
+    g.weight[next[e.b]++] = e.weight;
+  }
+  return g;
+}
+
+OutbreakModel::OutbreakModel(const World &world, const ZooMap &map,
+                             const OutbreakParams &params, JobSystem *jobs)
+    : params(params), animalId(world.animals.animalId) {
+  map.prepare(jobs);
+  graph = ContactGraph::fromMap(map, params.rangeTiles);
+
+  // Bucket the animals by group (a counting sort keeps row order inside
+  // each group)
+  const int groups = static_cast<int>(world.exhibits.size()) + 1;
+  const std::size_t animals = world.animals.size();
+  groupOf.resize(animals);
+  memberOffsets.assign(groups + 1, 0);
+  for (std::size_t r = 0; r < animals; ++r) {
+    const int ex = world.animals.exhibit[r];
+    groupOf[r] = ex >= 0 ? ex : groups - 1;
+    ++memberOffsets[groupOf[r] + 1];
+  }
+  for (int g = 0; g < groups; ++g) {
+    memberOffsets[g + 1] += memberOffsets[g];
+  }
+  members.resize(animals);
+  std::vector<int> next(memberOffsets.begin(), memberOffsets.end() - 1);
+  for (std::size_t r = 0; r < animals; ++r) {
+    members[next[groupOf[r]]++] = static_cast<int>(r);
+  }
+
+  state.assign(animals, Susceptible);
+  daysLeft.assign(animals, 0);
+  infected.assign(groups, 0);
+  cases.assign(groups, 0);
+  newCases.assign(groups, 0);
+  recoveries.assign(groups, 0);
+  seenOnDay.assign(groups, -1);
+  counts.susceptible = static_cast<long long>(animals);
+}
+
+std::uint8_t OutbreakModel::drawPeriod(int row, const SimRng &rng) const {
+  const int lo = std::clamp(params.minDays, 1, 255);
+  const int hi = std::clamp(params.maxDays, lo, 255);
+  const int days = lo + static_cast<int>(rng.uniform(animalId[row]) *
+                                         static_cast<float>(hi - lo + 1));
+  return static_cast<std::uint8_t>(std::min(days, hi));
+}
+
+bool OutbreakModel::infect(int animalRow) {
+  if (animalRow < 0 || animalRow >= static_cast<int>(state.size()) ||
+      state[animalRow] != Susceptible) {
+    return false;
+  }
+  const int g = groupOf[animalRow];
+  state[animalRow] = Infected;
+  daysLeft[animalRow] =
+      drawPeriod(animalRow, SimRng(params.seed).derive(day).derive(
+                                kPeriodSalt));
+  if (infected[g]++ == 0) {
+    active.push_back(g);
+  }
+  ++cases[g];
+  --counts.susceptible;
+  ++counts.infected;
+  return true;
+}
+
+// seedFromDiagnoses
+//  - The checks arrive sorted by animal and time, so each animal's run ends
+//    with its latest check
+int OutbreakModel::seedFromDiagnoses(const AnimalCareManager &care,
+                                     Database &db, const std::string &disease,
+                                     time_t since, time_t until) {
+  std::string needle;
+  for (char c : disease) {
+    needle += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  if (needle.empty()) {
+    return 0;
+  }
+  std::unordered_map<int, int> rowOf;
+  for (std::size_t r = 0; r < state.size(); ++r) {
+    rowOf.emplace(animalId[r], static_cast<int>(r));
+  }
+  const std::vector<DiagnosisEntry> checks =
+      care.diagnosesBetween(since, until, db);
+  int seeded = 0;
+  for (std::size_t i = 0; i < checks.size();) {
+    const int id = checks[i].animalId;
+    bool hadIt = false;
+    bool hasIt = false;
+    for (; i < checks.size() && checks[i].animalId == id; ++i) {
+      hasIt = containsIgnoreCase(checks[i].diagnosis, needle);
+      hadIt = hadIt || hasIt;
+    }
+    const auto row = rowOf.find(id);
+    if (row == rowOf.end() || state[row->second] != Susceptible) {
+      continue;
+    }
+    if (hasIt) {
+      seeded += infect(row->second);
+    } else if (hadIt) {
+      state[row->second] = Recovered;
+      --counts.susceptible;
+      ++counts.recovered;
+    }
+  }
+  return seeded;
+}
+
+// step
+//  - The frontier is every group with infected animals plus its contacts;
+//    nothing outside it can change today
+//  - Each task reads the infected counts as they were at the start of the
+//    day and writes only its own group's animals and tallies, so the
+//    frontier can be split any way without changing the outcome
+OutbreakDay OutbreakModel::step(JobSystem *jobs) {
+  ++day;
+  const int outside = static_cast<int>(infected.size()) - 1;
+  frontier.clear();
+  auto visit = [&](int g) {
+    if (seenOnDay[g] != day) {
+      seenOnDay[g] = day;
+      frontier.push_back(g);
+    }
+  };
+  for (int g : active) {
+    visit(g);
+    if (g != outside) {
+      for (int k = graph.offsets[g]; k < graph.offsets[g + 1]; ++k) {
+        visit(graph.neighbours[k]);
+      }
+    }
+  }
+
+  const SimRng rng = SimRng(params.seed).derive(day);
+  const SimRng periodRng = rng.derive(kPeriodSalt);
+  auto update = [&](std::size_t b, std::size_t e) {
+    for (std::size_t i = b; i < e; ++i) {
+      const int g = frontier[i];
+      float force = 0.0f;
+      if (g != outside && groupSize(g) > 0) {
+        force = params.withinRate * infected[g] / groupSize(g);
+        for (int k = graph.offsets[g]; k < graph.offsets[g + 1]; ++k) {
+          const int n = graph.neighbours[k];
+          if (infected[n] > 0) {
+            force += params.contactRate * graph.weight[k] * infected[n] /
+                     groupSize(n);
+          }
+        }
+      }
+      const float chance = 1.0f - std::exp(-force);
+      int fresh = 0, healed = 0;
+      for (int m = memberOffsets[g]; m < memberOffsets[g + 1]; ++m) {
+        const int row = members[m];
+        if (state[row] == Infected) {
+          if (--daysLeft[row] == 0) {
+            state[row] = Recovered;
+            ++healed;
+          }
+        } else if (state[row] == Susceptible && chance > 0.0f &&
+                   rng.uniform(animalId[row]) < chance) {
+          state[row] = Infected;
+          daysLeft[row] = drawPeriod(row, periodRng);
+          ++fresh;
+        }
+      }
+      newCases[g] = fresh;
+      recoveries[g] = healed;
+    }
+  };
+  if (jobs) {
+    jobs->parallelFor(frontier.size(), 1, update);
+  } else {
+    update(0, frontier.size());
+  }
+
+  counts.day = day;
+  counts.newCases = 0;
+  counts.frontier = static_cast<int>(frontier.size());
+  active.clear();
+  for (int g : frontier) {
+    infected[g] += newCases[g] - recoveries[g];
+    cases[g] += newCases[g];
+    counts.newCases += newCases[g];
+    counts.recovered += recoveries[g];
+    counts.infected += newCases[g] - recoveries[g];
+    if (infected[g] > 0) {
+      active.push_back(g);
+    }
+  }
+  counts.susceptible -= counts.newCases;
+  return counts;
+}
+
+std::vector<OutbreakDay> OutbreakModel::run(int days, JobSystem *jobs) {
+  std::vector<OutbreakDay> curve;
+  curve.reserve(std::max(days, 0));
+  for (int d = 0; d < days && counts.infected > 0; ++d) {
+    curve.push_back(step(jobs));
+  }
+  return curve;
+}
+
+OutbreakDay OutbreakModel::totals() const {
+  OutbreakDay now = counts;
+  now.day = day;
+  return now;
+}
@@ -0,0 +1,139 @@
+// outbreak.h
+// Declaration of OutbreakModel: what-if runs of an infectious disease
+// spreading through the zoo. Every simulated animal is Susceptible,
+// Infected or Recovered (SIR). Once a day an infected animal may pass the
+// disease on to its exhibit mates and, more weakly, to animals in exhibits
+// close by on the ZooMap; after its infectious period it recovers and is
+// immune. Runs start from the animals whose latest health check diagnosed
+// the disease.
+//
+// Exhibit contacts are a weighted graph in compressed sparse row form.
+// Each day only the frontier is visited: exhibits with infected animals
+// and their neighbours in the graph, spread over the job system. Draws are
+// keyed by seed, day and animal ID, so a scenario plays out the same on
+// any number of threads.
+//
+// A scenario works on its own copy of the animals' exhibit links and never
+// changes the Simulation.
+
+#ifndef OUTBREAK_H
+#define OUTBREAK_H
+
+#include "animalCare.h" // Health records to seed from
+#include "ecs.h"        // Animals and their exhibits
+#include "jobSystem.h"  // Parallel frontier
+#include "simRng.h"     // Infection and recovery draws
+#include "zooMap.h"     // Exhibit neighbourhoods
+#include <cstdint>      // Seeds, states
+#include <ctime>        // Diagnosis window
+#include <string>
+#include <vector>
+
+// Exhibits within walking distance of each other, in CSR form: the
+// neighbours of exhibit row r are neighbours[offsets[r] .. offsets[r + 1])
+struct ContactGraph {
+  std::vector<int> offsets{0};
+  std::vector<int> neighbours;
+  std::vector<float> weight; // Near 1 next door, towards 0 at the range
+
+  std::size_t size() const { return offsets.size() - 1; }
+
+  // Links every pair of placed exhibits whose entrances are at most
+  // 'rangeTiles' apart on foot. Entrances are bucketed by position first,
+  // so only nearby pairs are ever measured.
+  static ContactGraph fromMap(const ZooMap &map, int rangeTiles);
+};
+
+struct OutbreakParams {
+  float withinRate = 0.4f;   // Daily transmissions per infected exhibit mate
+  float contactRate = 0.1f;  // The same across a contact of weight 1
+  int rangeTiles = 12;       // Longest walk that still counts as a contact
+  int minDays = 5;           // Infectious period, drawn per animal
+  int maxDays = 9;
+  std::uint64_t seed = 1;
+};
+
+// Animal counts at the end of one day
+struct OutbreakDay {
+  int day = 0;
+  long long susceptible = 0;
+  long long infected = 0;
+  long long recovered = 0;
+  long long newCases = 0;
+  int frontier = 0; // Exhibits visited
+};
+
+class OutbreakModel {
+public:
+  enum State : std::uint8_t { Susceptible, Infected, Recovered };
+
+  // Snapshot of the World's animals and the map's contacts; everyone
+  // starts out susceptible
+  OutbreakModel(const World &world, const ZooMap &map,
+                const OutbreakParams &params, JobSystem *jobs = nullptr);
+
+  // Infects an animal (by World row) for a freshly drawn period
+  //  - Returns false if the row is out of range or not susceptible
+  bool infect(int animalRow);
+
+  // Seeds from care records: every animal whose latest health check in
+  // [since, until) has 'disease' in its diagnosis (ignoring case) is
+  // infected; one that had it earlier in the window but not at its latest
+  // check is counted as recovered. Checks come from memory and the
+  // database alike (see AnimalCareManager::diagnosesBetween).
+  //  - Returns the number of animals infected
+  int seedFromDiagnoses(const AnimalCareManager &care, Database &db,
+                        const std::string &disease, time_t since,
+                        time_t until);
+
+  // Advances one day and returns the counts at its end
+  OutbreakDay step(JobSystem *jobs = nullptr);
+
+  // Steps up to 'days' days, stopping early once nobody is infected
+  std::vector<OutbreakDay> run(int days, JobSystem *jobs = nullptr);
+
+  // Current counts (day 0 before the first step)
+  OutbreakDay totals() const;
+
+  const std::vector<std::uint8_t> &getStates() const { return state; }
+  const ContactGraph &getGraph() const { return graph; }
+
+  // Per exhibit row, plus a last entry for animals outside any exhibit:
+  // animals infected now / ever (including seeds)
+  const std::vector<int> &getInfected() const { return infected; }
+  const std::vector<int> &getCases() const { return cases; }
+
+private:
+  OutbreakParams params;
+  ContactGraph graph;
+  int day = 0;
+
+  // Per animal (World row order)
+  std::vector<int> animalId;
+  std::vector<std::uint8_t> state;
+  std::vector<std::uint8_t> daysLeft;
+
+  // Animals by group, CSR: groups are the exhibit rows plus one last group
+  // for animals outside any exhibit (who infect nobody)
+  std::vector<int> memberOffsets;
+  std::vector<int> members;
+  std::vector<int> groupOf;
+
+  // Per group
+  std::vector<int> infected;
+  std::vector<int> cases;
+  std::vector<int> newCases;  // Scratch: today's infections
+  std::vector<int> recoveries; // Scratch: today's recoveries
+  std::vector<int> seenOnDay;  // Frontier marks
+
+  std::vector<int> frontier;
+  std::vector<int> active; // Groups with infected animals
+  OutbreakDay counts;
+
+  std::size_t groupSize(int g) const {
+    return memberOffsets[g + 1] - memberOffsets[g];
+  }
+  std::uint8_t drawPeriod(int row, const SimRng &rng) const;
+};
+
+#endif // OUTBREAK_H
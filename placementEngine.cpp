@@ -0,0 +1,314 @@
+// placementEngine.cpp
+// Implements PlacementEngine: batch placement of animals into exhibits.
+//  - Animals are grouped by species so each species stays together
+//  - Groups are placed largest-first into the best-fitting compatible exhibit
+//    (first-fit-decreasing with best fit), splitting only when no single
+//    exhibit can hold the whole group
+//  - Small batches are solved exactly with a bounded branch-and-bound search
+//    that minimizes the number of exhibits touched, then leftover space
+
+#include "placementEngine.h"
+#include <algorithm> // std::sort, std::transform
+#include <cctype>    // std::tolower
+#include <iostream>  // std::cerr
+#include <iterator>  // std::prev
+#include <set>       // Ordered free-capacity index per exhibit type
+#include <utility>   // std::pair
+
+namespace {
+
+// One species within the batch
+struct SpeciesGroup {
+  std::string species;       // Normalized species name
+  std::vector<int> members;  // Indices into the batch
+  std::vector<int> exhibits; // Compatible exhibit indices
+};
+
+// Upper bound on search nodes for the exact solver before it settles for the
+// best assignment found so far
+const long kExactNodeBudget = 200000;
+
+// Branch-and-bound over whole-group assignments
+struct ExactSearch {
+  const std::vector<SpeciesGroup> &groups;
+  std::vector<int> freeCap;  // Remaining capacity per exhibit
+  std::vector<int> useCount; // Groups assigned per exhibit
+  std::vector<int> choice;   // Current exhibit per group
+  std::vector<int> best;     // Best complete assignment found
+  int bestTouched;
+  int bestLeftover;
+  long nodes = 0;
+
+  ExactSearch(const std::vector<SpeciesGroup> &g, std::vector<int> cap)
+      : groups(g), freeCap(std::move(cap)), useCount(freeCap.size(), 0),
+        choice(g.size(), -1), bestTouched(1 << 30), bestLeftover(1 << 30) {}
+
+  void run(size_t gi, int touched) {
+    if (++nodes > kExactNodeBudget || touched > bestTouched) {
+      return;
+    }
+    if (gi == groups.size()) {
+      int leftover = 0;
+      for (size_t e = 0; e < freeCap.size(); ++e) {
+        if (useCount[e] > 0) {
+          leftover += freeCap[e];
+        }
+      }
+      if (touched < bestTouched ||
+          (touched == bestTouched && leftover < bestLeftover)) {
+        bestTouched = touched;
+        bestLeftover = leftover;
+        best = choice;
+      }
+      return;
+    }
+    int size = static_cast<int>(groups[gi].members.size());
+    for (int e : groups[gi].exhibits) {
+      if (freeCap[e] < size) {
+        continue;
+      }
+      freeCap[e] -= size;
+      int nextTouched = touched + (useCount[e] == 0 ? 1 : 0);
+      ++useCount[e];
+      choice[gi] = e;
+      run(gi + 1, nextTouched);
+      --useCount[e];
+      freeCap[e] += size;
+    }
+  }
+};
+
+} // namespace
+
+// Constructor: default exact-solver limits
+PlacementEngine::PlacementEngine()
+    : exactGroupLimit(6), exactExhibitLimit(16) {}
+
+// normalize
+//  - Lowercases a species or habitat name for rule matching
+std::string PlacementEngine::normalize(const std::string &s) {
+  std::string out = s;
+  std::transform(out.begin(), out.end(), out.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return out;
+}
+
+// addHabitatRule
+//  - Allows 'species' to live in exhibits of type 'habitat'
+void PlacementEngine::addHabitatRule(const std::string &species,
+                                     const std::string &habitat) {
+  habitats[normalize(species)].insert(normalize(habitat));
+}
+
+// isCompatible
+//  - True if the species has no rules or lists this exhibit type
+bool PlacementEngine::isCompatible(const std::string &species,
+                                   const std::string &exhibitType) const {
+  auto it = habitats.find(normalize(species));
+  return it == habitats.end() || it->second.count(normalize(exhibitType)) > 0;
+}
+
+// setExactLimits
+//  - Adjusts when the exact solver is attempted; 0 disables it
+void PlacementEngine::setExactLimits(int maxGroups, int maxExhibits) {
+  exactGroupLimit = maxGroups;
+  exactExhibitLimit = maxExhibits;
+}
+
+// plan
+//  - Computes a placement for the whole batch without mutating exhibits
+PlacementPlan PlacementEngine::plan(const std::vector<Animal> &batch,
+                                    const ExhibitManager &em) const {
+  auto snap = em.snapshot();
+  const int numExhibits = static_cast<int>(snap->byIndex.size());
+
+  PlacementPlan result;
+  result.exhibitOf.assign(batch.size(), -1);
+
+  // Current free capacity and normalized type per exhibit
+  std::vector<int> freeCap(numExhibits);
+  std::vector<std::string> types(numExhibits);
+  for (int e = 0; e < numExhibits; ++e) {
+    const Exhibit &ex = *snap->byIndex[e];
+    freeCap[e] = ex.getExhibitCapacity() - ex.getAnimalCount();
+    types[e] = normalize(ex.getExhibitType());
+  }
+
+  // Group the batch by species
+  std::vector<SpeciesGroup> groups;
+  std::unordered_map<std::string, int> groupOf;
+  for (int i = 0; i < static_cast<int>(batch.size()); ++i) {
+    std::string species = normalize(batch[i].getSpecies());
+    auto it = groupOf.find(species);
+    if (it == groupOf.end()) {
+      it = groupOf.emplace(species, static_cast<int>(groups.size())).first;
+      groups.push_back({species, {}, {}});
+    }
+    groups[it->second].members.push_back(i);
+  }
+  for (auto &g : groups) {
+    auto rule = habitats.find(g.species);
+    for (int e = 0; e < numExhibits; ++e) {
+      if (freeCap[e] > 0 &&
+          (rule == habitats.end() || rule->second.count(types[e]) > 0)) {
+        g.exhibits.push_back(e);
+      }
+    }
+  }
+
+  // Largest groups first; ties broken by name for a deterministic plan
+  std::sort(groups.begin(), groups.end(),
+            [](const SpeciesGroup &a, const SpeciesGroup &b) {
+              if (a.members.size() != b.members.size())
+                return a.members.size() > b.members.size();
+              return a.species < b.species;
+            });
+
+  // Exact solver for small batches
+  if (static_cast<int>(groups.size()) <= exactGroupLimit) {
+    std::set<int> candidates;
+    for (const auto &g : groups) {
+      candidates.insert(g.exhibits.begin(), g.exhibits.end());
+    }
+    if (static_cast<int>(candidates.size()) <= exactExhibitLimit) {
+      ExactSearch search(groups, freeCap);
+      search.run(0, 0);
+      if (!search.best.empty()) {
+        for (size_t gi = 0; gi < groups.size(); ++gi) {
+          for (int member : groups[gi].members) {
+            result.exhibitOf[member] = search.best[gi];
+          }
+        }
+        result.exact = true;
+      }
+    }
+  }
+
+  // First-fit-decreasing heuristic with best fit per group
+  if (!result.exact) {
+    // Per type: ordered (free capacity, exhibit) for O(log n) best-fit queries
+    std::unordered_map<std::string, std::set<std::pair<int, int>>> byType;
+    for (int e = 0; e < numExhibits; ++e) {
+      if (freeCap[e] > 0) {
+        byType[types[e]].insert({freeCap[e], e});
+      }
+    }
+
+    auto take = [&](int e, int count) {
+      auto &bucket = byType[types[e]];
+      bucket.erase({freeCap[e], e});
+      freeCap[e] -= count;
+      if (freeCap[e] > 0) {
+        bucket.insert({freeCap[e], e});
+      }
+    };
+
+    for (const auto &g : groups) {
+      auto rule = habitats.find(g.species);
+      auto allowed = [&](const std::string &type) {
+        return rule == habitats.end() || rule->second.count(type) > 0;
+      };
+      int size = static_cast<int>(g.members.size());
+
+      // Smallest compatible exhibit that holds the whole group
+      std::pair<int, int> bestFit{-1, -1};
+      for (auto &[type, bucket] : byType) {
+        if (!allowed(type))
+          continue;
+        auto it = bucket.lower_bound({size, -1});
+        if (it != bucket.end() &&
+            (bestFit.second < 0 || it->first < bestFit.first)) {
+          bestFit = *it;
+        }
+      }
+
+      if (bestFit.second >= 0) {
+        for (int member : g.members) {
+          result.exhibitOf[member] = bestFit.second;
+        }
+        take(bestFit.second, size);
+        continue;
+      }
+
+      // No single exhibit fits: fill the roomiest compatible exhibits
+      size_t next = 0;
+      while (next < g.members.size()) {
+        std::pair<int, int> roomiest{0, -1};
+        for (auto &[type, bucket] : byType) {
+          if (!allowed(type) || bucket.empty())
+            continue;
+          const auto &top = *std::prev(bucket.end());
+          if (top.first > roomiest.first) {
+            roomiest = top;
+          }
+        }
+        if (roomiest.second < 0) {
+          break; // Nothing compatible left
+        }
+        int count = std::min<int>(roomiest.first,
+                                  static_cast<int>(g.members.size() - next));
+        for (int k = 0; k < count; ++k) {
+          result.exhibitOf[g.members[next++]] = roomiest.second;
+        }
+        take(roomiest.second, count);
+      }
+    }
+  }
+
+  // Summary counters
+  std::vector<bool> used(numExhibits, false);
+  for (int e : result.exhibitOf) {
+    if (e >= 0) {
+      ++result.placed;
+      if (!used[e]) {
+        used[e] = true;
+        ++result.exhibitsUsed;
+      }
+    }
+  }
+  return result;
+}
+
+// loadRulesFromDatabase
+//  - Loads species -> habitat pairs from the 'HabitatRules' table
+void PlacementEngine::loadRulesFromDatabase(Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const std::string sql = "SELECT species, habitat FROM HabitatRules;";
+  if (sqlite3_prepare_v2(db.get(), sql.c_str(), -1, &stmt, nullptr) !=
+      SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare HabitatRules query: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return;
+  }
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    std::string species =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    std::string habitat =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1));
+    addHabitatRule(species, habitat);
+  }
+  sqlite3_finalize(stmt);
+}
+
+// saveRuleToDatabase
+//  - Persists one species -> habitat pair
+void PlacementEngine::saveRuleToDatabase(const std::string &species,
+                                         const std::string &habitat,
+                                         Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "INSERT OR IGNORE INTO HabitatRules (species, habitat) VALUES (?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare HabitatRules insert: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return;
+  }
+  std::string s = normalize(species);
+  std::string h = normalize(habitat);
+  sqlite3_bind_text(stmt, 1, s.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_text(stmt, 2, h.c_str(), -1, SQLITE_TRANSIENT);
+  if (sqlite3_step(stmt) != SQLITE_DONE) {
+    std::cerr << "[SQL Error] " << sqlite3_errmsg(db.get()) << std::endl;
+  }
+  sqlite3_finalize(stmt);
+}
@@ -0,0 +1,63 @@
+// placementEngine.h
+// Declaration of PlacementEngine: assigns a batch of incoming animals to
+// exhibits in one pass, respecting species -> habitat rules and capacity.
+
+#ifndef PLACEMENT_ENGINE_H
+#define PLACEMENT_ENGINE_H
+
+#include "animal.h"         // Animal records being placed
+#include "database.h"       // Database wrapper for loading/saving rules
+#include "exhibitManager.h" // Current exhibits, types and free capacity
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Result of planning a batch: exhibit index per batch animal (-1 = unplaced)
+struct PlacementPlan {
+  std::vector<int> exhibitOf; // Same order as the batch passed to plan()
+  int placed = 0;             // Number of animals with an exhibit
+  int exhibitsUsed = 0;       // Distinct exhibits receiving animals
+  bool exact = false;         // True if the exact solver produced the plan
+};
+
+class PlacementEngine {
+private:
+  // Normalized species -> allowed exhibit types. Species with no entry may be
+  // placed in any exhibit.
+  std::unordered_map<std::string, std::unordered_set<std::string>> habitats;
+
+  // Batches with at most this many species groups (and few enough candidate
+  // exhibits) are solved exactly instead of heuristically
+  int exactGroupLimit;
+  int exactExhibitLimit;
+
+public:
+  // Lowercases species/type names so "Lion" and "lion" share rules (and,
+  // for the rebalancer, a type)
+  static std::string normalize(const std::string &s);
+
+  // Constructor: exact solving enabled for up to 6 groups over 16 exhibits
+  PlacementEngine();
+
+  // ——— Rules ———————————————————————————————————
+  void addHabitatRule(const std::string &species, const std::string &habitat);
+  bool isCompatible(const std::string &species,
+                    const std::string &exhibitType) const;
+
+  // Enables/disables the exact solver (0 disables it)
+  void setExactLimits(int maxGroups, int maxExhibits);
+
+  // ——— Planning ————————————————————————————————
+  // Computes an assignment for 'batch' against the exhibits' current free
+  // capacity. Does not modify any exhibit.
+  PlacementPlan plan(const std::vector<Animal> &batch,
+                     const ExhibitManager &em) const;
+
+  // ——— Database persistence ————————————————————
+  void loadRulesFromDatabase(Database &db);
+  void saveRuleToDatabase(const std::string &species,
+                          const std::string &habitat, Database &db);
+};
+
+#endif // PLACEMENT_ENGINE_H
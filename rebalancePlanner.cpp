@@ -0,0 +1,109 @@
+// rebalancePlanner.cpp
+// Implements RebalancePlanner. For each exhibit type (normalized the way
+// PlacementEngine does, so "Savanna" and "savanna" are one type):
+//  1) Targets are the capacity-proportional share of the type's animals,
+//     rounded by largest remainder so they sum exactly to the animal count
+//  2) Exhibits above target are donors, those below are receivers
+//  3) Two max-heaps pair the largest donor with the largest receiver; each
+//     pairing moves min(surplus, deficit) animals and pushes back whichever
+//     side still has work, so the cost is O(E log E) per type
+// Each plan() builds its heaps afresh from a snapshot rather than keeping
+// them up to date as animals come and go: a plan is asked for from the menu,
+// not per mutation, and O(E log E) stays well under a second at tens of
+// thousands of exhibits.
+
+#include "rebalancePlanner.h"
+#include "placementEngine.h" // Type names normalized as for placement
+#include <algorithm>         // std::min, std::sort
+#include <queue>             // std::priority_queue
+#include <string>            // std::string
+#include <unordered_map>     // Exhibits grouped by type
+#include <utility>           // std::pair
+
+// plan
+//  - Builds the move list without modifying any exhibit
+std::vector<RebalanceMove> RebalancePlanner::plan(const ExhibitManager &em) {
+  auto snap = em.snapshot();
+  const int numExhibits = static_cast<int>(snap->byIndex.size());
+
+  std::unordered_map<std::string, std::vector<int>> byType;
+  for (int e = 0; e < numExhibits; ++e) {
+    const std::string &type = snap->byIndex[e]->getExhibitType();
+    byType[PlacementEngine::normalize(type)].push_back(e);
+  }
+
+  std::vector<RebalanceMove> moves;
+  for (const auto &[type, members] : byType) {
+    long long animals = 0;
+    long long capacity = 0;
+    for (int e : members) {
+      animals += snap->byIndex[e]->getAnimalCount();
+      capacity += snap->byIndex[e]->getExhibitCapacity();
+    }
+    if (capacity == 0 || members.size() < 2) {
+      continue;
+    }
+
+    // Largest-remainder apportionment of 'animals' by capacity
+    std::vector<long long> target(members.size());
+    std::vector<std::pair<long long, size_t>> remainders;
+    long long assigned = 0;
+    for (size_t i = 0; i < members.size(); ++i) {
+      const Exhibit &ex = *snap->byIndex[members[i]];
+      long long share = animals * ex.getExhibitCapacity();
+      target[i] = share / capacity;
+      assigned += target[i];
+      remainders.push_back({share % capacity, i});
+    }
+    std::sort(remainders.begin(), remainders.end(),
+              [](const auto &a, const auto &b) {
+                if (a.first != b.first)
+                  return a.first > b.first;
+                return a.second < b.second;
+              });
+    for (long long k = 0; k < animals - assigned; ++k) {
+      ++target[remainders[k].second];
+    }
+
+    // Max-heaps of (amount, exhibit index)
+    std::priority_queue<std::pair<long long, int>> donors;
+    std::priority_queue<std::pair<long long, int>> receivers;
+    for (size_t i = 0; i < members.size(); ++i) {
+      const Exhibit &ex = *snap->byIndex[members[i]];
+      long long diff = ex.getAnimalCount() - target[i];
+      if (diff > 0) {
+        donors.push({diff, members[i]});
+      } else if (diff < 0) {
+        receivers.push({-diff, members[i]});
+      }
+    }
+
+    // Donor slot cursors: scan each donor's slots from the top down
+    std::unordered_map<int, int> cursor;
+    while (!donors.empty() && !receivers.empty()) {
+      auto [surplus, from] = donors.top();
+      donors.pop();
+      auto [deficit, to] = receivers.top();
+      receivers.pop();
+
+      long long count = std::min(surplus, deficit);
+      const Exhibit &src = *snap->byIndex[from];
+      auto cur = cursor.try_emplace(from, src.getExhibitCapacity() - 1).first;
+      for (long long k = 0; k < count; ++k) {
+        while (src.getAnimal(cur->second) == Exhibit::EMPTY_SLOT) {
+          --cur->second;
+        }
+        moves.push_back({src.getAnimal(cur->second), from, to});
+        --cur->second;
+      }
+
+      if (surplus > count) {
+        donors.push({surplus - count, from});
+      }
+      if (deficit > count) {
+        receivers.push({deficit - count, to});
+      }
+    }
+  }
+  return moves;
+}
@@ -0,0 +1,27 @@
+// rebalancePlanner.h
+// Declaration of RebalancePlanner: computes the fewest animal moves that even
+// out utilization across exhibits of the same type.
+
+#ifndef REBALANCE_PLANNER_H
+#define REBALANCE_PLANNER_H
+
+#include "exhibitManager.h" // Exhibits, their types, capacities and slots
+#include <vector>
+
+// A single relocation: move 'animalId' between exhibit indices
+struct RebalanceMove {
+  int animalId;
+  int fromExhibit;
+  int toExhibit;
+};
+
+class RebalancePlanner {
+public:
+  // Computes moves so that, within each exhibit type, every exhibit holds its
+  // capacity-proportional share of that type's animals. The number of moves
+  // equals the total surplus, which is the minimum possible. Animals never
+  // change exhibit type, so habitat rules stay satisfied.
+  static std::vector<RebalanceMove> plan(const ExhibitManager &em);
+};
+
+#endif // REBALANCE_PLANNER_H
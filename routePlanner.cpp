@@ -0,0 +1,320 @@
+// routePlanner.cpp
+// Implements RoutePlanner: distance matrix, savings construction, 2-opt /
+// Or-opt improvement and the assignment of rounds to keepers.
+
+#include "routePlanner.h"
+#include "animalCare.h" // CareType
+#include <algorithm>    // std::sort, std::nth_element, std::min_element
+#include <chrono>       // Time budget
+
+// Savings are only considered between a stop and this many of its nearest
+// stops. That keeps the savings list at n x k entries (sorting it costs
+// O(nk log nk) instead of O(n^2 log n) for every pair) without changing
+// the result on ordinary zoos. Planning as a whole stays quadratic: the
+// distance matrix has n^2 entries and finding each stop's nearest scans its
+// row, which is O(n^2) over all stops.
+static constexpr std::size_t kSavingsNeighbours = 64;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Walking distances between the kitchen (node 0) and every stop (1..n)
+struct DistanceMatrix {
+  std::size_t nodes = 0;
+  std::vector<int> tiles;
+
+  int operator()(int a, int b) const { return tiles[a * nodes + b]; }
+};
+
+struct Saving {
+  int tiles;
+  int a;
+  int b;
+};
+} // namespace
+
+std::vector<double> RoutePlanner::demandFromDue(const std::vector<DueCare> &due,
+                                                const World &world,
+                                                double rationKg) {
+  std::vector<double> demand(world.exhibits.size(), 0.0);
+  for (const DueCare &d : due) {
+    if (d.kind != CareType::Feeding) {
+      continue;
+    }
+    const int row = world.animalRow(d.animalId);
+    if (row >= 0 && world.animals.exhibit[row] >= 0) {
+      demand[world.animals.exhibit[row]] += rationKg;
+    }
+  }
+  return demand;
+}
+
+// Length of the walk kitchen -> path -> kitchen ('path' holds both ends)
+static int pathLength(const std::vector<int> &path, const DistanceMatrix &d) {
+  int tiles = 0;
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    tiles += d(path[i - 1], path[i]);
+  }
+  return tiles;
+}
+
+// twoOpt
+//  - Reverses path[i..j] whenever reconnecting its ends shortens the walk
+//    (distances are symmetric, so the inside of the segment costs the same)
+static bool twoOpt(std::vector<int> &path, const DistanceMatrix &d) {
+  const int last = static_cast<int>(path.size()) - 2; // Last stop
+  bool improved = false;
+  for (int i = 1; i < last; ++i) {
+    for (int j = i + 1; j <= last; ++j) {
+      const int delta = d(path[i - 1], path[j]) + d(path[i], path[j + 1]) -
+                        d(path[i - 1], path[i]) - d(path[j], path[j + 1]);
+      if (delta < 0) {
+        std::reverse(path.begin() + i, path.begin() + j + 1);
+        improved = true;
+      }
+    }
+  }
+  return improved;
+}
+
+// orOpt
+//  - Moves a run of 1-3 consecutive stops (either way round) to the edge
+//    where it costs least, taking the first move that shortens the walk
+static bool orOpt(std::vector<int> &path, const DistanceMatrix &d) {
+  const int stops = static_cast<int>(path.size()) - 2;
+  for (int len = 1; len <= 3; ++len) {
+    for (int i = 1; i + len - 1 <= stops; ++i) {
+      const int a = path[i - 1], s = path[i], e = path[i + len - 1],
+                b = path[i + len];
+      const int gain = d(a, s) + d(e, b) - d(a, b);
+      if (gain <= 0) {
+        continue;
+      }
+      for (int k = 0; k <= stops; ++k) { // Edge path[k] -> path[k + 1]
+        if (k >= i - 1 && k <= i + len - 1) {
+          continue;
+        }
+        const int x = path[k], y = path[k + 1];
+        const int forward = d(x, s) + d(e, y) - d(x, y);
+        const int backward = d(x, e) + d(s, y) - d(x, y);
+        if (std::min(forward, backward) >= gain) {
+          continue;
+        }
+        std::vector<int> run(path.begin() + i, path.begin() + i + len);
+        if (backward < forward) {
+          std::reverse(run.begin(), run.end());
+        }
+        path.erase(path.begin() + i, path.begin() + i + len);
+        const int at = k < i ? k + 1 : k + 1 - len;
+        path.insert(path.begin() + at, run.begin(), run.end());
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// plan
+//  - Savings: start with one round per stop, then join round ends in order
+//    of the distance saved, d(0,a) + d(0,b) - d(a,b), while the cart holds
+//  - Improvement runs per round (rounds are independent), spread over the
+//    job system, until a pass finds nothing or the budget is spent
+//  - Rounds go longest first to the keeper who has walked least so far
+RoutePlan RoutePlanner::plan(const ZooMap &map,
+                             const std::vector<double> &demandKg,
+                             const RoutePlanOptions &options,
+                             JobSystem *jobs) {
+  const auto started = Clock::now();
+  const auto deadline =
+      started + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::milli>(
+                        std::max(0.0, options.budgetMs)));
+  RoutePlan result;
+  result.keepers.resize(std::max(1, options.keepers));
+  const double cart = options.cartKg > 0.0 ? options.cartKg : 1.0;
+
+  // Stops: node i (1..n) visits exhibit stopExhibit[i] with stopKg[i]
+  map.prepare(jobs);
+  std::vector<int> stopExhibit{-1};
+  std::vector<double> stopKg{0.0};
+  for (std::size_t row = 0; row < demandKg.size(); ++row) {
+    double kg = demandKg[row];
+    if (kg <= 0.0) {
+      continue;
+    }
+    if (map.distance(-1, static_cast<int>(row)) == ZooMap::UNREACHABLE) {
+      result.unreachable.push_back(static_cast<int>(row));
+      continue;
+    }
+    for (; kg > 0.0; kg -= cart) {
+      stopExhibit.push_back(static_cast<int>(row));
+      stopKg.push_back(std::min(kg, cart));
+    }
+  }
+  const std::size_t nodes = stopExhibit.size();
+  if (nodes == 1) {
+    result.milliseconds =
+        std::chrono::duration<double, std::milli>(Clock::now() - started)
+            .count();
+    return result;
+  }
+
+  DistanceMatrix d;
+  d.nodes = nodes;
+  d.tiles.resize(nodes * nodes);
+  auto fillRows = [&](std::size_t b, std::size_t e) {
+    for (std::size_t i = b; i < e; ++i) {
+      for (std::size_t j = 0; j < nodes; ++j) {
+        // Walks are symmetric; the kitchen only works as a 'from'
+        d.tiles[i * nodes + j] =
+            j == 0 ? map.distance(-1, stopExhibit[i])
+                   : map.distance(stopExhibit[i], stopExhibit[j]);
+      }
+    }
+  };
+  if (jobs) {
+    jobs->parallelFor(nodes, 16, fillRows);
+  } else {
+    fillRows(0, nodes);
+  }
+
+  // ===== Savings construction =====
+  std::vector<Saving> savings;
+  std::vector<int> near;
+  for (int a = 1; a < static_cast<int>(nodes); ++a) {
+    near.clear();
+    for (int b = 1; b < static_cast<int>(nodes); ++b) {
+      if (b != a) {
+        near.push_back(b);
+      }
+    }
+    // Selection is linear in the row; only the kept stops are sorted. Ties
+    // go to the lower node, so the order is total and the pick is the same
+    // as a full sort's.
+    const std::size_t keep = std::min(near.size(), kSavingsNeighbours);
+    if (keep == 0) {
+      continue;
+    }
+    auto closer = [&](int x, int y) {
+      return d(a, x) != d(a, y) ? d(a, x) < d(a, y) : x < y;
+    };
+    std::nth_element(near.begin(), near.begin() + keep - 1, near.end(),
+                     closer);
+    std::sort(near.begin(), near.begin() + keep, closer);
+    for (std::size_t k = 0; k < keep; ++k) {
+      const int b = near[k];
+      const int saved = d(0, a) + d(0, b) - d(a, b);
+      if (saved > 0) {
+        savings.push_back({saved, std::min(a, b), std::max(a, b)});
+      }
+    }
+  }
+  std::sort(savings.begin(), savings.end(),
+            [](const Saving &x, const Saving &y) {
+              if (x.tiles != y.tiles) {
+                return x.tiles > y.tiles;
+              }
+              return x.a != y.a ? x.a < y.a : x.b < y.b;
+            });
+  savings.erase(std::unique(savings.begin(), savings.end(),
+                            [](const Saving &x, const Saving &y) {
+                              return x.a == y.a && x.b == y.b;
+                            }),
+                savings.end());
+
+  std::vector<std::vector<int>> rounds(nodes);
+  std::vector<double> load(nodes, 0.0);
+  std::vector<int> roundOf(nodes);
+  for (std::size_t i = 1; i < nodes; ++i) {
+    rounds[i] = {static_cast<int>(i)};
+    load[i] = stopKg[i];
+    roundOf[i] = static_cast<int>(i);
+  }
+  for (const Saving &s : savings) {
+    int ra = roundOf[s.a], rb = roundOf[s.b];
+    if (ra == rb || load[ra] + load[rb] > cart + 1e-9) {
+      continue;
+    }
+    // Join so that 'a' ends round ra and 'b' starts round rb
+    std::vector<int> &x = rounds[ra];
+    std::vector<int> &y = rounds[rb];
+    if (x.back() != s.a) {
+      if (x.front() != s.a) {
+        continue; // Inside its round: cannot be joined
+      }
+      std::reverse(x.begin(), x.end());
+    }
+    if (y.front() != s.b) {
+      if (y.back() != s.b) {
+        continue;
+      }
+      std::reverse(y.begin(), y.end());
+    }
+    for (int node : y) {
+      roundOf[node] = ra;
+    }
+    x.insert(x.end(), y.begin(), y.end());
+    y.clear();
+    load[ra] += load[rb];
+  }
+
+  // ===== Improvement =====
+  std::vector<std::vector<int>> paths; // Kitchen, stops..., kitchen
+  std::vector<double> pathKg;
+  for (std::size_t r = 1; r < nodes; ++r) {
+    if (!rounds[r].empty()) {
+      std::vector<int> path{0};
+      path.insert(path.end(), rounds[r].begin(), rounds[r].end());
+      path.push_back(0);
+      paths.push_back(std::move(path));
+      pathKg.push_back(load[r]);
+    }
+  }
+  auto improve = [&](std::size_t b, std::size_t e) {
+    for (std::size_t r = b; r < e; ++r) {
+      while (Clock::now() < deadline) {
+        const bool shorter = twoOpt(paths[r], d);
+        if (!orOpt(paths[r], d) && !shorter) {
+          break;
+        }
+      }
+    }
+  };
+  if (jobs) {
+    jobs->parallelFor(paths.size(), 1, improve);
+  } else {
+    improve(0, paths.size());
+  }
+
+  // ===== Assignment =====
+  std::vector<int> lengths(paths.size());
+  std::vector<std::size_t> order(paths.size());
+  for (std::size_t r = 0; r < paths.size(); ++r) {
+    lengths[r] = pathLength(paths[r], d);
+    order[r] = r;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t x, std::size_t y) {
+                     return lengths[x] > lengths[y];
+                   });
+  for (std::size_t r : order) {
+    auto keeper = std::min_element(
+        result.keepers.begin(), result.keepers.end(),
+        [](const KeeperPlan &x, const KeeperPlan &y) {
+          return x.tiles < y.tiles;
+        });
+    KeeperRound round;
+    round.kg = pathKg[r];
+    round.tiles = lengths[r];
+    for (std::size_t i = 1; i + 1 < paths[r].size(); ++i) {
+      round.exhibits.push_back(stopExhibit[paths[r][i]]);
+    }
+    keeper->tiles += round.tiles;
+    keeper->rounds.push_back(std::move(round));
+    result.tiles += lengths[r];
+  }
+  result.milliseconds =
+      std::chrono::duration<double, std::milli>(Clock::now() - started)
+          .count();
+  return result;
+}
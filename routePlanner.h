@@ -0,0 +1,62 @@
+// routePlanner.h
+// Declaration of RoutePlanner: turns the feedings that are due into rounds
+// for a team of keepers. Every round starts and ends at the food kitchen by
+// the gate and carries at most one cart load; each keeper gets an ordered
+// list of rounds, and rounds are spread so the keepers walk about equally.
+//
+// This is a capacitated vehicle routing problem. Rounds are built with the
+// Clarke-Wright savings heuristic on walking distances from the ZooMap,
+// then shortened with 2-opt and Or-opt moves, rounds in parallel, until
+// nothing improves or the time budget runs out.
+
+#ifndef ROUTE_PLANNER_H
+#define ROUTE_PLANNER_H
+
+#include "careScheduler.h" // DueCare
+#include "ecs.h"           // Animal -> exhibit rows
+#include "jobSystem.h"     // Parallel improvement
+#include "zooMap.h"        // Walking distances
+#include <vector>
+
+struct RoutePlanOptions {
+  int keepers = 3;
+  double cartKg = 200.0;  // Food one round can carry
+  double budgetMs = 50.0; // Time allowed for improvement
+};
+
+// One trip from the kitchen and back: exhibit rows in visiting order
+struct KeeperRound {
+  std::vector<int> exhibits;
+  double kg = 0.0;
+  int tiles = 0; // Walking distance, kitchen to kitchen
+};
+
+struct KeeperPlan {
+  std::vector<KeeperRound> rounds;
+  int tiles = 0;
+};
+
+struct RoutePlan {
+  std::vector<KeeperPlan> keepers;
+  std::vector<int> unreachable; // Exhibits with food due but no path
+  long long tiles = 0;          // Total over all keepers
+  double milliseconds = 0.0;    // Planning time
+};
+
+class RoutePlanner {
+public:
+  // Food due per exhibit row: 'rationKg' for every due feeding of an animal
+  // housed in a simulated exhibit
+  static std::vector<double> demandFromDue(const std::vector<DueCare> &due,
+                                           const World &world,
+                                           double rationKg);
+
+  // Plans rounds for 'demandKg' (indexed by exhibit row; 0 = no visit).
+  // An exhibit needing more than a cart load is visited more than once.
+  static RoutePlan plan(const ZooMap &map,
+                        const std::vector<double> &demandKg,
+                        const RoutePlanOptions &options,
+                        JobSystem *jobs = nullptr);
+};
+
+#endif // ROUTE_PLANNER_H
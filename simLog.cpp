@@ -0,0 +1,194 @@
+// simLog.cpp
+// Implements the text form of SimCommand and the input-log and state
+// headers.
+
+#include "simLog.h"
+#include <iomanip> // std::quoted, std::setprecision
+#include <limits>  // Round-trip precision
+#include <sstream> // Line parsing
+#include <utility> // std::pair
+
+static constexpr const char *kLogMagic = "zoo-sim-log";
+static constexpr int kLogVersion = 3; // 2: visitors, 3: zoo map
+static constexpr const char *kStateMagic = "zoo-sim-state";
+
+// Verb for each SimCommand::Type, in enum order
+static const std::pair<SimCommand::Type, const char *> kVerbs[] = {
+    {SimCommand::Type::AddExhibit, "exhibit"},
+    {SimCommand::Type::RemoveExhibit, "remove-exhibit"},
+    {SimCommand::Type::AddAnimal, "animal"},
+    {SimCommand::Type::RemoveAnimal, "remove-animal"},
+    {SimCommand::Type::MoveAnimal, "move"},
+    {SimCommand::Type::SetAnimal, "animal-state"},
+    {SimCommand::Type::SetExhibit, "exhibit-state"},
+    {SimCommand::Type::Feed, "feed"},
+    {SimCommand::Type::Clean, "clean"},
+    {SimCommand::Type::SetTraffic, "traffic"},
+    {SimCommand::Type::SetCrowd, "crowd"},
+    {SimCommand::Type::AddVisitor, "visitor"},
+    {SimCommand::Type::MapSize, "map-size"},
+    {SimCommand::Type::SetTile, "tile"},
+    {SimCommand::Type::PlaceExhibit, "place"},
+    {SimCommand::Type::Advance, "advance"},
+    {SimCommand::Type::End, "end"}};
+
+// Arguments each command carries
+struct Shape {
+  bool animal;  // animalId
+  bool exhibit; // Quoted exhibit name
+  int values;   // Leading entries of value[]
+};
+
+static Shape shapeOf(SimCommand::Type type) {
+  using T = SimCommand::Type;
+  switch (type) {
+  case T::AddExhibit:
+    return {false, true, 2};
+  case T::RemoveExhibit:
+  case T::Clean:
+    return {false, true, 0};
+  case T::AddAnimal:
+    return {true, true, 1};
+  case T::RemoveAnimal:
+    return {true, false, 0};
+  case T::MoveAnimal:
+    return {true, true, 0};
+  case T::SetAnimal:
+    return {true, false, 4};
+  case T::SetExhibit:
+    return {false, true, 1};
+  case T::Feed:
+    return {true, false, 1};
+  case T::SetTraffic:
+  case T::PlaceExhibit:
+    return {false, true, 4};
+  case T::MapSize:
+    return {false, false, 2};
+  case T::SetTile:
+    return {false, false, 3};
+  case T::SetCrowd:
+  case T::AddVisitor:
+    return {false, false, 6};
+  case T::Advance:
+    return {false, false, 1};
+  case T::End:
+    break;
+  }
+  return {false, false, 0};
+}
+
+void writeSimHeader(std::ostream &out, const SimLogHeader &h) {
+  out << kLogMagic << ' ' << kLogVersion << ' ' << h.seed << ' '
+      << static_cast<long long>(h.startTime) << ' ' << h.tick << ' '
+      << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << h.pendingHours << '\n';
+}
+
+void writeSimStateHeader(std::ostream &out, const SimLogHeader &h) {
+  out << kStateMagic << ' ' << SIM_STATE_VERSION << ' ' << h.seed << ' '
+      << static_cast<long long>(h.startTime) << ' ' << h.tick << ' '
+      << std::setprecision(std::numeric_limits<double>::max_digits10)
+      << h.pendingHours << '\n';
+}
+
+// Reads "<magic> <version> <seed> <start> <tick> <pendingHours>"
+static bool parseHeaderFields(const std::string &line, std::string &magic,
+                              int &version, SimLogHeader &h) {
+  std::istringstream in(line);
+  long long start = 0;
+  if (!(in >> magic >> version >> h.seed >> start >> h.tick >>
+        h.pendingHours)) {
+    return false;
+  }
+  h.startTime = static_cast<time_t>(start);
+  return true;
+}
+
+bool parseSimHeader(const std::string &line, SimLogHeader &h) {
+  std::string magic;
+  int version = 0;
+  return parseHeaderFields(line, magic, version, h) && magic == kLogMagic &&
+         version == kLogVersion;
+}
+
+// parseSimStateHeader
+//  - Input logs of every version hold a snapshot in state lines, so one
+//    saved as a base reads as state version 0
+bool parseSimStateHeader(const std::string &line, SimLogHeader &h,
+                         int &version) {
+  std::string magic;
+  if (!parseHeaderFields(line, magic, version, h)) {
+    return false;
+  }
+  if (magic == kLogMagic) {
+    const bool known = version >= 1 && version <= kLogVersion;
+    version = 0;
+    return known;
+  }
+  return magic == kStateMagic && version >= 1 &&
+         version <= SIM_STATE_VERSION;
+}
+
+// writeSimCommand
+//  - max_digits10 makes every double (and every float widened to one) read
+//    back to the identical value
+void writeSimCommand(std::ostream &out, const SimCommand &c) {
+  const Shape shape = shapeOf(c.type);
+  out << c.tick << ' ' << kVerbs[static_cast<int>(c.type)].second;
+  if (shape.animal) {
+    out << ' ' << c.animalId;
+  }
+  if (shape.exhibit) {
+    out << ' ' << std::quoted(c.exhibit);
+  }
+  out << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (int i = 0; i < shape.values; ++i) {
+    out << ' ' << c.value[i];
+  }
+  out << '\n';
+}
+
+// parseSimCommand
+//  - Defaults for values missing from lenient lines are 0, except an
+//    exhibit's appeal (added in log version 2), which is neutral at 1
+bool parseSimCommand(const std::string &line, SimCommand &c, bool lenient) {
+  std::istringstream in(line);
+  std::string verb;
+  if (!(in >> c.tick >> verb)) {
+    return false;
+  }
+  bool known = false;
+  for (const auto &[type, name] : kVerbs) {
+    if (verb == name) {
+      c.type = type;
+      known = true;
+      break;
+    }
+  }
+  if (!known) {
+    return false;
+  }
+  const Shape shape = shapeOf(c.type);
+  c.animalId = 0;
+  c.exhibit.clear();
+  if (shape.animal && !(in >> c.animalId)) {
+    return false;
+  }
+  if (shape.exhibit && !(in >> std::quoted(c.exhibit))) {
+    return false;
+  }
+  for (double &v : c.value) {
+    v = 0.0;
+  }
+  if (c.type == SimCommand::Type::AddExhibit) {
+    c.value[1] = 1.0;
+  }
+  for (int i = 0; i < shape.values; ++i) {
+    double v = 0.0;
+    if (!(in >> v)) {
+      return lenient && in.eof(); // Failed only for lack of values
+    }
+    c.value[i] = v;
+  }
+  return true;
+}
@@ -0,0 +1,81 @@
+// simLog.h
+// Declaration of SimCommand, one input to the Simulation (an animal added,
+// fed or moved, an exhibit cleaned, time advanced, ...) or one piece of a
+// snapshot of its state, and its text form
+// in a replayable input log. Every line is "<tick> <verb> <arguments>";
+// names are quoted and numbers are written with enough digits to read back
+// bit for bit.
+
+#ifndef SIM_LOG_H
+#define SIM_LOG_H
+
+#include <cstdint> // Seed
+#include <ctime>   // Start time
+#include <iosfwd>  // std::istream, std::ostream
+#include <string>  // Exhibit names
+
+struct SimCommand {
+  enum class Type {
+    AddExhibit,    // exhibit, value = capacity, appeal
+    RemoveExhibit, // exhibit
+    AddAnimal,     // animalId, exhibit ("" = none), value[0] = age in days
+    RemoveAnimal,  // animalId
+    MoveAnimal,    // animalId, exhibit ("" = none)
+    SetAnimal,     // animalId, value = hunger, health, happiness, age
+    SetExhibit,    // exhibit, value[0] = cleanliness
+    Feed,          // animalId, value[0] = kg
+    Clean,         // exhibit
+    SetTraffic,    // exhibit, value = popularity, visits today/total, wait
+    SetCrowd,      // value = VisitorEconomy fields in declaration order
+    AddVisitor,    // value = id, exhibit row, state, timer, satisfaction,
+                   //         stops * 256 + plan
+    MapSize,       // value = width, height (grow only)
+    SetTile,       // value = x, y, blocked (0/1)
+    PlaceExhibit,  // exhibit, value = x, y, w, h of its plot
+    Advance,       // value[0] = hours
+    End            // Last tick of the recording
+  };
+
+  long long tick = 0; // Simulation tick the command was applied at
+  Type type = Type::End;
+  int animalId = 0;
+  std::string exhibit;
+  double value[6] = {};
+};
+
+// First line of a log or state snapshot: where the recording starts
+struct SimLogHeader {
+  std::uint64_t seed = 0;
+  time_t startTime = 0;
+  long long tick = 0;
+  double pendingHours = 0.0;
+};
+
+// Version of the state format, the one saved bases are written in. Unlike
+// the input-log format (which only this build's replay has to read), every
+// later build reads every earlier state version:
+//  - Lines may only gain values at the end, and a value missing from an
+//    older line reads as its default
+//  - Verbs are only ever added
+// Bump it whenever the state lines change.
+constexpr int SIM_STATE_VERSION = 1;
+
+// Writes one line (including the newline)
+void writeSimHeader(std::ostream &out, const SimLogHeader &header);
+void writeSimStateHeader(std::ostream &out, const SimLogHeader &header);
+void writeSimCommand(std::ostream &out, const SimCommand &command);
+
+// Parses one line (without the newline)
+//  - Returns false if the line is malformed
+//  - parseSimStateHeader also reads bases saved as input logs before the
+//    state format existed; 'version' receives the state version (0 for
+//    those), and newer versions than this build's are rejected
+//  - lenient: values missing at the end of the line get their defaults (for
+//    state lines of older versions)
+bool parseSimHeader(const std::string &line, SimLogHeader &header);
+bool parseSimStateHeader(const std::string &line, SimLogHeader &header,
+                         int &version);
+bool parseSimCommand(const std::string &line, SimCommand &command,
+                     bool lenient = false);
+
+#endif // SIM_LOG_H
@@ -0,0 +1,39 @@
+// simRng.h
+// Declaration of SimRng, the counter-based random streams the simulation
+// draws from. Draws are a pure function of a stream key and an entity key
+// (e.g. an animal or visitor ID), so they come out the same whatever row the
+// entity is in and whichever thread runs it.
+
+#ifndef SIM_RNG_H
+#define SIM_RNG_H
+
+#include <cstdint> // Keys
+
+// SplitMix64 finaliser: a cheap, well-mixed 64-bit hash
+inline std::uint64_t mix64(std::uint64_t z) {
+  z += 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+class SimRng {
+public:
+  explicit SimRng(std::uint64_t key) : key(key) {}
+
+  // Uniform in [0, 1)
+  float uniform(std::uint64_t entity) const {
+    // Top 24 bits -> exactly representable float in [0, 1)
+    return static_cast<float>(mix64(key ^ mix64(entity)) >> 40) * 0x1.0p-24f;
+  }
+
+  // An independent stream, e.g. one per purpose or per sub-step
+  SimRng derive(std::uint64_t salt) const {
+    return SimRng(mix64(key ^ mix64(salt)));
+  }
+
+private:
+  std::uint64_t key;
+};
+
+#endif // SIM_RNG_H
@@ -0,0 +1,898 @@
+// simulation.cpp
+// Implements Simulation and its built-in systems. Each system is a tight
+// loop over a row range of the World's dense component arrays; an animal's
+// exhibit components are reached through its exhibit row.
+
+#include "simulation.h"
+#include <algorithm>     // std::min, std::max, std::clamp
+#include <iostream>      // std::cerr for database errors
+#include <sstream>       // Save chain blobs
+#include <unordered_set> // IDs/names still present in the managers
+
+// ===== Tuning (per simulated hour unless noted) =====
+static constexpr float kHungerPerHour = 1.0f / 48.0f; // Starving in 2 days
+static constexpr float kHungerPerKg = 0.1f;           // 10 kg = full meal
+static constexpr float kSoilAtCapacity = 0.02f;       // Full exhibit
+static constexpr float kStarvingHunger = 0.75f;
+static constexpr float kDirtyExhibit = 0.3f;
+static constexpr float kStarvationDamage = 0.01f;
+static constexpr float kDirtDamage = 0.004f;
+static constexpr float kRecovery = 0.002f;
+static constexpr float kMoodRate = 0.1f; // Fraction of the gap closed
+static constexpr float kMoodSwing = 0.1f; // Random spread of the mood target
+
+// Rows per stealable chunk: big enough to amortise scheduling, small enough
+// that a few hundred thousand animals still spread over 16+ workers
+static constexpr std::size_t kChunkRows = 4096;
+
+// ===== Systems =====
+// environmentSystem
+//  - Exhibits get dirtier in proportion to how full they are
+static void environmentSystem(World &w, const SimTick &t, std::size_t begin,
+                              std::size_t end) {
+  const float dt = t.dtHours;
+  ExhibitTable &ex = w.exhibits;
+  for (std::size_t i = begin; i < end; ++i) {
+    float load = static_cast<float>(ex.occupancy[i]) /
+                 static_cast<float>(std::max(1, ex.capacity[i]));
+    ex.cleanliness[i] = std::max(0.0f, ex.cleanliness[i] -
+                                           kSoilAtCapacity * load * dt);
+  }
+}
+
+static void hungerSystem(World &w, const SimTick &t, std::size_t begin,
+                         std::size_t end) {
+  const float dt = t.dtHours;
+  float *hunger = w.animals.hunger.data();
+  for (std::size_t i = begin; i < end; ++i) {
+    hunger[i] = std::min(1.0f, hunger[i] + kHungerPerHour * dt);
+  }
+}
+
+// healthSystem
+//  - Starvation and filthy exhibits do damage; otherwise animals recover
+static void healthSystem(World &w, const SimTick &t, std::size_t begin,
+                         std::size_t end) {
+  const float dt = t.dtHours;
+  AnimalTable &a = w.animals;
+  const float *clean = w.exhibits.cleanliness.data();
+  for (std::size_t i = begin; i < end; ++i) {
+    float delta = kRecovery;
+    if (a.hunger[i] > kStarvingHunger) {
+      delta = -kStarvationDamage;
+    } else if (a.exhibit[i] >= 0 && clean[a.exhibit[i]] < kDirtyExhibit) {
+      delta = -kDirtDamage;
+    }
+    a.health[i] = std::clamp(a.health[i] + delta * dt, 0.0f, 1.0f);
+  }
+}
+
+// happinessSystem
+//  - Mood drifts toward a target set by being fed, healthy, and housed in a
+//    clean exhibit that is not over capacity, plus a small random swing
+static void happinessSystem(World &w, const SimTick &t, std::size_t begin,
+                            std::size_t end) {
+  const float dt = t.dtHours;
+  AnimalTable &a = w.animals;
+  const ExhibitTable &ex = w.exhibits;
+  const float step = std::min(1.0f, kMoodRate * dt);
+  for (std::size_t i = begin; i < end; ++i) {
+    float housing = 0.0f;
+    const int e = a.exhibit[i];
+    if (e >= 0) {
+      housing = ex.cleanliness[e];
+      if (ex.occupancy[e] > ex.capacity[e]) {
+        housing *= 0.5f;
+      }
+    }
+    const float swing =
+        kMoodSwing * (t.rng.uniform(static_cast<std::uint32_t>(a.animalId[i])) -
+                      0.5f);
+    float target = 0.5f * (1.0f - a.hunger[i]) + 0.3f * a.health[i] +
+                   0.2f * housing + swing;
+    a.happiness[i] = std::clamp(
+        a.happiness[i] + (target - a.happiness[i]) * step, 0.0f, 1.0f);
+  }
+}
+
+static void agingSystem(World &w, const SimTick &t, std::size_t begin,
+                        std::size_t end) {
+  const float dt = t.dtHours;
+  float *age = w.animals.ageDays.data();
+  const float days = dt / 24.0f;
+  for (std::size_t i = begin; i < end; ++i) {
+    age[i] += days;
+  }
+}
+
+// ===== Simulation =====
+Simulation::Simulation() {
+  using D = SimSystem::Domain;
+  addSystem({"environment", D::Exhibits, COMP_HOUSING, COMP_CLEANLINESS,
+             environmentSystem});
+  addSystem({"hunger", D::Animals, 0, COMP_HUNGER, hungerSystem});
+  addSystem({"health", D::Animals,
+             COMP_HUNGER | COMP_CLEANLINESS | COMP_HOUSING, COMP_HEALTH,
+             healthSystem});
+  addSystem({"happiness", D::Animals,
+             COMP_HUNGER | COMP_HEALTH | COMP_CLEANLINESS | COMP_HOUSING,
+             COMP_HAPPINESS, happinessSystem});
+  addSystem({"aging", D::Animals, 0, COMP_AGE, agingSystem});
+}
+
+// addSystem
+//  - A system's stage is one past the latest stage of any earlier system it
+//    conflicts with, which keeps registration-order semantics while letting
+//    independent systems (environment, hunger, aging) share stage 0
+void Simulation::addSystem(const SimSystem &system) {
+  std::size_t stage = 0;
+  for (std::size_t s = 0; s < stages.size(); ++s) {
+    for (std::size_t i : stages[s]) {
+      const SimSystem &prior = systems[i];
+      if ((prior.writes & (system.reads | system.writes)) ||
+          (prior.reads & system.writes)) {
+        stage = s + 1;
+      }
+    }
+  }
+  systems.push_back(system);
+  if (stage == stages.size()) {
+    stages.emplace_back();
+  }
+  stages[stage].push_back(systems.size() - 1);
+}
+
+Simulation::~Simulation() { stopRecording(); }
+
+// sync
+//  - Destruction walks rows from the back, so swap-remove never moves a row
+//    that has not been checked yet
+//  - Every change goes through apply() so a recording sees it
+void Simulation::sync(const AnimalManager &am, const ExhibitManager &em) {
+  using T = SimCommand::Type;
+  auto snap = em.snapshot();
+  std::unordered_set<std::string> exhibitNames;
+  for (const Exhibit *ex : snap->byIndex) {
+    exhibitNames.insert(ex->getExhibitName());
+    if (world.exhibitRow(ex->getExhibitName()) < 0) {
+      SimCommand c{.type = T::AddExhibit, .exhibit = ex->getExhibitName()};
+      c.value[0] = ex->getExhibitCapacity();
+      c.value[1] = VisitorCrowd::typeAppeal(ex->getExhibitType());
+      apply(std::move(c));
+    }
+  }
+  for (int row = static_cast<int>(world.exhibits.size()) - 1; row >= 0;
+       --row) {
+    if (!exhibitNames.count(world.exhibits.name[row])) {
+      apply({.type = T::RemoveExhibit, .exhibit = world.exhibits.name[row]});
+    }
+  }
+
+  // Plots for new exhibits (and any left unplaced by an older save)
+  for (std::size_t row = 0; row < world.exhibits.size(); ++row) {
+    if (map.getPlot(static_cast<int>(row)).placed()) {
+      continue;
+    }
+    const int side = ZooMap::plotSide(world.exhibits.capacity[row]);
+    ExhibitPlot plot = map.findFreePlot(side, side);
+    while (!plot.placed() && (map.getWidth() < ZooMap::MAX_SIDE ||
+                              map.getHeight() < ZooMap::MAX_SIDE)) {
+      SimCommand c{.type = T::MapSize};
+      c.value[0] = std::min(map.getWidth() * 2, ZooMap::MAX_SIDE);
+      c.value[1] = std::min(map.getHeight() * 2, ZooMap::MAX_SIDE);
+      apply(std::move(c));
+      plot = map.findFreePlot(side, side);
+    }
+    if (plot.placed()) { // Else the map is full: it stays off the map
+      placeExhibit(world.exhibits.name[row], plot);
+    }
+  }
+
+  std::unordered_set<int> animalIds;
+  animalIds.reserve(am.animals.size());
+  for (const Animal &a : am.animals) {
+    animalIds.insert(a.getId());
+    const int exRow = world.exhibitRow(a.getExhibit());
+    const std::string exName = exRow < 0 ? "" : a.getExhibit();
+    const int row = world.animalRow(a.getId());
+    if (row < 0) {
+      SimCommand c{.type = T::AddAnimal, .animalId = a.getId(),
+                   .exhibit = exName};
+      c.value[0] = a.getAge() * 365.0f;
+      apply(std::move(c));
+    } else if (world.animals.exhibit[row] != exRow) {
+      apply({.type = T::MoveAnimal, .animalId = a.getId(), .exhibit = exName});
+    }
+  }
+  for (int row = static_cast<int>(world.animals.size()) - 1; row >= 0;
+       --row) {
+    if (!animalIds.count(world.animals.animalId[row])) {
+      apply({.type = T::RemoveAnimal, .animalId = world.animals.animalId[row]});
+    }
+  }
+}
+
+// Arguments a system chunk needs, passed to JobSystem as the task context
+namespace {
+struct SystemCall {
+  const SimSystem *system;
+  World *world;
+  SimTick tick;
+};
+} // namespace
+
+static void runSystemRange(const void *ctx, std::size_t begin,
+                           std::size_t end) {
+  const auto *call = static_cast<const SystemCall *>(ctx);
+  call->system->run(*call->world, call->tick, begin, end);
+}
+
+// step
+//  - Each stage is one JobSystem batch: every system in it contributes its
+//    row range, and chunks of all of them are stolen from the same deques
+//  - A system's stream is keyed by (seed, system index, tick); the crowd
+//    uses index 0, which no system has
+void Simulation::step() {
+  const float dt = static_cast<float>(TICK_HOURS);
+  std::vector<SystemCall> calls;
+  std::vector<RangeTask> tasks;
+  for (const auto &stage : stages) {
+    calls.clear();
+    tasks.clear();
+    for (std::size_t i : stage) {
+      const std::uint64_t stream =
+          mix64(seed ^ mix64(i + 1) ^ mix64(static_cast<std::uint64_t>(tick)));
+      calls.push_back({&systems[i], &world, {dt, tick, SimRng(stream)}});
+    }
+    for (const SystemCall &call : calls) {
+      const std::size_t rows = call.system->domain == SimSystem::Domain::Animals
+                                   ? world.animals.size()
+                                   : world.exhibits.size();
+      tasks.push_back({runSystemRange, &call, rows});
+    }
+    if (jobs) {
+      jobs->run(tasks.data(), tasks.size(), kChunkRows);
+    } else {
+      for (const RangeTask &task : tasks) {
+        task.run(task.ctx, 0, task.count);
+      }
+    }
+  }
+  const std::uint64_t crowdStream = seed ^ mix64(0);
+  map.prepare(jobs); // No-op unless the map changed
+  crowd.update(world, map, getHourOfDay(),
+               SimRng(mix64(crowdStream ^ mix64(static_cast<std::uint64_t>(
+                                                tick)))),
+               SimRng(mix64(crowdStream)), jobs);
+  ++tick;
+}
+
+// runTicks
+//  - Classic fixed-timestep accumulator: leftover time carries to the next
+//    call, so results do not depend on how the time is sliced
+int Simulation::runTicks(double hours) {
+  pendingHours += hours;
+  int ran = 0;
+  while (pendingHours >= TICK_HOURS) {
+    step();
+    pendingHours -= TICK_HOURS;
+    ++ran;
+  }
+  return ran;
+}
+
+int Simulation::advance(double hours) {
+  const long long before = tick;
+  SimCommand c{.type = SimCommand::Type::Advance};
+  c.value[0] = hours;
+  apply(std::move(c));
+  return static_cast<int>(tick - before);
+}
+
+bool Simulation::feed(int animalId, double kg) {
+  SimCommand c{.type = SimCommand::Type::Feed, .animalId = animalId};
+  c.value[0] = kg;
+  return apply(std::move(c));
+}
+
+bool Simulation::cleanExhibit(const std::string &name) {
+  return apply({.type = SimCommand::Type::Clean, .exhibit = name});
+}
+
+bool Simulation::placeExhibit(const std::string &name,
+                              const ExhibitPlot &plot) {
+  SimCommand c{.type = SimCommand::Type::PlaceExhibit, .exhibit = name};
+  c.value[0] = plot.x;
+  c.value[1] = plot.y;
+  c.value[2] = plot.w;
+  c.value[3] = plot.h;
+  return apply(std::move(c));
+}
+
+bool Simulation::setTileBlocked(int x, int y, bool blocked) {
+  SimCommand c{.type = SimCommand::Type::SetTile};
+  c.value[0] = x;
+  c.value[1] = y;
+  c.value[2] = blocked ? 1 : 0;
+  return apply(std::move(c));
+}
+
+// ===== Commands and input log =====
+bool Simulation::apply(SimCommand command) {
+  command.tick = tick;
+  if (!execute(command)) {
+    return false;
+  }
+  if (log) {
+    writeSimCommand(*log, command);
+  }
+  unsaved.push_back(std::move(command));
+  return true;
+}
+
+bool Simulation::execute(const SimCommand &c) {
+  using T = SimCommand::Type;
+  const int row = world.animalRow(c.animalId);
+  const int exRow = world.exhibitRow(c.exhibit);
+  switch (c.type) {
+  case T::AddExhibit:
+    if (exRow >= 0) {
+      return false;
+    }
+    world.createExhibit(c.exhibit, static_cast<int>(c.value[0]),
+                        static_cast<float>(c.value[1]));
+    crowd.exhibitAdded();
+    map.addPlot();
+    return true;
+  case T::AddAnimal:
+    if (row >= 0) {
+      return false;
+    }
+    world.createAnimal(c.animalId, static_cast<float>(c.value[0]), exRow);
+    return true;
+  case T::Advance:
+    runTicks(c.value[0]);
+    return true;
+  case T::SetCrowd: {
+    VisitorEconomy e;
+    e.revenueTotal = c.value[0];
+    e.revenueToday = c.value[1];
+    e.reputation = static_cast<float>(c.value[2]);
+    e.attendanceToday = static_cast<long long>(c.value[3]);
+    e.arrivedToday = static_cast<long long>(c.value[4]);
+    e.nextVisitorId = static_cast<std::uint32_t>(c.value[5]);
+    crowd.restoreEconomy(e);
+    return true;
+  }
+  case T::AddVisitor: {
+    const int visitorExhibit = static_cast<int>(c.value[1]);
+    const auto state = static_cast<std::uint8_t>(c.value[2]);
+    if (visitorExhibit >= static_cast<int>(world.exhibits.size()) ||
+        state > VisitorTable::Left ||
+        (visitorExhibit < 0 && (state == VisitorTable::Queued ||
+                                state == VisitorTable::Viewing))) {
+      return false;
+    }
+    const int stopsPlan = static_cast<int>(c.value[5]);
+    crowd.restoreVisitor(static_cast<std::uint32_t>(c.value[0]),
+                         visitorExhibit, state, static_cast<float>(c.value[3]),
+                         static_cast<float>(c.value[4]), stopsPlan / 256,
+                         stopsPlan % 256);
+    return true;
+  }
+  case T::MapSize:
+    return map.resize(static_cast<int>(c.value[0]),
+                      static_cast<int>(c.value[1]));
+  case T::SetTile:
+    return map.setBlocked(static_cast<int>(c.value[0]),
+                          static_cast<int>(c.value[1]), c.value[2] != 0.0);
+  case T::End:
+    return true;
+  default:
+    break;
+  }
+
+  // The rest act on an existing animal or exhibit
+  const bool onAnimal = c.type == T::RemoveAnimal || c.type == T::MoveAnimal ||
+                        c.type == T::SetAnimal || c.type == T::Feed;
+  if ((onAnimal && row < 0) || (!onAnimal && exRow < 0)) {
+    return false;
+  }
+  AnimalTable &a = world.animals;
+  switch (c.type) {
+  case T::RemoveExhibit: {
+    const int last = static_cast<int>(world.exhibits.size()) - 1;
+    world.destroy(world.exhibits.entities[exRow]);
+    crowd.exhibitRemoved(exRow, last);
+    map.removePlot(exRow, last);
+    break;
+  }
+  case T::RemoveAnimal:
+    world.destroy(a.entities[row]);
+    break;
+  case T::MoveAnimal:
+    world.setExhibit(row, exRow); // Unknown name -> -1, i.e. unhoused
+    break;
+  case T::SetAnimal:
+    a.hunger[row] = static_cast<float>(c.value[0]);
+    a.health[row] = static_cast<float>(c.value[1]);
+    a.happiness[row] = static_cast<float>(c.value[2]);
+    a.ageDays[row] = static_cast<float>(c.value[3]);
+    break;
+  case T::SetExhibit:
+    world.exhibits.cleanliness[exRow] = static_cast<float>(c.value[0]);
+    break;
+  case T::Feed: {
+    const float kg = static_cast<float>(c.value[0]);
+    a.hunger[row] = std::max(0.0f, a.hunger[row] - kHungerPerKg * kg);
+    break;
+  }
+  case T::Clean:
+    world.exhibits.cleanliness[exRow] = 1.0f;
+    break;
+  case T::SetTraffic: {
+    ExhibitTraffic t;
+    t.popularity = static_cast<float>(c.value[0]);
+    t.visitsToday = static_cast<long long>(c.value[1]);
+    t.visitsTotal = static_cast<long long>(c.value[2]);
+    t.waitMinutesToday = c.value[3];
+    crowd.restoreTraffic(exRow, t);
+    break;
+  }
+  case T::PlaceExhibit:
+    return map.placePlot(exRow, {static_cast<int>(c.value[0]),
+                                 static_cast<int>(c.value[1]),
+                                 static_cast<int>(c.value[2]),
+                                 static_cast<int>(c.value[3])});
+  default:
+    break;
+  }
+  return true;
+}
+
+// writeSnapshot
+//  - The World is written as ordinary commands in row order, so replaying
+//    it rebuilds identical tables (same rows, same occupancy)
+void Simulation::writeSnapshot(std::ostream &out) const {
+  using T = SimCommand::Type;
+  SimCommand size{.tick = tick, .type = T::MapSize};
+  size.value[0] = map.getWidth();
+  size.value[1] = map.getHeight();
+  writeSimCommand(out, size);
+  for (int y = 0; y < map.getHeight(); ++y) {
+    for (int x = 0; x < map.getWidth(); ++x) {
+      if (map.tileAt(x, y) == ZooMap::Blocked) {
+        SimCommand c{.tick = tick, .type = T::SetTile};
+        c.value[0] = x;
+        c.value[1] = y;
+        c.value[2] = 1;
+        writeSimCommand(out, c);
+      }
+    }
+  }
+  const ExhibitTable &ex = world.exhibits;
+  for (std::size_t i = 0; i < ex.size(); ++i) {
+    SimCommand c{.tick = tick, .type = T::AddExhibit, .exhibit = ex.name[i]};
+    c.value[0] = ex.capacity[i];
+    c.value[1] = ex.appeal[i];
+    writeSimCommand(out, c);
+    c.type = T::SetExhibit;
+    c.value[0] = ex.cleanliness[i];
+    writeSimCommand(out, c);
+    const ExhibitTraffic &t = crowd.getTraffic()[i];
+    c.type = T::SetTraffic;
+    c.value[0] = t.popularity;
+    c.value[1] = static_cast<double>(t.visitsToday);
+    c.value[2] = static_cast<double>(t.visitsTotal);
+    c.value[3] = t.waitMinutesToday;
+    writeSimCommand(out, c);
+    const ExhibitPlot &plot = map.getPlot(static_cast<int>(i));
+    if (plot.placed()) {
+      c.type = T::PlaceExhibit;
+      c.value[0] = plot.x;
+      c.value[1] = plot.y;
+      c.value[2] = plot.w;
+      c.value[3] = plot.h;
+      writeSimCommand(out, c);
+    }
+  }
+  const AnimalTable &a = world.animals;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    SimCommand c{.tick = tick, .type = T::AddAnimal,
+                 .animalId = a.animalId[i],
+                 .exhibit = a.exhibit[i] < 0 ? "" : ex.name[a.exhibit[i]]};
+    c.value[0] = a.ageDays[i];
+    writeSimCommand(out, c);
+    c.type = T::SetAnimal;
+    c.value[0] = a.hunger[i];
+    c.value[1] = a.health[i];
+    c.value[2] = a.happiness[i];
+    c.value[3] = a.ageDays[i];
+    writeSimCommand(out, c);
+  }
+
+  const VisitorEconomy &e = crowd.getEconomy();
+  SimCommand c{.tick = tick, .type = T::SetCrowd};
+  c.value[0] = e.revenueTotal;
+  c.value[1] = e.revenueToday;
+  c.value[2] = e.reputation;
+  c.value[3] = static_cast<double>(e.attendanceToday);
+  c.value[4] = static_cast<double>(e.arrivedToday);
+  c.value[5] = e.nextVisitorId;
+  writeSimCommand(out, c);
+  const VisitorTable &v = crowd.getVisitors();
+  c.type = T::AddVisitor;
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    c.value[0] = v.id[i];
+    c.value[1] = v.exhibit[i];
+    c.value[2] = v.state[i];
+    c.value[3] = v.timer[i];
+    c.value[4] = v.satisfaction[i];
+    c.value[5] = v.stops[i] * 256 + v.plan[i];
+    writeSimCommand(out, c);
+  }
+}
+
+bool Simulation::startRecording(const std::string &path) {
+  stopRecording();
+  auto out = std::make_unique<std::ofstream>(path);
+  if (!*out) {
+    std::cerr << "[Error] Cannot open input log '" << path << "'"
+              << std::endl;
+    return false;
+  }
+  writeSimHeader(*out, {seed, startTime, tick, pendingHours});
+  writeSnapshot(*out);
+  log = std::move(out);
+  return true;
+}
+
+void Simulation::stopRecording() {
+  if (!log) {
+    return;
+  }
+  writeSimCommand(*log, {.tick = tick, .type = SimCommand::Type::End});
+  log.reset();
+}
+
+// readHeader
+//  - Clears the World and restores the recorded clock and seed
+bool Simulation::readHeader(std::istream &in, const std::string &source) {
+  std::string line;
+  SimLogHeader header;
+  if (!std::getline(in, line) || !parseSimHeader(line, header)) {
+    std::cerr << "[Error] " << source << " is not a simulation input log"
+              << std::endl;
+    return false;
+  }
+  reset(header);
+  return true;
+}
+
+// readState
+//  - State lines of older versions are read leniently (see
+//    parseSimCommand); any that still do not apply are skipped, keeping
+//    the rest of the snapshot
+bool Simulation::readState(std::istream &in, const std::string &source,
+                           int &version) {
+  std::string line;
+  SimLogHeader header;
+  if (!std::getline(in, line) ||
+      !parseSimStateHeader(line, header, version)) {
+    std::cerr << "[Error] " << source
+              << " is not a simulation state this build can read"
+              << std::endl;
+    return false;
+  }
+  reset(header);
+  return applyCommands(in, source, true) >= 0;
+}
+
+void Simulation::reset(const SimLogHeader &header) {
+  world = World();
+  crowd = VisitorCrowd();
+  map = ZooMap();
+  seed = header.seed;
+  startTime = header.startTime;
+  tick = header.tick;
+  pendingHours = header.pendingHours;
+}
+
+// applyCommands
+//  - Ticks between commands are run with step(), exactly as they were when
+//    the commands were first applied
+//  - Lenient mode counts the lines it skips and reports them once
+long long Simulation::applyCommands(std::istream &in,
+                                    const std::string &source,
+                                    bool lenient) {
+  long long applied = 0;
+  long long skipped = 0;
+  long long lineNo = 0;
+  std::string line;
+  SimCommand c;
+  auto finish = [&] {
+    if (skipped > 0) {
+      std::cerr << "[Warning] Skipped " << skipped << " line(s) of "
+                << source << " that this build cannot apply" << std::endl;
+    }
+    return applied;
+  };
+  while (std::getline(in, line)) {
+    ++lineNo;
+    if (line.empty()) {
+      continue;
+    }
+    if (!parseSimCommand(line, c, lenient) || c.tick < tick) {
+      if (lenient) {
+        ++skipped;
+        continue;
+      }
+      std::cerr << "[Error] Bad line " << lineNo << " in " << source << ": "
+                << line << std::endl;
+      return -1;
+    }
+    while (tick < c.tick) {
+      step();
+    }
+    if (c.type == SimCommand::Type::End) {
+      return finish();
+    }
+    if (!execute(c)) {
+      if (lenient) {
+        ++skipped;
+        continue;
+      }
+      std::cerr << "[Error] Line " << lineNo << " in " << source
+                << " refers to a missing animal/exhibit" << std::endl;
+      return -1;
+    }
+    ++applied;
+  }
+  return finish(); // Log of a run that did not stop cleanly
+}
+
+long long Simulation::replay(const std::string &path) {
+  std::ifstream in(path);
+  const std::string source = "'" + path + "'";
+  if (!in || !readHeader(in, source)) {
+    if (!in) {
+      std::cerr << "[Error] Cannot open input log " << source << std::endl;
+    }
+    return -1;
+  }
+  stopRecording();
+  unsaved.clear();
+  needBase = true;
+  return applyCommands(in, source);
+}
+
+// stateHash
+//  - FNV-1a over the raw bytes, so any difference at all shows up
+std::uint64_t Simulation::stateHash() const {
+  std::uint64_t h = 0xCBF29CE484222325ull;
+  auto bytes = [&h](const void *data, std::size_t n) {
+    const auto *p = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < n; ++i) {
+      h = (h ^ p[i]) * 0x100000001B3ull;
+    }
+  };
+  auto column = [&bytes](const auto &v) {
+    bytes(v.data(), v.size() * sizeof(v[0]));
+  };
+  bytes(&tick, sizeof tick);
+  bytes(&pendingHours, sizeof pendingHours);
+  const AnimalTable &a = world.animals;
+  column(a.animalId);
+  column(a.hunger);
+  column(a.health);
+  column(a.happiness);
+  column(a.ageDays);
+  column(a.exhibit);
+  const ExhibitTable &ex = world.exhibits;
+  for (const std::string &name : ex.name) {
+    bytes(name.data(), name.size() + 1); // Include the terminator
+  }
+  column(ex.capacity);
+  column(ex.occupancy);
+  column(ex.cleanliness);
+  column(ex.appeal);
+
+  const VisitorTable &v = crowd.getVisitors();
+  column(v.id);
+  column(v.exhibit);
+  column(v.state);
+  column(v.timer);
+  column(v.satisfaction);
+  column(v.stops);
+  column(v.plan);
+  for (const ExhibitTraffic &t : crowd.getTraffic()) {
+    bytes(&t.visitsToday, sizeof t.visitsToday);
+    bytes(&t.visitsTotal, sizeof t.visitsTotal);
+    bytes(&t.waitMinutesToday, sizeof t.waitMinutesToday);
+    bytes(&t.popularity, sizeof t.popularity);
+  }
+  const VisitorEconomy &e = crowd.getEconomy();
+  bytes(&e.revenueTotal, sizeof e.revenueTotal);
+  bytes(&e.revenueToday, sizeof e.revenueToday);
+  bytes(&e.reputation, sizeof e.reputation);
+  bytes(&e.attendanceToday, sizeof e.attendanceToday);
+  bytes(&e.arrivedToday, sizeof e.arrivedToday);
+  bytes(&e.nextVisitorId, sizeof e.nextVisitorId);
+
+  const int size[2] = {map.getWidth(), map.getHeight()};
+  bytes(size, sizeof size);
+  column(map.getTiles());
+  for (const ExhibitPlot &p : map.getPlots()) {
+    const int rect[4] = {p.x, p.y, p.w, p.h};
+    bytes(rect, sizeof rect);
+  }
+  return h;
+}
+
+// ===== Persistence Layer =====
+// Save chain limits: a new base is written once any of these is reached,
+// bounding both the chain length and the replay work a load has to do
+static constexpr std::size_t kMaxChainDeltas = 64;
+static constexpr long long kMaxReplayRowTicks = 2'000'000; // Ticks x rows
+
+// Identifies this build. A delta replays inputs through the systems, so it
+// only reproduces the saved state under the code and tuning that wrote it;
+// every source file is compiled together, so any change gives a new stamp.
+static constexpr const char *kBuildId = __DATE__ " " __TIME__;
+
+// saveToDatabase
+//  - Nothing to do if no input was applied and no tick ran since the last
+//    save; otherwise the delta is the unsaved commands plus the end tick
+//  - A new base replaces the whole chain in the same transaction, so the
+//    table always holds one loadable chain
+bool Simulation::saveToDatabase(Database &db, bool base) {
+  if (!needBase && unsaved.empty() && tick == savedTick &&
+      (!base || chainDeltas == 0)) {
+    return true;
+  }
+  std::ostringstream delta;
+  for (const SimCommand &c : unsaved) {
+    writeSimCommand(delta, c);
+  }
+  writeSimCommand(delta, {.tick = tick, .type = SimCommand::Type::End});
+  std::string data = delta.str();
+
+  const long long rows =
+      static_cast<long long>(world.animals.size() + world.exhibits.size() +
+                             crowd.getVisitors().size());
+  const bool rebase = base || needBase || chainDeltas >= kMaxChainDeltas ||
+                      chainBytes + data.size() > baseBytes ||
+                      (tick - baseTick) * std::max(rows, 1LL) >
+                          kMaxReplayRowTicks;
+  if (rebase) {
+    std::ostringstream base;
+    writeSimStateHeader(base, {seed, startTime, tick, pendingHours});
+    writeSnapshot(base);
+    writeSimCommand(base, {.tick = tick, .type = SimCommand::Type::End});
+    data = base.str();
+  }
+
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "INSERT INTO SimSaves (is_base, tick, data, build) VALUES (?, ?, ?, ?);";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+  if (!db.beginTransaction()) {
+    sqlite3_finalize(stmt);
+    return false;
+  }
+  bool ok = !rebase || db.execute("DELETE FROM SimSaves;");
+  if (ok) {
+    sqlite3_bind_int(stmt, 1, rebase ? 1 : 0);
+    sqlite3_bind_int64(stmt, 2, tick);
+    sqlite3_bind_blob(stmt, 3, data.data(), static_cast<int>(data.size()),
+                      SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, kBuildId, -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+      std::cerr << "[Error] Failed to save simulation: "
+                << sqlite3_errmsg(db.get()) << std::endl;
+      ok = false;
+    }
+  }
+  sqlite3_finalize(stmt);
+  if (!ok || !db.commit()) {
+    db.rollback();
+    return false;
+  }
+
+  if (rebase) {
+    baseBytes = data.size();
+    baseTick = tick;
+    chainDeltas = 0;
+    chainBytes = 0;
+  } else {
+    ++chainDeltas;
+    chainBytes += data.size();
+  }
+  unsaved.clear();
+  savedTick = tick;
+  needBase = false;
+  return true;
+}
+
+// loadFromDatabase
+//  - Reads the base and then replays each delta in save order
+//  - Deltas from another build (or from before builds were recorded) are
+//    replayed leniently under this build's rules, so their inputs are kept
+//    even though the result may differ from what that build would have
+//    computed; the chain is then re-based at the next save, so deltas are
+//    only ever appended to a chain this build can replay exactly
+//  - A base in an older state version is re-based the same way
+bool Simulation::loadFromDatabase(Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql =
+      "SELECT is_base, tick, data, build FROM SimSaves ORDER BY seq;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+  bool ok = true;
+  bool first = true;
+  bool upgrade = false;
+  std::size_t deltas = 0, deltaBytes = 0, firstBytes = 0;
+  long long firstTick = 0;
+  while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+    const bool isBase = sqlite3_column_int(stmt, 0) != 0;
+    const auto *bytes =
+        static_cast<const char *>(sqlite3_column_blob(stmt, 2));
+    const std::string data(bytes ? bytes : "",
+                           static_cast<std::size_t>(
+                               sqlite3_column_bytes(stmt, 2)));
+    const std::string source =
+        "saved " + std::string(isBase ? "base" : "delta") + " at tick " +
+        std::to_string(sqlite3_column_int64(stmt, 1));
+    const auto *build =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+    const bool sameBuild = build && std::string(build) == kBuildId;
+    std::istringstream in(data);
+    if (first != isBase) {
+      std::cerr << "[Error] Simulation save chain is damaged" << std::endl;
+      ok = false;
+    } else if (isBase) {
+      int version = 0;
+      ok = readState(in, source, version);
+      upgrade = version < SIM_STATE_VERSION;
+      firstBytes = data.size();
+      firstTick = tick;
+    } else {
+      ok = applyCommands(in, source, !sameBuild) >= 0;
+      upgrade = upgrade || !sameBuild;
+      ++deltas;
+      deltaBytes += data.size();
+    }
+    first = false;
+  }
+  sqlite3_finalize(stmt);
+  if (!ok) {
+    world = World();
+    crowd = VisitorCrowd();
+    map = ZooMap();
+    tick = 0;
+    pendingHours = 0.0;
+    needBase = true;
+    return false;
+  }
+  unsaved.clear();
+  if (!first) {
+    baseBytes = firstBytes;
+    baseTick = firstTick;
+    chainDeltas = deltas;
+    chainBytes = deltaBytes;
+    savedTick = tick;
+    needBase = upgrade;
+  }
+  if (upgrade) {
+    std::cout << "Simulation save came from another build; it will be "
+                 "re-based at the next save.\n";
+  }
+  return true;
+}
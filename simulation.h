@@ -0,0 +1,236 @@
+// simulation.h
+// Declaration of Simulation: a fixed-timestep zoo simulation. Animal and
+// exhibit state lives in an ECS World; each tick runs the registered systems
+// over the World's packed component arrays. Systems declare the components
+// they read and write, which orders them into stages: systems in one stage
+// do not conflict and, given a JobSystem, run concurrently with their rows
+// split into stealable chunks.
+//
+// Runs are deterministic: random draws come from per-system streams keyed
+// by seed, tick and entity, so results do not depend on thread count or
+// chunking. Every input can be recorded to a log whose replay reproduces
+// the same stateHash() bit for bit.
+//
+// After the systems, each tick runs the VisitorCrowd for that hour of the
+// simulated day. Visitors read the World but never change it; they walk
+// between exhibits along the ZooMap, which is simulation state too (every
+// exhibit gets a plot on it, and edits are inputs like any other).
+//
+// The same property makes saves incremental: all that changes the World
+// between two saves, other than running ticks, is the inputs applied in
+// between. A save is a delta of those inputs on top of a base snapshot.
+// The base is in the versioned state format, which later builds keep
+// reading; a delta reproduces the state only under the build that wrote it
+// (replay runs that build's systems), so each is tagged with its build.
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "animalManager.h"  // Animals to mirror into the World
+#include "database.h"       // SimSaves table
+#include "ecs.h"            // World, component tables
+#include "exhibitManager.h" // Exhibits to mirror into the World
+#include "jobSystem.h"      // Parallel stages
+#include "simLog.h"         // Recorded inputs
+#include "simRng.h"         // Per-system random streams
+#include "visitors.h"       // Visitor crowd
+#include "zooMap.h"         // Exhibit plots, walking distances
+#include <cstdint>          // Seeds, hashes
+#include <ctime>            // Simulated clock
+#include <fstream>          // Input log file
+#include <iosfwd>           // Snapshot/command streams
+#include <memory>           // Owned log stream
+#include <string>
+#include <vector>
+
+// Component bits for SimSystem::reads / writes
+enum SimComponent : unsigned {
+  COMP_HUNGER = 1u << 0,
+  COMP_HEALTH = 1u << 1,
+  COMP_HAPPINESS = 1u << 2,
+  COMP_AGE = 1u << 3,
+  COMP_CLEANLINESS = 1u << 4,
+  COMP_HOUSING = 1u << 5 // Animal exhibit links, occupancy, capacity
+};
+
+// What a system gets to know about the tick it runs in
+struct SimTick {
+  float dtHours;
+  long long tick;
+  SimRng rng; // This system's stream for this tick
+};
+
+// A system: one pass per tick over every animal row or every exhibit row.
+// run() handles rows [begin, end) and may only write its own rows' entries
+// of the components in 'writes', so any split of the rows gives the same
+// result as a single pass.
+struct SimSystem {
+  enum class Domain { Animals, Exhibits };
+
+  const char *name;
+  Domain domain;
+  unsigned reads;
+  unsigned writes;
+  void (*run)(World &world, const SimTick &tick, std::size_t begin,
+              std::size_t end);
+};
+
+class Simulation {
+public:
+  static constexpr double TICK_HOURS = 1.0; // Fixed timestep
+  static constexpr int TICKS_PER_DAY = 24;
+
+  // Registers the built-in systems: environment, hunger, health, happiness,
+  // aging (registration order; see addSystem for how that maps to stages)
+  Simulation();
+  ~Simulation(); // Finishes any recording
+
+  Simulation(const Simulation &) = delete;
+  Simulation &operator=(const Simulation &) = delete;
+
+  // The managers stay the record of which animals and exhibits exist; this
+  // brings the World in line with them. New animals/exhibits get entities,
+  // removed ones are destroyed, and moved animals are re-linked. Simulated
+  // state of existing entities is kept. Exhibits without a plot are given
+  // the first free one, growing the map when it is full.
+  void sync(const AnimalManager &am, const ExhibitManager &em);
+
+  // Runs as many whole ticks as fit in 'hours' plus any carried remainder
+  //  - Returns the number of ticks run
+  int advance(double hours);
+
+  // Runs exactly one tick, stage by stage (not logged itself: the tick
+  // stamps of later commands account for it)
+  void step();
+
+  // Runs stages on 'jobs' (nullptr runs them serially on the caller). The
+  // JobSystem must outlive its use here.
+  void setJobSystem(JobSystem *jobs) { this->jobs = jobs; }
+
+  // Interactions (return false if the animal/exhibit is not simulated)
+  bool feed(int animalId, double kg);
+  bool cleanExhibit(const std::string &name);
+
+  // Map edits (return false if ZooMap rejects them; see there)
+  bool placeExhibit(const std::string &name, const ExhibitPlot &plot);
+  bool setTileBlocked(int x, int y, bool blocked);
+
+  // Appends a system. It runs after every earlier system whose components
+  // it conflicts with (read-after-write, write-after-read/write) and may
+  // share a stage with the rest, so results match running the systems one
+  // after another in registration order.
+  void addSystem(const SimSystem &system);
+
+  // Stages as lists of indices into the registered systems
+  const std::vector<std::vector<std::size_t>> &getStages() const {
+    return stages;
+  }
+  const SimSystem &getSystem(std::size_t i) const { return systems[i]; }
+
+  World &getWorld() { return world; }
+  const World &getWorld() const { return world; }
+  const VisitorCrowd &getCrowd() const { return crowd; }
+  const ZooMap &getMap() const { return map; }
+  long long getTick() const { return tick; }
+
+  // Hour (0-23) of the simulated day, in UTC so replays agree everywhere
+  int getHourOfDay() const {
+    return static_cast<int>(getTime() / 3600 % TICKS_PER_DAY);
+  }
+
+  std::uint64_t getSeed() const { return seed; }
+  // A new seed cannot be expressed as a delta: the next save is a base
+  void setSeed(std::uint64_t s) {
+    seed = s;
+    needBase = true;
+  }
+
+  // Hash of the clock, every component in row order, the crowd and the map
+  std::uint64_t stateHash() const;
+
+  // Input log. Recording writes the clock and a snapshot of the World, then
+  // every input (sync changes, feedings, cleanings, advances) as it is
+  // applied; stopping writes the final tick. Start after loadFromDatabase.
+  //  - startRecording returns false if the file cannot be opened
+  bool startRecording(const std::string &path);
+  void stopRecording();
+  bool isRecording() const { return log != nullptr; }
+
+  // Rebuilds this simulation from a log: clears the World, restores the
+  // recorded clock and seed, and applies every command at its tick
+  //  - Returns the number of commands applied, or -1 on a bad log
+  long long replay(const std::string &path);
+
+  // Simulated wall-clock time: the start time plus one TICK_HOURS per tick
+  time_t getTime() const {
+    return startTime + static_cast<time_t>(tick * TICK_HOURS * 3600);
+  }
+
+  // Inputs applied since the last save (what the next delta will hold)
+  std::size_t unsavedChanges() const { return unsaved.size(); }
+
+  // Save chain (SimSaves table): a base snapshot followed by deltas.
+  //  - saveToDatabase appends a delta of the unsaved inputs, costing what
+  //    changed rather than World size, and does nothing if nothing did.
+  //    It writes a fresh base instead (replacing the chain) on the first
+  //    save, after a new seed, or once the deltas outgrow the base, number
+  //    too many, or would take too many ticks x rows to replay.
+  //  - base: always write a base (if the chain holds anything else). Clean
+  //    exits pass it, so the chain they leave is readable by any later
+  //    build and no deltas depend on this build's systems.
+  //  - loadFromDatabase replaces the World with the saved one (call before
+  //    sync); an empty table leaves the simulation as it is. Loading costs
+  //    the base plus replaying the deltas' ticks, which the limits above
+  //    keep to a few million row updates. A chain written by another build
+  //    is re-based at the next save.
+  // Both return false on failure.
+  bool saveToDatabase(Database &db, bool base = false);
+  bool loadFromDatabase(Database &db);
+
+private:
+  World world;
+  VisitorCrowd crowd;
+  ZooMap map;
+  std::vector<SimSystem> systems;
+  std::vector<std::vector<std::size_t>> stages;
+  JobSystem *jobs = nullptr;
+  long long tick = 0;
+  time_t startTime = std::time(nullptr); // Simulated time of tick 0
+  double pendingHours = 0.0; // Simulated time not yet covered by a tick
+  std::uint64_t seed = 0x5EED;           // Root of every random stream
+  std::unique_ptr<std::ofstream> log;    // Open while recording
+
+  // Save chain state
+  std::vector<SimCommand> unsaved; // Inputs applied since the last save
+  bool needBase = true;            // Next save must be a base snapshot
+  long long savedTick = 0;         // Tick of the last save
+  long long baseTick = 0;          // Tick of the current base
+  std::size_t baseBytes = 0;       // Size of the current base
+  std::size_t chainDeltas = 0;     // Deltas saved after the base
+  std::size_t chainBytes = 0;      // Their total size
+
+  // Executes 'command' and, when recording, logs it stamped with the tick
+  // it was applied at
+  //  - Returns false (and logs nothing) if execute fails
+  bool apply(SimCommand command);
+  // Performs a command without logging it
+  //  - Returns false if its animal/exhibit does not exist
+  bool execute(const SimCommand &command);
+  // advance() without logging; returns the number of ticks run
+  int runTicks(double hours);
+  // The map, World and crowd as state lines (no header or end line)
+  void writeSnapshot(std::ostream &out) const;
+  // Parses an input-log header and resets the World and clock to it
+  bool readHeader(std::istream &in, const std::string &source);
+  // Parses a state header (receiving its version) and the snapshot after it
+  bool readState(std::istream &in, const std::string &source, int &version);
+  // Clears the World, crowd and map and sets the clock and seed
+  void reset(const SimLogHeader &header);
+  // Executes commands until an end line (or EOF), running ticks between
+  //  - Returns the number applied, or -1 on a bad line
+  //  - lenient: skips lines that do not parse or apply instead
+  long long applyCommands(std::istream &in, const std::string &source,
+                          bool lenient = false);
+};
+
+#endif // SIMULATION_H
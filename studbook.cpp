@@ -0,0 +1,387 @@
+// studbook.cpp
+// Implements Studbook: registration, breeding, kinship and inbreeding,
+// mate recommendations and persistence.
+
+#include "studbook.h"
+#include "simRng.h"      // mix64 for genomes
+#include <algorithm>     // std::partial_sort, heaps, std::copy_n
+#include <iostream>      // std::cerr
+#include <unordered_set> // Animals registered in one batch
+
+// Crossover points per child
+static constexpr int kCrossovers = 3;
+
+// Purposes of the per-animal random streams
+enum : std::uint64_t { kFounderStream, kMaskStream, kNoiseStream };
+
+// Key of one animal's stream for one purpose
+static std::uint64_t streamKey(std::uint64_t seed, int animalId,
+                               std::uint64_t purpose) {
+  return mix64(seed ^ mix64(static_cast<std::uint64_t>(animalId)) ^
+               mix64(purpose));
+}
+
+// Random genome 'index' of a stream
+static Genome randomGenome(std::uint64_t key, int index) {
+  Genome g;
+  for (int w = 0; w < GENOME_WORDS; ++w) {
+    g.words[w] =
+        mix64(key + static_cast<std::uint64_t>(index) * GENOME_WORDS + w);
+  }
+  return g;
+}
+
+Genome Studbook::founderGenome(int animalId) const {
+  return randomGenome(streamKey(seed, animalId, kFounderStream), 0);
+}
+
+const StudbookEntry *Studbook::find(int animalId) const {
+  auto it = rowOf.find(animalId);
+  return it == rowOf.end() ? nullptr : &entries[it->second];
+}
+
+// append
+//  - The entry's parents (if known) are already registered, so their rows
+//    are lower: the order stays topological
+void Studbook::append(StudbookEntry entry) {
+  auto parentRow = [&](int id) {
+    auto it = id != 0 ? rowOf.find(id) : rowOf.end();
+    return it == rowOf.end() ? -1 : it->second;
+  };
+  sireRow.push_back(parentRow(entry.sire));
+  damRow.push_back(parentRow(entry.dam));
+  inbred.push_back(-1.0);
+  scratch.push_back(0.0);
+  rowOf.emplace(entry.animalId, static_cast<int>(entries.size()));
+  entries.push_back(std::move(entry));
+}
+
+bool Studbook::addFounder(int animalId, const std::string &species) {
+  if (rowOf.count(animalId)) {
+    return false;
+  }
+  append({animalId, species, 0, 0, founderGenome(animalId)});
+  return true;
+}
+
+// addOffspring
+//  - The crossover mask selects the sire's bits; it starts on a random
+//    parent and switches at each crossover point
+bool Studbook::addOffspring(int childId, int sireId, int damId) {
+  const StudbookEntry *sire = find(sireId);
+  const StudbookEntry *dam = find(damId);
+  if (childId == 0 || rowOf.count(childId) || !sire || !dam ||
+      sire->species != dam->species || !sire->male() || dam->male()) {
+    return false;
+  }
+  const std::uint64_t maskKey = streamKey(seed, childId, kMaskStream);
+  Genome mask;
+  const std::uint64_t start = mix64(maskKey) & 1 ? ~0ull : 0ull;
+  for (int w = 0; w < GENOME_WORDS; ++w) {
+    mask.words[w] = start;
+  }
+  for (int c = 1; c <= kCrossovers; ++c) {
+    const int point = 1 + static_cast<int>(mix64(maskKey + c) %
+                                           (GENOME_BITS - 1));
+    for (int w = point / 64; w < GENOME_WORDS; ++w) {
+      mask.words[w] ^= w == point / 64 ? ~0ull << (point % 64) : ~0ull;
+    }
+  }
+  Genome noise[MUTATION_NOISE];
+  const std::uint64_t noiseKey = streamKey(seed, childId, kNoiseStream);
+  for (int k = 0; k < MUTATION_NOISE; ++k) {
+    noise[k] = randomGenome(noiseKey, k);
+  }
+  StudbookEntry child{childId, sire->species, sireId, damId, {}};
+  genomeKernels::recombine(&sire->genome, &dam->genome, &mask, noise,
+                           &child.genome, 1);
+  append(std::move(child));
+  return true;
+}
+
+// pathCoefficients
+//  - Walks up taking the highest row first: every child of an ancestor has
+//    a higher row, so all paths into the ancestor are summed before it is
+//    reached
+void Studbook::pathCoefficients(
+    int row, std::vector<std::pair<int, double>> &out) const {
+  out.clear();
+  heap.assign(1, row);
+  scratch[row] = 1.0;
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end());
+    const int j = heap.back();
+    heap.pop_back();
+    const double l = scratch[j];
+    scratch[j] = 0.0;
+    out.emplace_back(j, l);
+    for (int p : {sireRow[j], damRow[j]}) {
+      if (p < 0) {
+        continue;
+      }
+      if (scratch[p] == 0.0) {
+        heap.push_back(p);
+        std::push_heap(heap.begin(), heap.end());
+      }
+      scratch[p] += 0.5 * l;
+    }
+  }
+}
+
+double Studbook::sampling(int row) const {
+  const int s = sireRow[row], d = damRow[row];
+  if (s >= 0 && d >= 0) {
+    return 0.5 - 0.25 * (inbreedingOfRow(s) + inbreedingOfRow(d));
+  }
+  if (s >= 0 || d >= 0) {
+    return 0.75 - 0.25 * inbreedingOfRow(s >= 0 ? s : d);
+  }
+  return 1.0;
+}
+
+double Studbook::inbreedingOfRow(int row) const {
+  if (inbred[row] < 0.0) {
+    inbred[row] = sireRow[row] >= 0 && damRow[row] >= 0
+                      ? kinshipOfRows(sireRow[row], damRow[row])
+                      : 0.0;
+  }
+  return inbred[row];
+}
+
+// kinshipOfRows
+//  - f(a, b) = 1/2 * sum over common ancestors j (each animal counting as
+//    its own ancestor) of L_a(j) * L_b(j) * D(j)
+//  - D(j) needs the inbreeding of j's parents, which are older than both
+//    animals; those recursive calls start once the paths are collected
+double Studbook::kinshipOfRows(int a, int b) const {
+  std::vector<std::pair<int, double>> pa, pb;
+  pathCoefficients(a, pa);
+  pathCoefficients(b, pb);
+  double sum = 0.0;
+  for (std::size_t i = 0, j = 0; i < pa.size() && j < pb.size();) {
+    if (pa[i].first > pb[j].first) {
+      ++i;
+    } else if (pa[i].first < pb[j].first) {
+      ++j;
+    } else {
+      sum += pa[i].second * pb[j].second * sampling(pa[i].first);
+      ++i;
+      ++j;
+    }
+  }
+  return 0.5 * sum;
+}
+
+double Studbook::kinship(int animalA, int animalB) const {
+  auto a = rowOf.find(animalA);
+  auto b = rowOf.find(animalB);
+  if (a == rowOf.end() || b == rowOf.end()) {
+    return 0.0;
+  }
+  return kinshipOfRows(a->second, b->second);
+}
+
+double Studbook::inbreeding(int animalId) const {
+  auto it = rowOf.find(animalId);
+  if (it == rowOf.end()) {
+    return 0.0;
+  }
+  return inbreedingOfRow(it->second);
+}
+
+// recommendMates
+//  - Kinship with every animal comes from one row of A = T D T': q = T'e
+//    spreads the focal animal up to its ancestors (backward pass), then
+//    a = T D q brings it down to every descendant (forward pass)
+//  - Genome distances for all candidates come from one batched kernel call
+std::vector<MateSuggestion>
+Studbook::recommendMates(int animalId, const std::vector<Animal> &living,
+                         std::size_t count) const {
+  auto self = rowOf.find(animalId);
+  if (self == rowOf.end()) {
+    return {};
+  }
+  const int focalRow = self->second;
+  const StudbookEntry &focal = entries[focalRow];
+  std::vector<int> rows;
+  std::vector<Genome> genomes;
+  for (const Animal &a : living) {
+    auto it = rowOf.find(a.getId());
+    if (it == rowOf.end() || it->second == focalRow) {
+      continue;
+    }
+    const StudbookEntry &c = entries[it->second];
+    if (c.species == focal.species && c.male() != focal.male()) {
+      rows.push_back(it->second);
+      genomes.push_back(c.genome);
+    }
+  }
+  std::vector<std::uint16_t> distance(rows.size());
+  genomeKernels::distances(focal.genome, genomes.data(), genomes.size(),
+                           distance.data());
+
+  std::vector<double> q(focalRow + 1, 0.0);
+  q[focalRow] = 1.0;
+  for (int i = focalRow; i >= 0; --i) {
+    if (q[i] != 0.0) {
+      for (int p : {sireRow[i], damRow[i]}) {
+        if (p >= 0) {
+          q[p] += 0.5 * q[i];
+        }
+      }
+    }
+  }
+  std::vector<double> a(entries.size(), 0.0);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    double v = i < q.size() && q[i] != 0.0
+                   ? q[i] * sampling(static_cast<int>(i))
+                   : 0.0;
+    for (int p : {sireRow[i], damRow[i]}) {
+      if (p >= 0) {
+        v += 0.5 * a[p];
+      }
+    }
+    a[i] = v;
+  }
+
+  std::vector<MateSuggestion> mates;
+  mates.reserve(rows.size());
+  for (std::size_t i = 0; i < rows.size(); ++i) {
+    mates.push_back(
+        {entries[rows[i]].animalId, 0.5 * a[rows[i]], distance[i]});
+  }
+  const std::size_t shown = std::min(count, mates.size());
+  std::partial_sort(mates.begin(), mates.begin() + shown, mates.end(),
+                    [](const MateSuggestion &x, const MateSuggestion &y) {
+                      if (x.kinship != y.kinship) {
+                        return x.kinship < y.kinship;
+                      }
+                      if (x.distance != y.distance) {
+                        return x.distance > y.distance;
+                      }
+                      return x.animalId < y.animalId;
+                    });
+  mates.resize(shown);
+  return mates;
+}
+
+// ===== Persistence Layer =====
+void Studbook::loadFromDatabase(Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  const char *sql = "SELECT animal_id, species, sire, dam, genome "
+                    "FROM Studbook ORDER BY seq;";
+  if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return;
+  }
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    StudbookEntry e{sqlite3_column_int(stmt, 0), "", 0, 0, {}};
+    if (const unsigned char *s = sqlite3_column_text(stmt, 1)) {
+      e.species = reinterpret_cast<const char *>(s);
+    }
+    e.sire = sqlite3_column_int(stmt, 2);
+    e.dam = sqlite3_column_int(stmt, 3);
+    const void *blob = sqlite3_column_blob(stmt, 4);
+    if (blob && sqlite3_column_bytes(stmt, 4) == sizeof(e.genome.words)) {
+      std::copy_n(static_cast<const unsigned char *>(blob),
+                  sizeof(e.genome.words),
+                  reinterpret_cast<unsigned char *>(e.genome.words));
+    } else {
+      e.genome = founderGenome(e.animalId);
+    }
+    if (!rowOf.count(e.animalId)) {
+      append(std::move(e));
+    }
+  }
+  sqlite3_finalize(stmt);
+}
+
+static const char *kInsertSql = "INSERT INTO Studbook (animal_id, species, "
+                                "sire, dam, genome) VALUES (?, ?, ?, ?, ?);";
+
+// Binds 'entry' to a prepared kInsertSql statement, runs it and resets it
+static bool insertEntry(sqlite3_stmt *stmt, const StudbookEntry &entry,
+                        Database &db) {
+  sqlite3_bind_int(stmt, 1, entry.animalId);
+  sqlite3_bind_text(stmt, 2, entry.species.c_str(), -1, SQLITE_TRANSIENT);
+  sqlite3_bind_int(stmt, 3, entry.sire);
+  sqlite3_bind_int(stmt, 4, entry.dam);
+  sqlite3_bind_blob(stmt, 5, entry.genome.words, sizeof(entry.genome.words),
+                    SQLITE_TRANSIENT);
+  bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+  if (!ok) {
+    std::cerr << "[Error] Failed to save studbook entry for animal "
+              << entry.animalId << ": " << sqlite3_errmsg(db.get())
+              << std::endl;
+  }
+  sqlite3_reset(stmt);
+  return ok;
+}
+
+bool Studbook::saveEntryToDatabase(const StudbookEntry &entry, Database &db) {
+  sqlite3_stmt *stmt = nullptr;
+  if (sqlite3_prepare_v2(db.get(), kInsertSql, -1, &stmt, nullptr) !=
+      SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return false;
+  }
+  bool ok = insertEntry(stmt, entry, db);
+  sqlite3_finalize(stmt);
+  return ok;
+}
+
+// registerFounders
+//  - One prepared INSERT in one transaction; memory is only touched once
+//    it has committed
+//  - An animal registered under another species took over the ID of one
+//    that left (before new animals were refused such IDs); it is reported,
+//    since its studbook data is not its own
+int Studbook::registerFounders(const std::vector<Animal> &animals,
+                               Database &db) {
+  std::vector<StudbookEntry> fresh;
+  std::unordered_set<int> seen;
+  for (const Animal &a : animals) {
+    const StudbookEntry *known = find(a.getId());
+    if (known && known->species != a.getSpecies()) {
+      std::cerr << "[Warning] Animal " << a.getId() << " (" << a.getSpecies()
+                << ") reuses the studbook ID of a " << known->species
+                << "; its pedigree and genome are not its own" << std::endl;
+    }
+    if (!known && seen.insert(a.getId()).second) {
+      fresh.push_back({a.getId(), a.getSpecies(), 0, 0,
+                       founderGenome(a.getId())});
+    }
+  }
+  if (fresh.empty()) {
+    return 0;
+  }
+  sqlite3_stmt *stmt = nullptr;
+  if (sqlite3_prepare_v2(db.get(), kInsertSql, -1, &stmt, nullptr) !=
+      SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return -1;
+  }
+  if (!db.beginTransaction()) {
+    sqlite3_finalize(stmt);
+    return -1;
+  }
+  for (const StudbookEntry &e : fresh) {
+    if (!insertEntry(stmt, e, db)) {
+      sqlite3_finalize(stmt);
+      db.rollback();
+      return -1;
+    }
+  }
+  sqlite3_finalize(stmt);
+  if (!db.commit()) {
+    db.rollback();
+    return -1;
+  }
+  for (StudbookEntry &e : fresh) {
+    append(std::move(e));
+  }
+  return static_cast<int>(fresh.size());
+}
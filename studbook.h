@@ -0,0 +1,124 @@
+// studbook.h
+// Declaration of Studbook: the zoo's breeding register. Every animal that
+// has lived here has an entry with its species, its parents (if bred here)
+// and its Genome. Entries are never removed, since a departed animal is
+// still the ancestor of its descendants. For the same reason an animal ID
+// is never reused: animals are registered as they are added, and the UI
+// refuses new animals whose ID is in the studbook or held by a living one.
+//
+// The parent links form a pedigree DAG; entries are kept parents-first,
+// which is a topological order. Kinship (the chance that a gene drawn from
+// each of two animals is identical by descent) comes from the numerator
+// relationship matrix A = T D T', where T holds the path coefficients from
+// each animal to its ancestors and D the Mendelian sampling variances:
+//  - A pair's kinship needs only the two animals' ancestors
+//  - Inbreeding coefficients are memoized per animal, so each is worked
+//    out once, oldest ancestors first
+//  - Kinship of one animal with every other (for mate suggestions) is one
+//    backward and one forward pass over the studbook (Colleau's method),
+//    so a query over a species never costs a pass per candidate pair
+
+#ifndef STUDBOOK_H
+#define STUDBOOK_H
+
+#include "animal.h"        // Animals to register and rank
+#include "database.h"      // Studbook table
+#include "genomeKernels.h" // Genome, recombination, distances
+#include <cstddef>         // std::size_t
+#include <cstdint>         // Seeds
+#include <string>
+#include <unordered_map> // Animal ID -> entry
+#include <utility>       // Row / coefficient pairs
+#include <vector>
+
+struct StudbookEntry {
+  int animalId;
+  std::string species;
+  int sire = 0; // Animal IDs; 0 = unknown (a founder)
+  int dam = 0;
+  Genome genome;
+
+  bool male() const { return genome.bit(0); }
+};
+
+// A possible mate and what pairing with it would mean
+struct MateSuggestion {
+  int animalId;
+  double kinship; // = inbreeding coefficient of their offspring
+  int distance;   // Genome bits in which the two differ
+};
+
+class Studbook {
+public:
+  explicit Studbook(std::uint64_t seed = 0x5EED) : seed(seed) {}
+
+  // Entry for an animal ID, or nullptr
+  const StudbookEntry *find(int animalId) const;
+  std::size_t size() const { return entries.size(); }
+
+  // Registers a founder with a random genome (so a random sex)
+  //  - Returns false if the ID is already registered
+  bool addFounder(int animalId, const std::string &species);
+
+  // Registers the offspring of 'sireId' and 'damId': each parent passes on
+  // stretches of its genome between a few random crossover points, then
+  // rare random mutations flip single bits
+  //  - Returns false if the ID is taken, a parent is unknown, the parents'
+  //    species differ, or the sire is not male or the dam not female
+  bool addOffspring(int childId, int sireId, int damId);
+
+  // Coefficient of kinship of two animals (0 if either is unknown)
+  double kinship(int animalA, int animalB) const;
+
+  // Inbreeding coefficient: the kinship of the animal's parents
+  double inbreeding(int animalId) const;
+
+  // The best 'count' mates for 'animalId' among the 'living' animals of its
+  // species and the opposite sex: least related first, then most different
+  // genomes
+  std::vector<MateSuggestion>
+  recommendMates(int animalId, const std::vector<Animal> &living,
+                 std::size_t count) const;
+
+  // ===== Database operations (Studbook table) =====
+  // Entries load in insertion order, which puts parents first
+  void loadFromDatabase(Database &db);
+  static bool saveEntryToDatabase(const StudbookEntry &entry, Database &db);
+
+  // Registers (and saves, in one transaction) every animal that is not in
+  // the studbook yet as a founder
+  //  - Returns the number registered, or -1 if the transaction failed
+  //  - Warns about animals whose ID is registered under another species
+  int registerFounders(const std::vector<Animal> &animals, Database &db);
+
+private:
+  std::uint64_t seed;
+  std::vector<StudbookEntry> entries; // Parents before children
+  std::unordered_map<int, int> rowOf; // Animal ID -> entry row
+
+  // Per row: parent rows (-1 = unknown)
+  std::vector<int> sireRow;
+  std::vector<int> damRow;
+
+  // Memoized inbreeding coefficients per row (negative = not known yet)
+  mutable std::vector<double> inbred;
+
+  // Scratch for path coefficients and kinship rows (zero between uses)
+  mutable std::vector<double> scratch;
+  mutable std::vector<int> heap;
+
+  void append(StudbookEntry entry);
+  Genome founderGenome(int animalId) const;
+
+  // Path coefficients from 'row' to itself and each of its ancestors,
+  // youngest (highest row) first
+  void pathCoefficients(int row,
+                        std::vector<std::pair<int, double>> &out) const;
+
+  // Mendelian sampling variance of a row (the diagonal of D)
+  double sampling(int row) const;
+  double inbreedingOfRow(int row) const;
+  double kinshipOfRows(int a, int b) const;
+};
+
+#endif // STUDBOOK_H
@@ -10,9 +10,25 @@
 #include "database.h"       // Database wrapper for SQLite
 #include "exhibit.h"        // Exhibit model
 #include "exhibitManager.h" // CRUD and persistence for Exhibits
+#include "jobSystem.h"       // Worker pool for simulation stages
+#include "outbreak.h"        // Disease spread scenarios
+#include "placementEngine.h" // Batch placement of animals into exhibits
+#include "rebalancePlanner.h" // Minimal-move exhibit rebalancing
+#include "routePlanner.h"     // Keeper feeding rounds
+#include "simulation.h"       // Tick-based simulation of animal state
+#include "studbook.h"         // Pedigrees, genomes, mate suggestions
 
-#include <iostream> // I/O streams
-#include <string>   // std::string
+#include <algorithm>     // std::min, std::all_of, std::partial_sort
+#include <chrono>        // Scenario timing
+#include <cmath>         // std::sqrt for baseline spread
+#include <cstdio>        // std::sscanf for date parsing
+#include <ctime>         // std::mktime for date-range input
+#include <iostream>      // I/O streams
+#include <limits>        // Open-ended time range for feeding reports
+#include <string>        // std::string
+#include <unordered_map> // Animal ID -> name for due care
+#include <unordered_set> // IDs taken earlier in an animal batch
+#include <vector>        // std::vector for animal batches
 
 using std::cin;
 using std::cout;
@@ -37,6 +53,37 @@ static int readInt(const string &prompt, int min, int max) {
   }
 }
 
+// Helper: prompt for the ID of a new animal. Animals enter the studbook
+// when they are added, and it keeps every animal that ever lived here, so
+// an ID found there is refused: a new animal under it would inherit that
+// animal's sex, genome and parents. IDs of living animals (which may predate
+// the studbook) and of animals earlier in the same batch ('pending') are
+// refused too.
+static int readNewAnimalId(const Studbook &studbook,
+                           const AnimalManager &animalMgr,
+                           const std::unordered_set<int> *pending = nullptr) {
+  while (true) {
+    int id = readInt("ID (integer): ", 1, 999999);
+    if (animalMgr.animalIndex.count(id) || (pending && pending->count(id))) {
+      cout << "  ▶ ID " << id << " is already in use." << endl;
+    } else if (studbook.find(id)) {
+      cout << "  ▶ ID " << id << " belongs to an animal in the studbook; "
+           << "IDs are never reused." << endl;
+    } else {
+      return id;
+    }
+  }
+}
+
+// Helper: print the intake alerts raised by the feedings just recorded
+static void printIntakeAlerts(AnimalCareManager &careMgr) {
+  for (const IntakeAlert &alert : careMgr.takeAlerts()) {
+    cout << "[Alert] Animal " << alert.animalId << " was fed " << alert.amount
+         << "kg; its baseline is " << alert.mean << "kg (sd " << alert.stdDev
+         << ", z = " << alert.zScore << ")\n";
+  }
+}
+
 // Helper: prompt for double within [minV, maxV], with validation
 static double readDouble(const string &prompt, double minV, double maxV) {
   double x;
@@ -55,12 +102,171 @@ static double readDouble(const string &prompt, double minV, double maxV) {
   }
 }
 
-// Entry point for the console UI
-void runUserInterface() {
-  // Initialize database (file: zoo.db)
-  Database db("zoo.db");
+// Helper: prompt for a YYYY-MM-DD date and return local midnight as time_t
+static time_t readDate(const string &prompt) {
+  while (true) {
+    cout << prompt;
+    string line;
+    std::getline(cin, line);
+    std::tm tm{};
+    if (std::sscanf(line.c_str(), "%d-%d-%d", &tm.tm_year, &tm.tm_mon,
+                    &tm.tm_mday) == 3) {
+      tm.tm_year -= 1900;
+      tm.tm_mon -= 1;
+      tm.tm_isdst = -1;
+      time_t t = std::mktime(&tm);
+      if (t != static_cast<time_t>(-1)) {
+        return t;
+      }
+    }
+    cout << "  ▶ Please enter a date as YYYY-MM-DD." << endl;
+  }
+}
 
-  // Ensure tables exist
+// Helper: print aggregate rows, showing only the dimensions that were grouped
+static void printCareStats(const CareAggregate &agg, const CareQuery &q) {
+  if (agg.empty()) {
+    cout << "No matching care records.\n";
+    return;
+  }
+  for (const auto &[key, totals] : sortedRows(agg)) {
+    string label;
+    if (q.groupBy & GROUP_TIME) {
+      char date[16];
+      std::tm tm{};
+      gmtime_r(&key.bucket, &tm);
+      std::strftime(date, sizeof(date),
+                    q.bucket == TimeBucket::Month ? "%Y-%m" : "%Y-%m-%d", &tm);
+      label += string(date) + " ";
+    }
+    if (q.groupBy & GROUP_ANIMAL)
+      label += "animal " + std::to_string(key.animalId) + " ";
+    if (q.groupBy & GROUP_SPECIES)
+      label += key.species + " ";
+    if (q.groupBy & GROUP_EXHIBIT)
+      label += key.exhibit + " ";
+    if (q.groupBy & GROUP_FOOD)
+      label += key.foodType + " ";
+    if (q.groupBy & GROUP_VET)
+      label += key.vetName + " ";
+    cout << "  " << label << "| " << totals.feedings << " feeding(s), "
+         << totals.kilograms << " kg, " << totals.healthChecks
+         << " health check(s)\n";
+  }
+}
+
+// Helper: draw the zoo map. Exhibits show as letters (A-Z then a-z, '+'
+// after that) with '=' at the entrance, '#' is blocked, 'G' is the gate and
+// 'o' marks the optional route.
+static void printZooMap(const Simulation &sim,
+                        const std::vector<MapPoint> &route) {
+  const ZooMap &map = sim.getMap();
+  const World &world = sim.getWorld();
+  const int w = map.getWidth();
+  std::vector<string> rows(map.getHeight(), string(w, '.'));
+  for (int y = 0; y < map.getHeight(); ++y) {
+    for (int x = 0; x < w; ++x) {
+      if (map.tileAt(x, y) == ZooMap::Blocked) {
+        rows[y][x] = '#';
+      }
+    }
+  }
+  auto letter = [](size_t row) {
+    return row < 26 ? char('A' + row) : row < 52 ? char('a' + row - 26) : '+';
+  };
+  for (size_t e = 0; e < map.plotCount(); ++e) {
+    const ExhibitPlot &p = map.getPlot(static_cast<int>(e));
+    if (!p.placed()) {
+      continue;
+    }
+    for (int y = p.y; y < p.y + p.h; ++y) {
+      for (int x = p.x; x < p.x + p.w; ++x) {
+        rows[y][x] = letter(e);
+      }
+    }
+    rows[p.entrance().y][p.entrance().x] = '=';
+  }
+  for (const MapPoint &pt : route) {
+    rows[pt.y][pt.x] = 'o';
+  }
+  rows[0][0] = 'G';
+  for (const string &row : rows) {
+    cout << "  " << row << "\n";
+  }
+  for (size_t e = 0; e < map.plotCount(); ++e) {
+    const ExhibitPlot &p = map.getPlot(static_cast<int>(e));
+    cout << "  " << letter(e) << " = " << world.exhibits.name[e];
+    if (p.placed()) {
+      cout << " at (" << p.x << ", " << p.y << "), " << p.w << "x" << p.h;
+    } else {
+      cout << " (not on the map)";
+    }
+    cout << "\n";
+  }
+}
+
+// Helper: print an outbreak's course (about 20 lines however long it ran)
+// and the exhibits that had the most cases
+static void printOutbreak(const OutbreakModel &model,
+                          const std::vector<OutbreakDay> &curve,
+                          const World &world) {
+  const size_t every = std::max<size_t>(1, curve.size() / 20);
+  OutbreakDay peak;
+  for (size_t i = 0; i < curve.size(); ++i) {
+    const OutbreakDay &d = curve[i];
+    if (d.infected > peak.infected) {
+      peak = d;
+    }
+    if (i % every == 0 || i + 1 == curve.size()) {
+      cout << "  Day " << d.day << ": " << d.infected << " infected, "
+           << d.recovered << " recovered, " << d.susceptible
+           << " susceptible (" << d.newCases << " new)\n";
+    }
+  }
+  const OutbreakDay end = model.totals();
+  cout << (end.infected > 0 ? "Still spreading" : "Over") << " after "
+       << end.day << " day(s); peak of " << peak.infected << " on day "
+       << peak.day << ".\n";
+  const std::vector<int> &cases = model.getCases();
+  std::vector<size_t> worst;
+  for (size_t e = 0; e < world.exhibits.size(); ++e) {
+    if (cases[e] > 0) {
+      worst.push_back(e);
+    }
+  }
+  const size_t shown = std::min<size_t>(worst.size(), 5);
+  std::partial_sort(worst.begin(), worst.begin() + shown, worst.end(),
+                    [&](size_t a, size_t b) { return cases[a] > cases[b]; });
+  for (size_t i = 0; i < shown; ++i) {
+    cout << "  " << world.exhibits.name[worst[i]] << ": " << cases[worst[i]]
+         << " case(s) among " << world.exhibits.occupancy[worst[i]]
+         << " animal(s)\n";
+  }
+}
+
+// Adds a column ("name TYPE") to an existing table that lacks it
+static void addColumnIfMissing(Database &db, const std::string &table,
+                               const std::string &column) {
+  const std::string name = column.substr(0, column.find(' '));
+  sqlite3_stmt *stmt = nullptr;
+  const std::string sql = "SELECT 1 FROM pragma_table_info('" + table +
+                          "') WHERE name = ?;";
+  if (sqlite3_prepare_v2(db.get(), sql.c_str(), -1, &stmt, nullptr) !=
+      SQLITE_OK) {
+    std::cerr << "[Error] Failed to prepare statement: "
+              << sqlite3_errmsg(db.get()) << std::endl;
+    return;
+  }
+  sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
+  const bool present = sqlite3_step(stmt) == SQLITE_ROW;
+  sqlite3_finalize(stmt);
+  if (!present) {
+    db.execute("ALTER TABLE " + table + " ADD COLUMN " + column + ";");
+  }
+}
+
+// Creates every table (and index) the application uses, if missing
+void initializeDatabase(Database &db) {
   db.execute("CREATE TABLE IF NOT EXISTS Animals ("
              "id INTEGER PRIMARY KEY, name TEXT, species TEXT, age INTEGER, "
              "exhibit TEXT);");
@@ -68,17 +274,67 @@ void runUserInterface() {
              "name TEXT PRIMARY KEY, type TEXT, capacity INTEGER);");
   db.execute("CREATE TABLE IF NOT EXISTS CareRecords ("
              "id INTEGER PRIMARY KEY AUTOINCREMENT, animal_id INTEGER, type "
-             "TEXT, details TEXT, timestamp TEXT);");
+             "TEXT, details TEXT, timestamp TEXT, food TEXT, amount REAL, "
+             "vet TEXT, notes TEXT, diagnosis TEXT);");
+  // Tables created before the structured columns existed; their old rows
+  // keep NULLs there
+  for (const char *column : {"food TEXT", "amount REAL", "vet TEXT",
+                             "notes TEXT", "diagnosis TEXT"}) {
+    addColumnIfMissing(db, "CareRecords", column);
+  }
+  db.execute("CREATE INDEX IF NOT EXISTS idx_care_animal_time ON CareRecords "
+             "(animal_id, timestamp);");
+  db.execute("CREATE TABLE IF NOT EXISTS HabitatRules ("
+             "species TEXT, habitat TEXT, PRIMARY KEY (species, habitat));");
+  db.execute("CREATE TABLE IF NOT EXISTS CarePlans ("
+             "animal_id INTEGER, type TEXT, interval_seconds INTEGER, "
+             "PRIMARY KEY (animal_id, type));");
+  db.execute("CREATE TABLE IF NOT EXISTS CareArchive ("
+             "month INTEGER PRIMARY KEY, min_time INTEGER, max_time INTEGER, "
+             "min_animal INTEGER, max_animal INTEGER, row_count INTEGER, "
+             "data BLOB);");
+  db.execute("CREATE TABLE IF NOT EXISTS Studbook ("
+             "seq INTEGER PRIMARY KEY AUTOINCREMENT, animal_id INTEGER "
+             "UNIQUE, species TEXT, sire INTEGER, dam INTEGER, genome BLOB);");
+  db.execute("CREATE TABLE IF NOT EXISTS SimSaves ("
+             "seq INTEGER PRIMARY KEY AUTOINCREMENT, is_base INTEGER, "
+             "tick INTEGER, data BLOB, build TEXT);");
+  addColumnIfMissing(db, "SimSaves", "build TEXT"); // NULL: unknown build
+  db.execute("CREATE TABLE IF NOT EXISTS IntakeBaselines ("
+             "animal_id INTEGER PRIMARY KEY, mean REAL, variance REAL, "
+             "samples INTEGER);");
+}
+
+// Entry point for the console UI
+void runUserInterface(const std::string &recordPath) {
+  // Initialize database (file: zoo.db)
+  Database db("zoo.db");
+
+  // Ensure tables exist
+  initializeDatabase(db);
 
   // Instantiate managers
   ExhibitManager exhibitMgr;
   AnimalManager animalMgr;
   AnimalCareManager careMgr;
+  Studbook studbook;
+  PlacementEngine placer;
+  JobSystem jobs;
+  Simulation sim;
+  sim.setJobSystem(&jobs);
 
   // Load persisted data
   exhibitMgr.loadFromDatabase(db);
   animalMgr.loadFromDatabase(exhibitMgr, db);
   careMgr.loadFromDatabase(db);
+  careMgr.getScheduler().loadFromDatabase(db);
+  placer.loadRulesFromDatabase(db);
+  studbook.loadFromDatabase(db);
+  sim.loadFromDatabase(db);
+  sim.sync(animalMgr, exhibitMgr);
+  if (!recordPath.empty() && sim.startRecording(recordPath)) {
+    cout << "Recording simulation inputs to " << recordPath << ".\n";
+  }
 
   // Add default exhibit if none loaded
   if (exhibitMgr.getExhibitCount() == 0) {
@@ -90,14 +346,21 @@ void runUserInterface() {
   bool exitProgram = false;
 
   while (!exitProgram) {
+    // Autosave care records and the simulation; each save only writes what
+    // changed since the last one, and nothing if nothing did
+    careMgr.saveToDatabase(db);
+    sim.sync(animalMgr, exhibitMgr);
+    sim.saveToDatabase(db);
+
     // Main menu
     cout << "\n=== Zoo Management Main Menu ===\n"
          << "1) Animals\n"
          << "2) Exhibits\n"
          << "3) Health Care\n"
-         << "4) Exit\n";
+         << "4) Simulation\n"
+         << "5) Exit\n";
 
-    int choice = readInt("Choose an option: ", 1, 4);
+    int choice = readInt("Choose an option: ", 1, 5);
     switch (choice) {
     case 1: { // ANIMALS MENU
       bool back = false;
@@ -107,8 +370,10 @@ void runUserInterface() {
              << "2) View All Animals\n"
              << "3) Update Animal Information\n"
              << "4) Remove Animal\n"
-             << "5) Back to Main Menu\n";
-        int aopt = readInt("Choose: ", 1, 5);
+             << "5) Auto-Place Animal Batch\n"
+             << "6) Breeding Program\n"
+             << "7) Back to Main Menu\n";
+        int aopt = readInt("Choose: ", 1, 7);
         switch (aopt) {
         case 1: { // Add New Animal
           // Read name and species (allow spaces)
@@ -119,7 +384,7 @@ void runUserInterface() {
           string species;
           std::getline(cin, species);
 
-          int id = readInt("ID (integer): ", 1, 999999);
+          int id = readNewAnimalId(studbook, animalMgr);
           int age = readInt("Age: ", 0, 200);
 
           // Select exhibit
@@ -132,6 +397,7 @@ void runUserInterface() {
           if (!animalMgr.addAnimal(newA, ex, db)) {
             cout << "Sorry, that exhibit is full or invalid!\n";
           } else {
+            studbook.registerFounders({newA}, db);
             cout << "Animal '" << name << "' added successfully!\n";
           }
           
@@ -163,16 +429,145 @@ void runUserInterface() {
                     std::to_string(animalMgr.getAnimalCount() - 1) + "): ",
                 0, animalMgr.getAnimalCount() - 1);
             Animal &a = animalMgr.getAnimalByIndex(idx);
-            if (exhibitMgr.getExhibitByName(a.getExhibit())
-                    .removeAnimal(a.getName())) {
-              animalMgr.removeAnimal(a.getId());
+            int id = a.getId();
+            if (animalMgr.removeAnimal(id, exhibitMgr)) {
+              careMgr.getScheduler().removeAnimal(id);
+              careMgr.getMonitor().forget(id);
+              CareScheduler::removePlansFromDatabase(id, db);
               cout << "Animal removed successfully.\n";
             } else {
               cout << "Failed to remove animal from exhibit or manager.\n";
             }
           }
           break;
-        case 5: // Back
+        case 5: { // Auto-Place Animal Batch
+          int count = readInt("How many animals in this batch? ", 1, 100000);
+          std::vector<Animal> batch;
+          batch.reserve(count);
+          std::unordered_set<int> batchIds;
+          for (int i = 0; i < count; ++i) {
+            cout << "\nAnimal " << (i + 1) << " of " << count << "\n";
+            cout << "Name: ";
+            string name;
+            std::getline(cin, name);
+            cout << "Species: ";
+            string species;
+            std::getline(cin, species);
+            int id = readNewAnimalId(studbook, animalMgr, &batchIds);
+            batchIds.insert(id);
+            int age = readInt("Age: ", 0, 200);
+            batch.emplace_back(name, species, id, age, "");
+          }
+
+          PlacementPlan plan = placer.plan(batch, exhibitMgr);
+          cout << "Plan places " << plan.placed << " of " << count
+               << " animals across " << plan.exhibitsUsed << " exhibit(s)"
+               << (plan.exact ? " (exact)" : "") << ".\n";
+          int added =
+              animalMgr.addAnimals(batch, plan.exhibitOf, exhibitMgr, db);
+          if (added < 0) {
+            cout << "Batch rejected; no animals were added.\n";
+          } else {
+            studbook.registerFounders(animalMgr.animals, db);
+            cout << added << " animal(s) added.\n";
+          }
+          break;
+        }
+        case 6: { // Breeding Program
+          int registered = studbook.registerFounders(animalMgr.animals, db);
+          if (registered > 0) {
+            cout << registered
+                 << " animal(s) entered in the studbook as founders.\n";
+          }
+          cout << "\n-- Breeding Program --\n"
+               << "1) Breed Two Animals\n"
+               << "2) Recommend Mates\n"
+               << "3) View Pedigree\n"
+               << "4) Back\n";
+          int bopt = readInt("Choose: ", 1, 4);
+          if (bopt == 4 || animalMgr.getAnimalCount() == 0)
+            break;
+          animalMgr.viewAnimals();
+          const int lastIdx = animalMgr.getAnimalCount() - 1;
+          auto sexOf = [&](int id) {
+            const StudbookEntry *e = studbook.find(id);
+            return string(e && e->male() ? "male" : "female");
+          };
+          if (bopt == 1) {
+            int sireId =
+                animalMgr.getAnimalByIndex(readInt("Sire: ", 0, lastIdx))
+                    .getId();
+            int damId =
+                animalMgr.getAnimalByIndex(readInt("Dam: ", 0, lastIdx))
+                    .getId();
+            const StudbookEntry *sire = studbook.find(sireId);
+            const StudbookEntry *dam = studbook.find(damId);
+            if (!sire || !dam || !sire->male() || dam->male() ||
+                sire->species != dam->species) {
+              cout << "Breeding needs a male sire and a female dam of the "
+                      "same species.\n";
+              break;
+            }
+            cout << "Offspring name: ";
+            string name;
+            std::getline(cin, name);
+            int id = readNewAnimalId(studbook, animalMgr);
+            cout << "\nSelect Exhibit for the offspring:\n";
+            int exIdx = exhibitMgr.selectExhibit();
+            Exhibit &ex = exhibitMgr.getExhibitByIndex(exIdx);
+            Animal child(name, sire->species, id, 0, ex.getExhibitName());
+            if (!animalMgr.addAnimal(child, ex, db)) {
+              cout << "Sorry, that exhibit is full or invalid!\n";
+              break;
+            }
+            studbook.addOffspring(id, sireId, damId);
+            Studbook::saveEntryToDatabase(*studbook.find(id), db);
+            cout << "'" << name << "' was born (" << sexOf(id)
+                 << "), inbreeding coefficient " << studbook.inbreeding(id)
+                 << ".\n";
+          } else if (bopt == 2) {
+            const Animal &a =
+                animalMgr.getAnimalByIndex(readInt("Animal: ", 0, lastIdx));
+            std::vector<MateSuggestion> mates =
+                studbook.recommendMates(a.getId(), animalMgr.animals, 5);
+            if (mates.empty()) {
+              cout << "No " << a.getSpecies() << " of the opposite sex to "
+                   << "pair with.\n";
+              break;
+            }
+            std::unordered_map<int, string> names;
+            for (const Animal &other : animalMgr.animals) {
+              names.emplace(other.getId(), other.getName());
+            }
+            cout << "Best mates for '" << a.getName() << "' ("
+                 << sexOf(a.getId()) << "):\n";
+            for (const MateSuggestion &m : mates) {
+              cout << "  " << names[m.animalId] << " (ID " << m.animalId
+                   << "): offspring inbreeding " << m.kinship << ", "
+                   << m.distance << " of " << GENOME_BITS
+                   << " genes differ\n";
+            }
+          } else {
+            const Animal &a =
+                animalMgr.getAnimalByIndex(readInt("Animal: ", 0, lastIdx));
+            const StudbookEntry *e = studbook.find(a.getId());
+            if (!e) {
+              cout << "'" << a.getName() << "' is not in the studbook.\n";
+              break;
+            }
+            cout << "'" << a.getName() << "' (" << sexOf(a.getId()) << ", "
+                 << e->species << "): ";
+            if (e->sire == 0 && e->dam == 0) {
+              cout << "founder";
+            } else {
+              cout << "sire " << e->sire << ", dam " << e->dam;
+            }
+            cout << ", inbreeding coefficient "
+                 << studbook.inbreeding(a.getId()) << "\n";
+          }
+          break;
+        }
+        case 7: // Back
           back = true;
           break;
         }
@@ -186,8 +581,10 @@ void runUserInterface() {
              << "1) Add New Exhibit\n"
              << "2) View All Exhibits\n"
              << "3) View Animals in Exhibit\n"
-             << "4) Back to Main Menu\n";
-        int eopt = readInt("Choose: ", 1, 4);
+             << "4) Add Habitat Rule\n"
+             << "5) Rebalance Exhibits\n"
+             << "6) Back to Main Menu\n";
+        int eopt = readInt("Choose: ", 1, 6);
         switch (eopt) {
         case 1: { // Add Exhibit
           cout << "Exhibit Name: ";
@@ -212,10 +609,34 @@ void runUserInterface() {
               "Which exhibit index? (0-" +
                   std::to_string(exhibitMgr.getExhibitCount() - 1) + "): ",
               0, exhibitMgr.getExhibitCount() - 1);
-          exhibitMgr.viewAnimalsInExhibit(idx);
+          animalMgr.viewAnimalsInExhibit(exhibitMgr.getExhibitByIndex(idx));
+          break;
+        }
+        case 4: { // Add Habitat Rule
+          cout << "Species: ";
+          string species;
+          std::getline(cin, species);
+          cout << "Allowed exhibit type: ";
+          string habitat;
+          std::getline(cin, habitat);
+          placer.addHabitatRule(species, habitat);
+          placer.saveRuleToDatabase(species, habitat, db);
+          cout << "'" << species << "' may now live in '" << habitat
+               << "' exhibits.\n";
+          break;
+        }
+        case 5: { // Rebalance Exhibits
+          std::vector<RebalanceMove> moves = RebalancePlanner::plan(exhibitMgr);
+          if (moves.empty()) {
+            cout << "Exhibits are already balanced.\n";
+          } else if (animalMgr.moveAnimals(moves, exhibitMgr, db)) {
+            cout << "Rebalanced with " << moves.size() << " move(s).\n";
+          } else {
+            cout << "Rebalance failed; no animals were moved.\n";
+          }
           break;
         }
-        case 4:
+        case 6:
           back = true;
           break;
         }
@@ -229,8 +650,16 @@ void runUserInterface() {
              << "1) Record Feeding\n"
              << "2) Record Health Check\n"
              << "3) View Care Records\n"
-             << "4) Back to Main Menu\n";
-        int hopt = readInt("Choose: ", 1, 4);
+             << "4) View Care Records in Date Range\n"
+             << "5) Care Statistics\n"
+             << "6) Set Care Plan\n"
+             << "7) View Due Care\n"
+             << "8) Archive Old Care Records\n"
+             << "9) Feeding Round for Exhibit\n"
+             << "10) Plan Keeper Rounds\n"
+             << "11) Outbreak Scenario\n"
+             << "12) Back to Main Menu\n";
+        int hopt = readInt("Choose: ", 1, 12);
         switch (hopt) {
         case 1: { // Feeding
           animalMgr.viewAnimals();
@@ -243,9 +672,11 @@ void runUserInterface() {
           string food;
           std::getline(cin, food);
           double amt = readDouble("Amount (kg): ", 0.0, 1000.0);
-          careMgr.recordFeeding(a.getId(), food, amt);
-          careMgr.saveFeedingToDatabase(a.getId(), food, amt, db);
+          const time_t now = std::time(nullptr);
+          careMgr.recordFeeding(a.getId(), food, amt, now);
+          sim.feed(a.getId(), amt);
           cout << "Feeding record added for '" << a.getName() << "'.\n";
+          printIntakeAlerts(careMgr);
           break;
         }
         case 2: { // Health Check
@@ -264,8 +695,8 @@ void runUserInterface() {
           cout << "Notes: ";
           string notes;
           std::getline(cin, notes);
-          careMgr.recordHealthCheck(a.getId(), vet, notes, diag);
-          careMgr.saveHealthToDatabase(a.getId(), vet, notes, diag, db);
+          const time_t now = std::time(nullptr);
+          careMgr.recordHealthCheck(a.getId(), vet, notes, diag, now);
           cout << "Health record added for '" << a.getName() << "'.\n";
           break;
         }
@@ -280,13 +711,461 @@ void runUserInterface() {
           careMgr.displayCareRecords(a.getId());
           break;
         }
-        case 4:
+        case 4: { // View Care in Date Range
+          animalMgr.viewAnimals();
+          if (animalMgr.getAnimalCount() == 0)
+            break;
+          int aidx =
+              readInt("Select animal: ", 0, animalMgr.getAnimalCount() - 1);
+          Animal &a = animalMgr.getAnimalByIndex(aidx);
+          time_t from = readDate("From (YYYY-MM-DD): ");
+          time_t through = readDate("Through (YYYY-MM-DD): ");
+          // Next local midnight after 'through', so the last day is included
+          std::tm end{};
+          localtime_r(&through, &end);
+          end.tm_mday += 1;
+          end.tm_isdst = -1;
+          time_t to = std::mktime(&end);
+          int kind =
+              readInt("Type (0 = all, 1 = feeding, 2 = health): ", 0, 2);
+          CareType filter = kind == 1   ? CareType::Feeding
+                            : kind == 2 ? CareType::Health
+                                        : CareType::Any;
+
+          // Stored and archived history plus this session's records
+          cout << "\nCare Records for '" << a.getName() << "':\n";
+          std::vector<StoredCareRecord> found =
+              careMgr.allRecordsBetween(a.getId(), from, to, filter, db);
+          if (found.empty()) {
+            cout << "No records in that range.\n";
+          }
+          TimestampFormatter timeFmt;
+          string line;
+          for (const StoredCareRecord &r : found) {
+            line.clear();
+            timeFmt.formatTo(line, r.time);
+            line += r.type == "feeding" ? " - [FEEDING] " : " - [HEALTH] ";
+            line += r.details;
+            cout << line << '\n';
+          }
+          break;
+        }
+        case 5: { // Care Statistics
+          cout << "1) Kg fed per species per day\n"
+               << "2) Feedings per food type\n"
+               << "3) Health checks per vet per month\n"
+               << "4) Care totals per exhibit\n"
+               << "5) Feeding amounts for one animal\n";
+          int report = readInt("Report: ", 1, 5);
+          if (report == 5) {
+            animalMgr.viewAnimals();
+            if (animalMgr.getAnimalCount() == 0)
+              break;
+            int aidx =
+                readInt("Select animal: ", 0, animalMgr.getAnimalCount() - 1);
+            int id = animalMgr.getAnimalByIndex(aidx).getId();
+            const time_t from = std::numeric_limits<time_t>::min();
+            const time_t to = std::numeric_limits<time_t>::max();
+            AmountStats st = careMgr.feedingStats(id, from, to, db);
+            if (st.count == 0) {
+              cout << "No feedings recorded.\n";
+              break;
+            }
+            cout << "  " << st.count << " feeding(s), total " << st.sum
+                 << " kg, mean " << st.mean() << " kg, range " << st.min
+                 << "-" << st.max << " kg\n";
+            if (const IntakeBaseline *b = careMgr.getMonitor().baseline(id)) {
+              cout << "  Recent baseline: " << b->mean << " kg (sd "
+                   << std::sqrt(b->variance) << ", " << b->samples
+                   << " feeding(s))\n";
+            }
+            // Five equal-width buckets spanning the observed range
+            const size_t buckets = 5;
+            double width = (st.max - st.min) / buckets;
+            if (width <= 0)
+              width = 1.0;
+            auto hist = careMgr.feedingHistogram(id, from, to, st.min, width,
+                                                 buckets, db);
+            for (size_t b = 0; b < buckets; ++b) {
+              cout << "  " << st.min + b * width << " kg+ | "
+                   << string(std::min(hist[b], 40L), '#') << " " << hist[b]
+                   << '\n';
+            }
+            break;
+          }
+          CareQuery q;
+          switch (report) {
+          case 1:
+            q.groupBy = GROUP_SPECIES | GROUP_TIME;
+            q.filter = CareType::Feeding;
+            break;
+          case 2:
+            q.groupBy = GROUP_FOOD;
+            q.filter = CareType::Feeding;
+            break;
+          case 3:
+            q.groupBy = GROUP_VET | GROUP_TIME;
+            q.bucket = TimeBucket::Month;
+            q.filter = CareType::Health;
+            break;
+          case 4:
+            q.groupBy = GROUP_EXHIBIT;
+            break;
+          }
+          printCareStats(careMgr.aggregate(q, animalMgr.animals, db, &jobs),
+                         q);
+          break;
+        }
+        case 6: { // Set Care Plan
+          animalMgr.viewAnimals();
+          if (animalMgr.getAnimalCount() == 0)
+            break;
+          int aidx =
+              readInt("Select animal: ", 0, animalMgr.getAnimalCount() - 1);
+          Animal &a = animalMgr.getAnimalByIndex(aidx);
+          CareType kind = readInt("Type (1 = feeding, 2 = health): ", 1, 2) == 1
+                              ? CareType::Feeding
+                              : CareType::Health;
+          int hours = readInt("Every how many hours? (0 = remove plan): ", 0,
+                              24 * 365);
+          CareScheduler &sched = careMgr.getScheduler();
+          if (hours == 0) {
+            sched.removePlan(a.getId(), kind);
+            CareScheduler::removePlanFromDatabase(a.getId(), kind, db);
+            cout << "Care plan removed.\n";
+            break;
+          }
+          time_t interval = static_cast<time_t>(hours) * 3600;
+          // Counts from now; the next recorded care re-arms it from then on
+          sched.setPlan(a.getId(), kind, interval, std::time(nullptr));
+          if (CareScheduler::savePlanToDatabase(a.getId(), kind, interval,
+                                                db)) {
+            cout << "Care plan saved for '" << a.getName() << "'.\n";
+          }
+          break;
+        }
+        case 7: { // View Due Care
+          time_t now = std::time(nullptr);
+          auto dueList = careMgr.getScheduler().dueCare(now);
+          if (dueList.empty()) {
+            cout << "Nothing is due.\n";
+            break;
+          }
+          std::unordered_map<int, string> names;
+          for (const Animal &a : animalMgr.animals) {
+            names.emplace(a.getId(), a.getName());
+          }
+          for (const DueCare &d : dueList) {
+            auto found = names.find(d.animalId);
+            string name = found != names.end()
+                              ? found->second
+                              : "animal " + std::to_string(d.animalId);
+            cout << "  " << name << " - "
+                 << (d.kind == CareType::Feeding ? "feeding" : "health check")
+                 << " overdue by " << (now - d.dueAt) / 60 << " min\n";
+          }
+          break;
+        }
+        case 8: { // Archive Old Care Records
+          int days = readInt("Archive records older than how many days? ", 1,
+                             36500);
+          time_t cutoff =
+              std::time(nullptr) - static_cast<time_t>(days) * 86400;
+          int released = careMgr.archiveBefore(cutoff);
+          if (released < 0) {
+            cout << "Failed to archive in-memory records; they are kept.\n";
+            break;
+          }
+          int kept = 0;
+          int stored =
+              AnimalCareManager::archiveDatabaseBefore(cutoff, db, &kept);
+          if (stored < 0) {
+            cout << "Failed to archive stored records.\n";
+            break;
+          }
+          const CareArchive &archive = careMgr.getArchive();
+          cout << "Archived " << released << " day(s) in memory and "
+               << stored << " stored record(s).\n";
+          if (kept > 0) {
+            cout << kept << " older stored record(s) could not be split "
+                 << "into fields exactly and stay in CareRecords.\n";
+          }
+          cout
+               << "In-memory archive: " << archive.rowCount()
+               << " record(s) in " << archive.encodedBytes() << " bytes.\n";
+          break;
+        }
+        case 9: { // Feeding Round for Exhibit
+          exhibitMgr.viewExhibits();
+          int exIdx = readInt(
+              "Which exhibit index? (0-" +
+                  std::to_string(exhibitMgr.getExhibitCount() - 1) + "): ",
+              0, exhibitMgr.getExhibitCount() - 1);
+          const Exhibit &ex = exhibitMgr.getExhibitByIndex(exIdx);
+          std::vector<const Animal *> residents = animalMgr.residentsOf(ex);
+          if (residents.empty()) {
+            cout << "No animals in '" << ex.getExhibitName() << "'.\n";
+            break;
+          }
+          cout << "Food type: ";
+          string food;
+          std::getline(cin, food);
+          int mode = readInt("Amount (1 = same for all, 2 = per animal): ", 1,
+                             2);
+          std::vector<FeedingEntry> round;
+          round.reserve(residents.size());
+          if (mode == 1) {
+            double amt = readDouble("Amount per animal (kg): ", 0.0, 1000.0);
+            for (const Animal *a : residents) {
+              round.push_back({a->getId(), food, amt});
+            }
+          } else {
+            cout << "(0 skips an animal)\n";
+            for (const Animal *a : residents) {
+              double amt =
+                  readDouble("  " + a->getName() + " (kg): ", 0.0, 1000.0);
+              if (amt > 0) {
+                round.push_back({a->getId(), food, amt});
+              }
+            }
+          }
+          int saved = careMgr.recordFeedings(round, db);
+          if (saved < 0) {
+            cout << "Feeding round failed; nothing was recorded.\n";
+          } else {
+            for (const FeedingEntry &f : round) {
+              sim.feed(f.animalId, f.amount);
+            }
+            cout << "Recorded " << saved << " feeding(s) in '"
+                 << ex.getExhibitName() << "'.\n";
+            printIntakeAlerts(careMgr);
+          }
+          break;
+        }
+        case 10: { // Plan Keeper Rounds
+          const World &world = sim.getWorld();
+          std::vector<double> demand = RoutePlanner::demandFromDue(
+              careMgr.getScheduler().dueCare(std::time(nullptr)), world,
+              readDouble("Ration per due feeding (kg): ", 0.1, 1000.0));
+          if (std::all_of(demand.begin(), demand.end(),
+                          [](double kg) { return kg <= 0.0; })) {
+            cout << "No feedings are due.\n";
+            break;
+          }
+          RoutePlanOptions opts;
+          opts.keepers = readInt("Keepers on shift: ", 1, 100);
+          opts.cartKg = readDouble("Cart load (kg): ", 1.0, 10000.0);
+          RoutePlan plan =
+              RoutePlanner::plan(sim.getMap(), demand, opts, &jobs);
+          for (std::size_t k = 0; k < plan.keepers.size(); ++k) {
+            const KeeperPlan &keeper = plan.keepers[k];
+            cout << "Keeper " << k + 1 << ": " << keeper.rounds.size()
+                 << " round(s), " << keeper.tiles << " tiles\n";
+            for (const KeeperRound &round : keeper.rounds) {
+              cout << "  " << round.kg << " kg, " << round.tiles
+                   << " tiles: kitchen";
+              for (int row : round.exhibits) {
+                cout << " -> " << world.exhibits.name[row];
+              }
+              cout << " -> kitchen\n";
+            }
+          }
+          for (int row : plan.unreachable) {
+            cout << "No path to '" << world.exhibits.name[row]
+                 << "'; feed it by hand.\n";
+          }
+          cout << "Total " << plan.tiles << " tiles, planned in "
+               << plan.milliseconds << " ms.\n";
+          break;
+        }
+        case 11: { // Outbreak Scenario
+          cout << "Disease (as written in diagnoses): ";
+          string disease;
+          std::getline(cin, disease);
+          int lookback =
+              readInt("Use health checks from the last how many days? ", 1,
+                      36500);
+          OutbreakParams params;
+          params.seed = sim.getSeed();
+          OutbreakModel model(sim.getWorld(), sim.getMap(), params, &jobs);
+          time_t now = std::time(nullptr);
+          int seeded = model.seedFromDiagnoses(
+              careMgr, db, disease,
+              now - static_cast<time_t>(lookback) * 86400, now + 1);
+          if (seeded == 0) {
+            cout << "No simulated animal is diagnosed with '" << disease
+                 << "'.\n";
+            break;
+          }
+          int days = readInt("Days to simulate: ", 1, 3650);
+          auto started = std::chrono::steady_clock::now();
+          std::vector<OutbreakDay> curve = model.run(days, &jobs);
+          double ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - started)
+                          .count();
+          cout << seeded << " animal(s) start out infected.\n";
+          printOutbreak(model, curve, sim.getWorld());
+          cout << "Ran in " << ms << " ms.\n";
+          break;
+        }
+        case 12:
           backHC = true;
           break;
         }
       }
     } break;
-    case 4:
+    case 4: { // SIMULATION MENU
+      bool backSim = false;
+      while (!backSim) {
+        // Pick up any animals/exhibits added, moved or removed elsewhere
+        sim.sync(animalMgr, exhibitMgr);
+        cout << "\n-- Simulation Menu (day "
+             << sim.getTick() / Simulation::TICKS_PER_DAY << ", "
+             << sim.getHourOfDay() << ":00) --\n"
+             << "1) Run Simulation\n"
+             << "2) View Animal Status\n"
+             << "3) View Exhibit Status\n"
+             << "4) Clean Exhibit\n"
+             << "5) View Visitors\n"
+             << "6) Zoo Map\n"
+             << "7) Back to Main Menu\n";
+        int sopt = readInt("Choose: ", 1, 7);
+        const World &world = sim.getWorld();
+        switch (sopt) {
+        case 1: { // Run Simulation
+          int hours = readInt("Hours to simulate: ", 1, 24 * 365);
+          int ticks = sim.advance(hours);
+          cout << "Simulated " << ticks << " hour(s).\n";
+          break;
+        }
+        case 2: // View Animal Status
+          for (const Animal &a : animalMgr.animals) {
+            int row = world.animalRow(a.getId());
+            if (row < 0)
+              continue;
+            cout << "  " << a.getName() << " (ID " << a.getId()
+                 << "): hunger " << int(world.animals.hunger[row] * 100)
+                 << "%, health " << int(world.animals.health[row] * 100)
+                 << "%, happiness "
+                 << int(world.animals.happiness[row] * 100) << "%, age "
+                 << int(world.animals.ageDays[row]) << " days\n";
+          }
+          break;
+        case 3: // View Exhibit Status
+          for (size_t e = 0; e < world.exhibits.size(); ++e) {
+            cout << "  " << world.exhibits.name[e] << ": "
+                 << world.exhibits.occupancy[e] << "/"
+                 << world.exhibits.capacity[e] << " residents, cleanliness "
+                 << int(world.exhibits.cleanliness[e] * 100) << "%\n";
+          }
+          break;
+        case 4: { // Clean Exhibit
+          exhibitMgr.viewExhibits();
+          int idx = readInt(
+              "Which exhibit index? (0-" +
+                  std::to_string(exhibitMgr.getExhibitCount() - 1) + "): ",
+              0, exhibitMgr.getExhibitCount() - 1);
+          const Exhibit &ex = exhibitMgr.getExhibitByIndex(idx);
+          if (sim.cleanExhibit(ex.getExhibitName())) {
+            cout << "'" << ex.getExhibitName() << "' is spotless.\n";
+          }
+          break;
+        }
+        case 5: { // View Visitors
+          const VisitorCrowd &crowd = sim.getCrowd();
+          const VisitorEconomy &eco = crowd.getEconomy();
+          cout << "  " << eco.arrivedToday << " of " << eco.attendanceToday
+               << " expected visitor(s) arrived today, "
+               << crowd.getVisitors().size() << " in the zoo now\n"
+               << "  Reputation " << int(eco.reputation * 100)
+               << "%, revenue $" << static_cast<long long>(eco.revenueToday)
+               << " today, $" << static_cast<long long>(eco.revenueTotal)
+               << " total\n";
+          for (size_t e = 0; e < world.exhibits.size(); ++e) {
+            const ExhibitTraffic &t = crowd.getTraffic()[e];
+            cout << "  " << world.exhibits.name[e] << ": "
+                 << t.visitsToday << " visit(s) today (avg wait "
+                 << int(t.visitsToday ? t.waitMinutesToday / t.visitsToday
+                                      : 0.0)
+                 << " min), " << t.viewing << " watching, " << t.queued
+                 << " queueing, popularity " << int(t.popularity)
+                 << "/day\n";
+          }
+          break;
+        }
+        case 6: { // Zoo Map
+          const ZooMap &map = sim.getMap();
+          cout << "\n-- Zoo Map (" << map.getWidth() << "x"
+               << map.getHeight() << ") --\n"
+               << "1) View Map\n"
+               << "2) Find Route\n"
+               << "3) Move Exhibit\n"
+               << "4) Block/Unblock Tile\n"
+               << "5) Back\n";
+          int mopt = readInt("Choose: ", 1, 5);
+          const int last = static_cast<int>(world.exhibits.size()) - 1;
+          if (mopt == 1) {
+            printZooMap(sim, {});
+          } else if (mopt == 2 && last >= 0) {
+            printZooMap(sim, {});
+            int from = readInt("From exhibit row (-1 = gate, 0-" +
+                                   std::to_string(last) + "): ",
+                               -1, last);
+            int to = readInt("To exhibit row (0-" + std::to_string(last) +
+                                 "): ",
+                             0, last);
+            const MapPoint start =
+                from < 0 ? map.getGate() : map.getPlot(from).entrance();
+            std::vector<MapPoint> route = map.route(start, to);
+            if (route.empty()) {
+              cout << "No path between them.\n";
+            } else {
+              printZooMap(sim, route);
+              cout << "Route: " << route.size() - 1 << " tile(s).\n";
+            }
+          } else if (mopt == 3 && last >= 0) {
+            int row = readInt("Exhibit row (0-" + std::to_string(last) +
+                                  "): ",
+                              0, last);
+            ExhibitPlot plot = map.getPlot(row);
+            if (!plot.placed()) {
+              plot.w = plot.h =
+                  ZooMap::plotSide(world.exhibits.capacity[row]);
+            }
+            plot.x = readInt("New left column: ", 0, map.getWidth() - 1);
+            plot.y = readInt("New top row: ", 0, map.getHeight() - 1);
+            if (!sim.placeExhibit(world.exhibits.name[row], plot)) {
+              cout << "That spot is not free.\n";
+            }
+          } else if (mopt == 4) {
+            int x = readInt("Column: ", 0, map.getWidth() - 1);
+            int y = readInt("Row: ", 0, map.getHeight() - 1);
+            const bool blocked = map.tileAt(x, y) != ZooMap::Blocked;
+            if (!sim.setTileBlocked(x, y, blocked)) {
+              cout << "Only path tiles (not the gate or an entrance) can be "
+                      "blocked.\n";
+            } else {
+              cout << "Tile (" << x << ", " << y << ") is now "
+                   << (blocked ? "blocked" : "open") << ".\n";
+            }
+          }
+          break;
+        }
+        case 7:
+          backSim = true;
+          break;
+        }
+      }
+    } break;
+    case 5:
+      careMgr.saveToDatabase(db);
+      sim.sync(animalMgr, exhibitMgr);
+      sim.saveToDatabase(db, true); // Leave a base any build can load
+      if (sim.isRecording()) {
+        sim.stopRecording();
+        cout << "Input log saved to " << recordPath << " (state hash "
+             << std::hex << sim.stateHash() << std::dec << ").\n";
+      }
       cout << "Goodbye!\n";
       exitProgram = true;
       break;
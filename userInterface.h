@@ -5,12 +5,17 @@
 #define USER_INTERFACE_H
 
 #include "database.h" // Ensures Database type is available for UI initialization
+#include <string>     // Input log path
+
+// Creates every table and index the application uses, if missing.
+void initializeDatabase(Database &db);
 
 // Starts the interactive console user interface.
 // This function:
 //  - Initializes the SQLite database and tables
 //  - Loads existing data into managers
 //  - Presents menus for Animals, Exhibits, and Health Care operations
-void runUserInterface();
+//  - Records the simulation's inputs to 'recordPath' unless it is empty
+void runUserInterface(const std::string &recordPath = "");
 
 #endif // USER_INTERFACE_H
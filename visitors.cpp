@@ -0,0 +1,418 @@
+// visitors.cpp
+// Implements VisitorCrowd: arrivals, the per-chunk agent update, and the
+// daily bookkeeping of popularity, reputation and revenue.
+
+#include "visitors.h"
+#include <algorithm> // std::min, std::max, std::clamp, std::upper_bound
+#include <cctype>    // std::tolower
+#include <cmath>     // std::sqrt, std::floor
+#include <utility>   // std::pair
+
+// ===== Tuning =====
+static constexpr float kStepMinutes = 60.0f / VisitorCrowd::SUBSTEPS;
+static constexpr double kGuestsPerAnimal = 40.0; // Per day, at reputation 0.5
+static constexpr int kViewersPerPlace = 20;  // Per unit of exhibit capacity
+static constexpr float kMinutesPerTile = 0.25f; // Times 0.8 - 1.2
+static constexpr float kWalkMinutes = 5.0f; // Off the map: plus up to 10
+static constexpr float kWalkSpread = 10.0f;
+static constexpr float kDwellMinutes = 10.0f; // Plus more at better exhibits
+static constexpr float kDwellSpread = 20.0f;
+static constexpr float kPatienceMinutes = 15.0f; // Plus up to kPatienceSpread
+static constexpr float kPatienceSpread = 45.0f;
+static constexpr float kGiveUpPenalty = 0.5f; // Leaving a queue unserved
+static constexpr int kMinPlan = 3;            // Stops per visit: 3 - 8
+static constexpr int kPlanSpread = 6;
+static constexpr float kReputationRate = 0.02f; // Per hour with departures
+static constexpr float kPopularityRate = 0.3f;  // Per day
+
+// Share of the day's guests arriving in each opening hour (sums to 1)
+static constexpr double kArrivalShare[VisitorCrowd::CLOSE_HOUR -
+                                      VisitorCrowd::OPEN_HOUR] = {
+    0.18, 0.20, 0.17, 0.13, 0.12, 0.10, 0.06, 0.04, 0.0};
+
+// Visitors per chunk: 16K timers/states stay in L2 between the two passes,
+// and a few hundred thousand visitors still spread over 16+ workers
+static constexpr std::size_t kChunkVisitors = 16384;
+
+// Salts of the random streams, one per kind of decision
+enum Draw : std::uint64_t { DrawPlan = 1, DrawPatience, DrawAdmit, DrawPick,
+                            DrawWalk, DrawDwell };
+
+// typeAppeal
+//  - Keyword match on the lowercased type, so "Tropical Rainforest" and
+//    "rainforest" score the same
+float VisitorCrowd::typeAppeal(const std::string &exhibitType) {
+  static const std::pair<const char *, float> kAppeal[] = {
+      {"aqua", 1.4f},      {"ocean", 1.4f},     {"marine", 1.4f},
+      {"rainforest", 1.3f}, {"jungle", 1.3f},   {"arctic", 1.3f},
+      {"polar", 1.3f},     {"savann", 1.2f},    {"grassland", 1.2f},
+      {"aviary", 1.1f},    {"bird", 1.1f},      {"reptile", 1.0f},
+      {"desert", 1.0f},    {"farm", 0.8f},      {"petting", 0.8f}};
+  std::string type;
+  for (char ch : exhibitType) {
+    type += static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+  }
+  for (const auto &[keyword, appeal] : kAppeal) {
+    if (type.find(keyword) != std::string::npos) {
+      return appeal;
+    }
+  }
+  return 1.0f;
+}
+
+// Patience a visitor brings to the queue at their 'stop'-th stop; a pure
+// function of the visitor, so the wait can be worked out on admission
+static float patienceOf(const SimRng &stream, std::uint32_t id, int stop) {
+  return kPatienceMinutes +
+         kPatienceSpread *
+             stream.uniform((static_cast<std::uint64_t>(id) << 8) | stop);
+}
+
+// refreshAttraction
+//  - Attraction = type appeal x sqrt(residents) x (0.5 + cleanliness / 2):
+//    more animals help, with diminishing returns; empty exhibits score 0,
+//    and so do placed exhibits with no path from the gate
+void VisitorCrowd::refreshAttraction(const World &world, const ZooMap &map) {
+  const ExhibitTable &ex = world.exhibits;
+  const std::size_t n = ex.size();
+  score.resize(n);
+  cumulative.resize(n);
+  viewCapacity.resize(n);
+  admit.resize(n);
+  float best = 0.0f;
+  double total = 0.0;
+  for (std::size_t e = 0; e < n; ++e) {
+    const float residents = static_cast<float>(std::max(0, ex.occupancy[e]));
+    const int row = static_cast<int>(e);
+    const bool reachable = !map.getPlot(row).placed() ||
+                           map.distance(-1, row) != ZooMap::UNREACHABLE;
+    const float a = reachable ? ex.appeal[e] * std::sqrt(residents) *
+                                    (0.5f + 0.5f * ex.cleanliness[e])
+                              : 0.0f;
+    traffic[e].attraction = a;
+    best = std::max(best, a);
+    total += a;
+    cumulative[e] = total;
+    viewCapacity[e] = std::max(1, ex.capacity[e]) * kViewersPerPlace;
+  }
+  for (std::size_t e = 0; e < n; ++e) {
+    score[e] = best > 0.0f ? traffic[e].attraction / best : 0.0f;
+  }
+}
+
+// openDay
+//  - Attendance follows the number of animals on show and the reputation
+void VisitorCrowd::openDay(const World &world) {
+  long long housed = 0;
+  for (int occupancy : world.exhibits.occupancy) {
+    housed += occupancy;
+  }
+  economy.attendanceToday = static_cast<long long>(std::floor(
+      kGuestsPerAnimal * static_cast<double>(housed) *
+      (0.5 + economy.reputation)));
+  economy.arrivedToday = 0;
+  economy.revenueToday = 0.0;
+  for (ExhibitTraffic &t : traffic) {
+    t.visitsToday = 0;
+    t.waitMinutesToday = 0.0;
+  }
+}
+
+void VisitorCrowd::arrive(long long count, const SimRng &lifetime) {
+  const SimRng planStream = lifetime.derive(DrawPlan);
+  const std::size_t n = visitors.size() + static_cast<std::size_t>(count);
+  visitors.id.reserve(n);
+  for (long long k = 0; k < count; ++k) {
+    const std::uint32_t id = economy.nextVisitorId++;
+    const int plan =
+        kMinPlan + static_cast<int>(planStream.uniform(id) * kPlanSpread);
+    visitors.id.push_back(id);
+    visitors.exhibit.push_back(-1);
+    visitors.state.push_back(VisitorTable::Choosing);
+    visitors.timer.push_back(0.0f);
+    visitors.satisfaction.push_back(0.0f);
+    visitors.stops.push_back(0);
+    visitors.plan.push_back(static_cast<std::uint8_t>(plan));
+  }
+  economy.arrivedToday += count;
+  economy.revenueToday += static_cast<double>(count) * TICKET_PRICE;
+  economy.revenueTotal += static_cast<double>(count) * TICKET_PRICE;
+}
+
+// runChunk
+//  - Pass 1 counts every clock down with no branches; pass 2 skips visitors
+//    still walking or watching (the common case) after one compare, and
+//    runs the state machine for the rest:
+//      Walking -> Queued on arrival; Queued -> Viewing when let in, or
+//      Choosing once out of patience; Viewing -> Choosing when done;
+//      Choosing -> Walking to the next pick, or Left after the last stop
+//  - Writes only its own visitors and its own tally
+void VisitorCrowd::runChunk(std::size_t chunk, const ZooMap &map,
+                            const SimRng &rng, const SimRng &lifetime) {
+  const std::size_t begin = chunk * kChunkVisitors;
+  const std::size_t end = std::min(visitors.size(), begin + kChunkVisitors);
+  float *timer = visitors.timer.data();
+  for (std::size_t i = begin; i < end; ++i) {
+    timer[i] -= kStepMinutes;
+  }
+
+  const SimRng patience = lifetime.derive(DrawPatience);
+  const SimRng admitDraw = rng.derive(DrawAdmit);
+  const SimRng pickDraw = rng.derive(DrawPick);
+  const SimRng walkDraw = rng.derive(DrawWalk);
+  const SimRng dwellDraw = rng.derive(DrawDwell);
+  const std::size_t exhibits = cumulative.size();
+  const double total = exhibits ? cumulative.back() : 0.0;
+  ChunkTally &t = tallies[chunk];
+  VisitorTable &v = visitors;
+  for (std::size_t i = begin; i < end; ++i) {
+    std::uint8_t st = v.state[i];
+    if (timer[i] > 0.0f && st != VisitorTable::Queued &&
+        st != VisitorTable::Choosing) {
+      if (st == VisitorTable::Viewing) {
+        ++t.viewing[v.exhibit[i]];
+      }
+      continue;
+    }
+    if (st == VisitorTable::Left) {
+      continue;
+    }
+    const std::uint32_t id = v.id[i];
+    const int e = v.exhibit[i];
+    if (st == VisitorTable::Walking) { // Arrived: join the queue
+      st = VisitorTable::Queued;
+      timer[i] = patienceOf(patience, id, v.stops[i]);
+    }
+    if (st == VisitorTable::Queued) {
+      if (admitDraw.uniform(id) < admit[e]) {
+        t.waitMinutes[e] += patienceOf(patience, id, v.stops[i]) - timer[i];
+        ++t.visits[e];
+        ++t.viewing[e];
+        timer[i] = kDwellMinutes +
+                   kDwellSpread * score[e] * (0.5f + dwellDraw.uniform(id));
+        v.state[i] = VisitorTable::Viewing;
+        continue;
+      }
+      if (timer[i] > 0.0f) {
+        ++t.queued[e];
+        v.state[i] = st;
+        continue;
+      }
+      v.satisfaction[i] -= kGiveUpPenalty;
+      ++v.stops[i];
+    } else if (st == VisitorTable::Viewing) {
+      v.satisfaction[i] += score[e];
+      ++v.stops[i];
+    }
+
+    // Choosing: on to the next exhibit, or home
+    if (v.stops[i] >= v.plan[i] || total <= 0.0) {
+      v.state[i] = VisitorTable::Left;
+      ++t.departures;
+      t.satisfaction += std::clamp(v.satisfaction[i] / v.plan[i], 0.0f, 1.0f);
+      continue;
+    }
+    const double u = pickDraw.uniform(id) * total;
+    const auto next = static_cast<std::size_t>(
+        std::upper_bound(cumulative.begin(), cumulative.end(), u) -
+        cumulative.begin());
+    const int to = static_cast<int>(std::min(next, exhibits - 1));
+    const int tiles = map.distance(e, to); // From here (-1: the gate)
+    timer[i] = tiles == ZooMap::UNREACHABLE
+                   ? kWalkMinutes + kWalkSpread * walkDraw.uniform(id)
+                   : kMinutesPerTile * static_cast<float>(tiles) *
+                         (0.8f + 0.4f * walkDraw.uniform(id));
+    v.exhibit[i] = to;
+    v.state[i] = VisitorTable::Walking;
+  }
+}
+
+// update
+//  - Each sub-step: arrivals due so far, admission odds from the counts of
+//    the previous sub-step (free places shared among those queueing), one
+//    pass over all visitors in chunks, then a merge in chunk order
+void VisitorCrowd::update(const World &world, const ZooMap &map, int hour,
+                          const SimRng &rng, const SimRng &lifetime,
+                          JobSystem *jobs) {
+  traffic.resize(world.exhibits.size());
+  if (hour == OPEN_HOUR) {
+    openDay(world);
+  } else if (hour == CLOSE_HOUR) {
+    closeDay();
+  }
+  if (hour >= OPEN_HOUR && hour < CLOSE_HOUR) {
+    refreshAttraction(world, map);
+    double shareBefore = 0.0;
+    for (int h = OPEN_HOUR; h < hour; ++h) {
+      shareBefore += kArrivalShare[h - OPEN_HOUR];
+    }
+    const std::size_t exhibits = traffic.size();
+    for (int s = 0; s < SUBSTEPS; ++s) {
+      const SimRng stepRng = rng.derive(static_cast<std::uint64_t>(s));
+      const double share =
+          shareBefore + kArrivalShare[hour - OPEN_HOUR] * (s + 1) / SUBSTEPS;
+      const auto due = static_cast<long long>(std::floor(
+          static_cast<double>(economy.attendanceToday) * share));
+      if (due > economy.arrivedToday) {
+        arrive(due - economy.arrivedToday, lifetime);
+      }
+      for (std::size_t e = 0; e < exhibits; ++e) {
+        const int free = std::max(0, viewCapacity[e] - traffic[e].viewing);
+        admit[e] = traffic[e].queued > 0
+                       ? std::min(1.0f, static_cast<float>(free) /
+                                            static_cast<float>(
+                                                traffic[e].queued))
+                       : (free > 0 ? 1.0f : 0.0f);
+      }
+
+      const std::size_t chunks =
+          (visitors.size() + kChunkVisitors - 1) / kChunkVisitors;
+      if (tallies.size() < chunks) {
+        tallies.resize(chunks);
+      }
+      for (std::size_t c = 0; c < chunks; ++c) {
+        ChunkTally &t = tallies[c];
+        t.viewing.assign(exhibits, 0);
+        t.queued.assign(exhibits, 0);
+        t.visits.assign(exhibits, 0);
+        t.waitMinutes.assign(exhibits, 0.0);
+        t.departures = 0;
+        t.satisfaction = 0.0;
+      }
+      auto body = [&](std::size_t b, std::size_t e) {
+        for (std::size_t c = b; c < e; ++c) {
+          runChunk(c, map, stepRng, lifetime);
+        }
+      };
+      if (jobs) {
+        jobs->parallelFor(chunks, 1, body);
+      } else {
+        body(0, chunks);
+      }
+
+      for (ExhibitTraffic &t : traffic) {
+        t.viewing = 0;
+        t.queued = 0;
+      }
+      long long visits = 0;
+      for (std::size_t c = 0; c < chunks; ++c) {
+        const ChunkTally &t = tallies[c];
+        for (std::size_t e = 0; e < exhibits; ++e) {
+          traffic[e].viewing += t.viewing[e];
+          traffic[e].queued += t.queued[e];
+          traffic[e].visitsToday += t.visits[e];
+          traffic[e].visitsTotal += t.visits[e];
+          traffic[e].waitMinutesToday += t.waitMinutes[e];
+          visits += t.visits[e];
+        }
+        hourDepartures += t.departures;
+        hourSatisfaction += t.satisfaction;
+      }
+      economy.revenueToday += static_cast<double>(visits) * SPEND_PER_VISIT;
+      economy.revenueTotal += static_cast<double>(visits) * SPEND_PER_VISIT;
+    }
+  }
+
+  if (hourDepartures > 0) {
+    const float mean = static_cast<float>(
+        hourSatisfaction / static_cast<double>(hourDepartures));
+    economy.reputation += kReputationRate * (mean - economy.reputation);
+    hourDepartures = 0;
+    hourSatisfaction = 0.0;
+    removeDeparted();
+  }
+}
+
+// closeDay
+//  - Whoever is still inside leaves with what they saw so far
+void VisitorCrowd::closeDay() {
+  for (std::size_t i = 0; i < visitors.size(); ++i) {
+    if (visitors.state[i] != VisitorTable::Left) {
+      visitors.state[i] = VisitorTable::Left;
+      ++hourDepartures;
+      hourSatisfaction += std::clamp(
+          visitors.satisfaction[i] / visitors.plan[i], 0.0f, 1.0f);
+    }
+  }
+  for (ExhibitTraffic &t : traffic) {
+    t.viewing = 0;
+    t.queued = 0;
+    t.popularity += kPopularityRate *
+                    (static_cast<float>(t.visitsToday) - t.popularity);
+  }
+}
+
+// removeDeparted
+//  - Stable compaction, so the remaining visitors keep their order (and
+//    with it their chunk)
+void VisitorCrowd::removeDeparted() {
+  VisitorTable &v = visitors;
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    if (v.state[i] == VisitorTable::Left) {
+      continue;
+    }
+    if (kept != i) {
+      v.id[kept] = v.id[i];
+      v.exhibit[kept] = v.exhibit[i];
+      v.state[kept] = v.state[i];
+      v.timer[kept] = v.timer[i];
+      v.satisfaction[kept] = v.satisfaction[i];
+      v.stops[kept] = v.stops[i];
+      v.plan[kept] = v.plan[i];
+    }
+    ++kept;
+  }
+  v.id.resize(kept);
+  v.exhibit.resize(kept);
+  v.state.resize(kept);
+  v.timer.resize(kept);
+  v.satisfaction.resize(kept);
+  v.stops.resize(kept);
+  v.plan.resize(kept);
+}
+
+void VisitorCrowd::exhibitAdded() { traffic.emplace_back(); }
+
+// exhibitRemoved
+//  - Mirrors World::destroy: the last row moves into 'row'
+void VisitorCrowd::exhibitRemoved(int row, int last) {
+  VisitorTable &v = visitors;
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    if (v.exhibit[i] == row) {
+      v.exhibit[i] = -1;
+      if (v.state[i] != VisitorTable::Left) {
+        v.state[i] = VisitorTable::Choosing;
+      }
+    } else if (v.exhibit[i] == last) {
+      v.exhibit[i] = row;
+    }
+  }
+  traffic[row] = traffic[last];
+  traffic.pop_back();
+}
+
+void VisitorCrowd::restoreVisitor(std::uint32_t id, int exhibit,
+                                  std::uint8_t state, float timer,
+                                  float satisfaction, int stops, int plan) {
+  visitors.id.push_back(id);
+  visitors.exhibit.push_back(exhibit);
+  visitors.state.push_back(state);
+  visitors.timer.push_back(timer);
+  visitors.satisfaction.push_back(satisfaction);
+  visitors.stops.push_back(static_cast<std::uint8_t>(stops));
+  visitors.plan.push_back(static_cast<std::uint8_t>(plan));
+  if (state == VisitorTable::Queued) {
+    ++traffic[exhibit].queued;
+  } else if (state == VisitorTable::Viewing) {
+    ++traffic[exhibit].viewing;
+  }
+}
+
+void VisitorCrowd::restoreTraffic(int row, const ExhibitTraffic &stats) {
+  ExhibitTraffic &t = traffic[row];
+  t.visitsToday = stats.visitsToday;
+  t.visitsTotal = stats.visitsTotal;
+  t.waitMinutesToday = stats.waitMinutesToday;
+  t.popularity = stats.popularity;
+}
@@ -0,0 +1,128 @@
+// visitors.h
+// Declaration of VisitorCrowd: the zoo's visitors as individual agents.
+// Every simulated hour guests arrive (more of them the better the zoo's
+// reputation), walk along the map's paths to an exhibit picked by its
+// attraction score (exhibits they cannot reach score nothing), queue
+// when it is full, watch for a while and move on, until they have made the
+// stops they came for. How much they enjoyed it feeds the reputation;
+// tickets and spending at popular exhibits feed the revenue.
+//
+// Agents are stored structure-of-arrays and updated in fixed-size chunks:
+// a branch-free pass counts every timer down, then a second pass over the
+// same (cache-resident) chunk handles the few agents whose timer ran out or
+// who are queueing. Chunk results are merged in chunk order, so the crowd
+// is deterministic for a given seed whatever the thread count.
+
+#ifndef VISITORS_H
+#define VISITORS_H
+
+#include "ecs.h"       // Exhibit components
+#include "jobSystem.h" // Parallel chunks
+#include "simRng.h"    // Per-visitor random draws
+#include "zooMap.h"    // Walking distances
+#include <cstddef>     // std::size_t
+#include <cstdint>     // Visitor IDs
+#include <string>      // Exhibit types
+#include <vector>      // Columns
+
+// Every visitor in the zoo; row i of each array is one visitor
+struct VisitorTable {
+  enum State : std::uint8_t { Choosing, Walking, Queued, Viewing, Left };
+
+  std::vector<std::uint32_t> id;     // Stable key for random draws
+  std::vector<std::int32_t> exhibit; // Exhibit row heading to/at, or -1
+  std::vector<std::uint8_t> state;
+  std::vector<float> timer;        // Minutes left walking/queueing/viewing
+  std::vector<float> satisfaction; // Summed over the stops made
+  std::vector<std::uint8_t> stops; // Exhibits seen or given up on
+  std::vector<std::uint8_t> plan;  // Stops the visitor came for
+
+  std::size_t size() const { return id.size(); }
+};
+
+// Visitor statistics of one exhibit (same row as in the ExhibitTable)
+struct ExhibitTraffic {
+  float attraction = 0.0f;       // Current score; 0 = nothing to see
+  int viewing = 0;               // Visitors watching now
+  int queued = 0;                // Visitors waiting now
+  long long visitsToday = 0;
+  long long visitsTotal = 0;
+  double waitMinutesToday = 0.0; // Queueing time of today's visits
+  float popularity = 0.0f;       // Smoothed visits per day
+};
+
+struct VisitorEconomy {
+  double revenueTotal = 0.0;
+  double revenueToday = 0.0;
+  float reputation = 0.5f;       // 0..1: running average guest satisfaction
+  long long attendanceToday = 0; // Guests expected today
+  long long arrivedToday = 0;
+  std::uint32_t nextVisitorId = 0;
+};
+
+class VisitorCrowd {
+public:
+  static constexpr int SUBSTEPS = 6; // 10-minute steps per simulated hour
+  static constexpr int OPEN_HOUR = 9;
+  static constexpr int CLOSE_HOUR = 18; // Everyone leaves at closing
+  static constexpr double TICKET_PRICE = 25.0;
+  static constexpr double SPEND_PER_VISIT = 2.0; // Snacks, souvenirs
+
+  // Visitor draw of an exhibit type, about 0.8 - 1.4 (1 if unknown)
+  static float typeAppeal(const std::string &exhibitType);
+
+  // Simulates one hour starting at 'hour' (0-23) of the simulated day
+  //  - rng: this hour's stream; lifetime: a stream fixed for the whole run
+  //  - Reads the World and map only; the map must be prepare()d
+  void update(const World &world, const ZooMap &map, int hour,
+              const SimRng &rng, const SimRng &lifetime, JobSystem *jobs);
+
+  // Keep the per-exhibit rows in step with the World's ExhibitTable; a
+  // removed exhibit's visitors pick somewhere else to go
+  void exhibitAdded();
+  void exhibitRemoved(int row, int last);
+
+  const VisitorTable &getVisitors() const { return visitors; }
+  const std::vector<ExhibitTraffic> &getTraffic() const { return traffic; }
+  const VisitorEconomy &getEconomy() const { return economy; }
+
+  // Restoring a snapshot (exhibit rows must exist already)
+  void restoreVisitor(std::uint32_t id, int exhibit, std::uint8_t state,
+                      float timer, float satisfaction, int stops, int plan);
+  void restoreTraffic(int row, const ExhibitTraffic &stats);
+  void restoreEconomy(const VisitorEconomy &e) { economy = e; }
+
+private:
+  // What one chunk of visitors did in one sub-step
+  struct ChunkTally {
+    std::vector<int> viewing;
+    std::vector<int> queued;
+    std::vector<int> visits;
+    std::vector<double> waitMinutes;
+    long long departures = 0;
+    double satisfaction = 0.0; // Of the departures, each 0..1
+  };
+
+  VisitorTable visitors;
+  std::vector<ExhibitTraffic> traffic;
+  VisitorEconomy economy;
+
+  // Per-hour scratch
+  std::vector<float> score;       // Attraction / best attraction
+  std::vector<double> cumulative; // Running attraction sums for picking
+  std::vector<int> viewCapacity;
+  std::vector<float> admit; // Chance a queued visitor gets in this step
+  std::vector<ChunkTally> tallies;
+  long long hourDepartures = 0;
+  double hourSatisfaction = 0.0;
+
+  void refreshAttraction(const World &world, const ZooMap &map);
+  void openDay(const World &world);
+  void arrive(long long count, const SimRng &rng);
+  void runChunk(std::size_t chunk, const ZooMap &map, const SimRng &rng,
+                const SimRng &lifetime);
+  void closeDay();
+  void removeDeparted();
+};
+
+#endif // VISITORS_H
@@ -0,0 +1,383 @@
+// zooMap.cpp
+// Implements ZooMap: grid edits, first-fit plot placement, and the cached
+// breadth-first entrance distances and flow field.
+
+#include "zooMap.h"
+#include <algorithm> // std::clamp, std::count, std::min
+#include <cmath>     // std::ceil, std::sqrt
+
+// 4-neighbourhood, in the fixed order routes try it
+static constexpr int kDx[4] = {-1, 1, 0, 0};
+static constexpr int kDy[4] = {0, 0, -1, 1};
+
+ZooMap::ZooMap(int width, int height)
+    : width(std::clamp(width, 1, MAX_SIDE)),
+      height(std::clamp(height, 1, MAX_SIDE)),
+      tiles(static_cast<std::size_t>(this->width) * this->height, Path) {}
+
+// touch
+//  - A row's distances only depend on the tiles its search reached: a tile
+//    on a shortest path was reached, and a newly opened tile can only make
+//    a shortcut next to one. Both lie in the search's bounding box grown by
+//    one tile.
+void ZooMap::touch(int x0, int y0, int x1, int y1) {
+  for (Reach &r : reach) {
+    if (!r.stale && x0 <= r.x1 + 1 && x1 >= r.x0 - 1 && y0 <= r.y1 + 1 &&
+        y1 >= r.y0 - 1) {
+      r.stale = true;
+    }
+  }
+  ++version;
+}
+
+void ZooMap::fill(const ExhibitPlot &plot, Tile tile) {
+  for (int y = plot.y; y < plot.y + plot.h; ++y) {
+    for (int x = plot.x; x < plot.x + plot.w; ++x) {
+      tiles[index(x, y)] = tile;
+    }
+  }
+}
+
+bool ZooMap::resize(int newWidth, int newHeight) {
+  if (newWidth < width || newHeight < height || newWidth > MAX_SIDE ||
+      newHeight > MAX_SIDE) {
+    return false;
+  }
+  if (newWidth == width && newHeight == height) {
+    return true;
+  }
+  std::vector<std::uint8_t> grown(
+      static_cast<std::size_t>(newWidth) * newHeight, Path);
+  for (int y = 0; y < height; ++y) {
+    std::copy(tiles.begin() + index(0, y), tiles.begin() + index(0, y) + width,
+              grown.begin() + static_cast<std::size_t>(y) * newWidth);
+  }
+  tiles = std::move(grown);
+  const int oldWidth = width, oldHeight = height;
+  width = newWidth;
+  height = newHeight;
+  touch(oldWidth, 0, width - 1, height - 1); // New path tiles
+  touch(0, oldHeight, width - 1, height - 1);
+  return true;
+}
+
+bool ZooMap::setBlocked(int x, int y, bool blocked) {
+  if (!inBounds(x, y) || (x == 0 && y == 0) || tileAt(x, y) == Plot) {
+    return false;
+  }
+  for (const ExhibitPlot &p : plots) {
+    if (p.placed() && p.entrance().x == x && p.entrance().y == y) {
+      return false;
+    }
+  }
+  const Tile tile = blocked ? Blocked : Path;
+  if (tileAt(x, y) != tile) {
+    tiles[index(x, y)] = tile;
+    touch(x, y, x, y);
+  }
+  return true;
+}
+
+// addPlot
+//  - An unplaced plot changes no distance, so the table stays; built rows
+//    get an unreachable entry for it
+void ZooMap::addPlot() {
+  plots.emplace_back();
+  for (Reach &r : reach) {
+    if (!r.toPlot.empty()) {
+      r.toPlot.push_back(kFar);
+    }
+  }
+  reach.emplace_back();
+}
+
+// removePlot
+//  - The table's rows and columns move the way the plots do
+void ZooMap::removePlot(int row, int last) {
+  const ExhibitPlot old = plots[row];
+  if (old.placed()) {
+    fill(old, Path);
+  }
+  plots[row] = plots[last];
+  plots.pop_back();
+  reach[row] = std::move(reach[last]);
+  reach.pop_back();
+  for (Reach &r : reach) {
+    if (!r.toPlot.empty()) {
+      r.toPlot[row] = r.toPlot[last];
+      r.toPlot.pop_back();
+    }
+  }
+  if (fieldRow == last) {
+    fieldRow = row;
+  } else if (fieldRow == row) {
+    fieldRow = -1;
+  }
+  if (old.placed()) {
+    touch(old);
+  }
+}
+
+// placePlot
+//  - The old plot is lifted first, so an exhibit can move onto tiles it
+//    partly covers already; on failure it is put back
+bool ZooMap::placePlot(int row, const ExhibitPlot &plot) {
+  if (plot.w < 1 || plot.h < 1 || plot.x < 0 || plot.y < 0 ||
+      plot.x + plot.w > width || plot.y + plot.h >= height ||
+      (plot.x == 0 && plot.y == 0)) {
+    return false;
+  }
+  const ExhibitPlot old = plots[row];
+  if (old.placed()) {
+    fill(old, Path);
+  }
+  bool ok = tileAt(plot.entrance().x, plot.entrance().y) == Path;
+  for (int y = plot.y; ok && y < plot.y + plot.h; ++y) {
+    for (int x = plot.x; ok && x < plot.x + plot.w; ++x) {
+      ok = tileAt(x, y) == Path;
+    }
+  }
+  for (std::size_t r = 0; ok && r < plots.size(); ++r) {
+    const ExhibitPlot &p = plots[r];
+    if (static_cast<int>(r) != row && p.placed()) {
+      const MapPoint e = p.entrance();
+      ok = e.x < plot.x || e.x >= plot.x + plot.w || e.y < plot.y ||
+           e.y >= plot.y + plot.h;
+    }
+  }
+  if (!ok) {
+    if (old.placed()) {
+      fill(old, Plot);
+    }
+    return false;
+  }
+  fill(plot, Plot);
+  plots[row] = plot;
+  if (old.placed()) {
+    touch(old);
+  }
+  touch(plot);
+  // The entrance moved. Other rows' entries for it are out of date, but
+  // distance() reads the pair from whichever row was searched last.
+  reach[row].stale = true;
+  return true;
+}
+
+int ZooMap::plotSide(int capacity) {
+  const double side = 2.0 + std::ceil(std::sqrt(std::max(capacity, 1)));
+  return std::clamp(static_cast<int>(side), 3, 16);
+}
+
+// findFreePlot
+//  - A summed-area table of non-path tiles makes each candidate an O(1)
+//    check, so a scan costs one pass over the grid
+//  - The candidate plus a one-tile margin (which holds the entrance) must
+//    be all path; plots placed this way never cut the path network apart
+ExhibitPlot ZooMap::findFreePlot(int w, int h) const {
+  const std::size_t stride = static_cast<std::size_t>(width) + 1;
+  std::vector<int> sum(stride * (height + 1), 0);
+  for (int y = 0; y < height; ++y) {
+    int row = 0;
+    for (int x = 0; x < width; ++x) {
+      row += tileAt(x, y) != Path;
+      sum[(y + 1) * stride + x + 1] = sum[y * stride + x + 1] + row;
+    }
+  }
+  auto used = [&](int x0, int y0, int x1, int y1) { // [x0, x1) x [y0, y1)
+    return sum[y1 * stride + x1] - sum[y0 * stride + x1] -
+           sum[y1 * stride + x0] + sum[y0 * stride + x0];
+  };
+  for (int y = 1; y + h < height; ++y) {
+    for (int x = 1; x + w < width; ++x) {
+      if (used(x - 1, y - 1, x + w + 1, y + h + 1) == 0) {
+        return {x, y, w, h};
+      }
+    }
+  }
+  return {};
+}
+
+// markTargets
+//  - Rebuilt when the map changed since the last time
+void ZooMap::markTargets() const {
+  if (targetsAt == version) {
+    return;
+  }
+  isTarget.assign(tiles.size(), 0);
+  isTarget[index(getGate().x, getGate().y)] = 1;
+  for (const ExhibitPlot &p : plots) {
+    if (p.placed()) {
+      isTarget[index(p.entrance().x, p.entrance().y)] = 1;
+    }
+  }
+  targetCount = static_cast<std::size_t>(
+      std::count(isTarget.begin(), isTarget.end(), std::uint8_t{1}));
+  targetsAt = version;
+}
+
+// search
+//  - Every step costs the same, so BFS order is distance order
+//  - Stopping at the last target leaves every tile closer than it reached
+void ZooMap::search(MapPoint start, std::vector<Distance> &dist,
+                    std::vector<std::int32_t> &queue,
+                    bool targetsOnly) const {
+  queue.clear();
+  if (tileAt(start.x, start.y) != Path) {
+    return;
+  }
+  std::size_t found = 0;
+  dist[index(start.x, start.y)] = 0;
+  queue.push_back(static_cast<std::int32_t>(index(start.x, start.y)));
+  for (std::size_t head = 0; head < queue.size(); ++head) {
+    const int cell = queue[head];
+    if (targetsOnly && isTarget[cell] && ++found == targetCount) {
+      break;
+    }
+    const int x = cell % width, y = cell / width;
+    const Distance next = dist[cell] + 1;
+    if (next == kFar) {
+      continue; // Further than a distance can hold
+    }
+    for (int k = 0; k < 4; ++k) {
+      const int nx = x + kDx[k], ny = y + kDy[k];
+      if (!inBounds(nx, ny)) {
+        continue;
+      }
+      const std::size_t n = index(nx, ny);
+      if (dist[n] == kFar && tiles[n] == Path) {
+        dist[n] = next;
+        queue.push_back(static_cast<std::int32_t>(n));
+      }
+    }
+  }
+}
+
+// buildReach
+//  - 'dist' must be all kFar and is left that way: only the tiles reached
+//    are reset, so a search costs the area it covers, not the grid
+void ZooMap::buildReach(int row, std::vector<Distance> &dist,
+                        std::vector<std::int32_t> &queue) const {
+  Reach &r = reach[row];
+  search(plots[row].entrance(), dist, queue, true);
+  r.toPlot.assign(plots.size(), kFar);
+  for (std::size_t c = 0; c < plots.size(); ++c) {
+    if (plots[c].placed()) {
+      r.toPlot[c] = dist[index(plots[c].entrance().x, plots[c].entrance().y)];
+    }
+  }
+  r.toGate = dist[index(getGate().x, getGate().y)];
+  r.x0 = width;
+  r.y0 = height;
+  r.x1 = r.y1 = -1;
+  for (const std::int32_t cell : queue) {
+    const int x = cell % width, y = cell / width;
+    r.x0 = std::min(r.x0, x);
+    r.y0 = std::min(r.y0, y);
+    r.x1 = std::max(r.x1, x);
+    r.y1 = std::max(r.y1, y);
+    dist[cell] = kFar;
+  }
+  r.builtAt = version;
+  r.stale = false;
+}
+
+const ZooMap::Reach &ZooMap::reachOf(int row) const {
+  if (reach[row].stale) {
+    markTargets();
+    std::vector<Distance> dist(tiles.size(), kFar);
+    std::vector<std::int32_t> queue;
+    buildReach(row, dist, queue);
+  }
+  return reach[row];
+}
+
+const std::vector<ZooMap::Distance> &ZooMap::fieldOf(int row) const {
+  if (fieldRow != row || fieldAt != version) {
+    std::vector<std::int32_t> queue;
+    field.assign(tiles.size(), kFar);
+    search(plots[row].entrance(), field, queue, false);
+    fieldRow = row;
+    fieldAt = version;
+  }
+  return field;
+}
+
+// prepare
+//  - Each task keeps one scratch grid for all the rows it searches
+void ZooMap::prepare(JobSystem *jobs) const {
+  std::vector<int> missing;
+  for (std::size_t r = 0; r < plots.size(); ++r) {
+    if (plots[r].placed() && reach[r].stale) {
+      missing.push_back(static_cast<int>(r));
+    }
+  }
+  if (missing.empty()) {
+    return;
+  }
+  markTargets();
+  auto build = [&](std::size_t b, std::size_t e) {
+    std::vector<Distance> dist(tiles.size(), kFar);
+    std::vector<std::int32_t> queue;
+    for (std::size_t i = b; i < e; ++i) {
+      buildReach(missing[i], dist, queue);
+    }
+  };
+  if (jobs) {
+    jobs->parallelFor(missing.size(), 1, build);
+  } else {
+    build(0, missing.size());
+  }
+}
+
+int ZooMap::distanceFrom(MapPoint from, int toRow) const {
+  if (toRow < 0 || !plots[toRow].placed() || !inBounds(from.x, from.y)) {
+    return UNREACHABLE;
+  }
+  const Distance d = fieldOf(toRow)[index(from.x, from.y)];
+  return d == kFar ? UNREACHABLE : d;
+}
+
+// distance
+//  - Walking distances are symmetric, so either exhibit's row holds the
+//    pair. The one searched last is right: the other exhibit cannot have
+//    moved since (that would have made it stale, and searched again later).
+int ZooMap::distance(int fromRow, int toRow) const {
+  if (toRow < 0 || !plots[toRow].placed()) {
+    return UNREACHABLE;
+  }
+  const Reach &to = reachOf(toRow);
+  Distance d = to.toGate;
+  if (fromRow >= 0) {
+    if (!plots[fromRow].placed()) {
+      return UNREACHABLE;
+    }
+    const Reach &from = reachOf(fromRow);
+    d = from.builtAt > to.builtAt ? from.toPlot[toRow] : to.toPlot[fromRow];
+  }
+  return d == kFar ? UNREACHABLE : d;
+}
+
+// route
+//  - Steps to any neighbour one tile closer; the fixed neighbour order
+//    makes the route the same every time
+std::vector<MapPoint> ZooMap::route(MapPoint from, int toRow) const {
+  const int total = distanceFrom(from, toRow);
+  if (total == UNREACHABLE) {
+    return {};
+  }
+  const std::vector<Distance> &f = fieldOf(toRow);
+  std::vector<MapPoint> tilesOnRoute{from};
+  tilesOnRoute.reserve(total + 1);
+  MapPoint at = from;
+  for (int d = total; d > 0; --d) {
+    for (int k = 0; k < 4; ++k) {
+      const int nx = at.x + kDx[k], ny = at.y + kDy[k];
+      if (inBounds(nx, ny) && f[index(nx, ny)] == d - 1) {
+        at = {nx, ny};
+        break;
+      }
+    }
+    tilesOnRoute.push_back(at);
+  }
+  return tilesOnRoute;
+}
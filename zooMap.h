@@ -0,0 +1,168 @@
+// zooMap.h
+// Declaration of ZooMap: the zoo grounds as a 2D tile grid. Every exhibit
+// occupies a rectangular plot with its entrance on the tile just below the
+// plot's bottom edge; other tiles are paths unless blocked (ponds, kiosks,
+// building work). Visitors come in at the gate in the top-left corner.
+//
+// Pathfinding is breadth-first search from each exhibit's entrance. What
+// the simulation asks for is distances between exhibits (and the gate), so
+// each exhibit keeps just those: one table row of walking distances to the
+// other entrances, from a search that stops once it has reached them all.
+// Memory is O(exhibits^2) rather than a full-grid field per exhibit.
+//  - Rows are built on first use (or all at once, in parallel, by
+//    prepare()); after that a distance is one lookup
+//  - An edit only invalidates the rows whose searched area it touches: a
+//    search never looks past the tiles its distances depend on, so tiles
+//    outside that area cannot change them
+//  - A route needs every tile's distance to the destination; it walks down
+//    a full flow field, built on demand for one exhibit at a time
+
+#ifndef ZOO_MAP_H
+#define ZOO_MAP_H
+
+#include "jobSystem.h" // Parallel field builds
+#include <cstddef>     // std::size_t
+#include <cstdint>     // Tiles, distances
+#include <vector>      // Grid, plots, fields
+
+struct MapPoint {
+  int x = 0;
+  int y = 0;
+};
+
+// Where an exhibit sits; w == 0 means not placed yet
+struct ExhibitPlot {
+  int x = 0;
+  int y = 0;
+  int w = 0;
+  int h = 0;
+
+  bool placed() const { return w > 0; }
+  MapPoint entrance() const { return {x + w / 2, y + h}; }
+};
+
+class ZooMap {
+public:
+  enum Tile : std::uint8_t { Path, Blocked, Plot };
+  static constexpr int UNREACHABLE = -1;
+  static constexpr int MAX_SIDE = 1024;
+
+  explicit ZooMap(int width = 32, int height = 32);
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  MapPoint getGate() const { return {0, 0}; }
+  Tile tileAt(int x, int y) const { return Tile(tiles[index(x, y)]); }
+  bool inBounds(int x, int y) const {
+    return x >= 0 && y >= 0 && x < width && y < height;
+  }
+
+  // Bumped by every change; caches built at an older version are gone
+  std::uint64_t getVersion() const { return version; }
+
+  // ===== Edits (each one invalidates the rows whose search it touches) =====
+  // Grows the grid, keeping everything where it is
+  //  - Returns false if it would shrink or exceed MAX_SIDE
+  bool resize(int newWidth, int newHeight);
+
+  // Blocks or clears a path tile
+  //  - Returns false for plot tiles, entrances, the gate, or out-of-bounds
+  //    tiles
+  bool setBlocked(int x, int y, bool blocked);
+
+  // Plots are kept in the same rows as the World's exhibits: addPlot()
+  // appends an unplaced one, removePlot() mirrors World::destroy
+  void addPlot();
+  void removePlot(int row, int last);
+  std::size_t plotCount() const { return plots.size(); }
+  const ExhibitPlot &getPlot(int row) const { return plots[row]; }
+
+  // Moves exhibit 'row' to 'plot'
+  //  - Returns false if the plot leaves the grid, covers the gate, overlaps
+  //    another plot or a blocked tile, or has no path tile for an entrance
+  bool placePlot(int row, const ExhibitPlot &plot);
+
+  // First free w x h spot (scanning rows top to bottom) that keeps a path
+  // around the plot; an unplaced plot if there is none
+  ExhibitPlot findFreePlot(int w, int h) const;
+
+  // Plot side for an exhibit of 'capacity' animals
+  static int plotSide(int capacity);
+
+  // ===== Queries =====
+  // Rows are built lazily; calling distance() from several threads at once
+  // is safe only after prepare() (and until the next edit). The other
+  // queries build a flow field and are never safe to call concurrently.
+  //
+  // Tiles walked from exhibit 'fromRow' (-1 = the gate) to exhibit 'toRow',
+  // or UNREACHABLE (also when either exhibit is not placed)
+  int distance(int fromRow, int toRow) const;
+  // The same from any tile, read from the flow field of 'toRow'
+  int distanceFrom(MapPoint from, int toRow) const;
+
+  // Tiles from 'from' to the entrance of 'toRow', both ends included;
+  // empty if unreachable
+  std::vector<MapPoint> route(MapPoint from, int toRow) const;
+
+  // Builds every invalidated row, spread over 'jobs' (nullptr: serially)
+  void prepare(JobSystem *jobs) const;
+
+  // Raw state for hashing
+  const std::vector<std::uint8_t> &getTiles() const { return tiles; }
+  const std::vector<ExhibitPlot> &getPlots() const { return plots; }
+
+private:
+  // Distances in a field; anything past the last value is unreachable
+  using Distance = std::uint16_t;
+  static constexpr Distance kFar = 0xFFFF;
+
+  int width;
+  int height;
+  std::vector<std::uint8_t> tiles; // Tile per cell, row-major
+  std::vector<ExhibitPlot> plots;
+  std::uint64_t version = 0;
+
+  // One row of the distance table, per plot row
+  struct Reach {
+    std::vector<Distance> toPlot; // Per plot row; kFar = unreachable
+    Distance toGate = kFar;
+    std::uint64_t builtAt = 0; // Map version of the search
+    bool stale = true;         // Must be searched again before use
+    int x0 = 0, y0 = 0;        // Bounding box of the tiles searched
+    int x1 = -1, y1 = -1;
+  };
+  mutable std::vector<Reach> reach;
+
+  // Tiles the searches look for (entrances and the gate), per tile
+  mutable std::vector<std::uint8_t> isTarget;
+  mutable std::size_t targetCount = 0;
+  mutable std::uint64_t targetsAt = ~0ull; // Map version of isTarget
+
+  // The one flow field kept, for route() and distanceFrom()
+  mutable std::vector<Distance> field;
+  mutable int fieldRow = -1;
+  mutable std::uint64_t fieldAt = 0;
+
+  std::size_t index(int x, int y) const {
+    return static_cast<std::size_t>(y) * width + x;
+  }
+  // Marks stale every row whose search reached, or bordered on, a tile of
+  // the inclusive rectangle (its tiles changed) and bumps the version
+  void touch(int x0, int y0, int x1, int y1);
+  void touch(const ExhibitPlot &plot) {
+    touch(plot.x, plot.y, plot.x + plot.w - 1, plot.y + plot.h - 1);
+  }
+  void fill(const ExhibitPlot &plot, Tile tile);
+  void markTargets() const;
+  // Breadth-first search from 'start' over path tiles into 'dist' (kFar
+  // where not reached yet); 'queue' receives the tiles reached, in
+  // distance order. With 'targetsOnly' it stops once every target is found.
+  void search(MapPoint start, std::vector<Distance> &dist,
+              std::vector<std::int32_t> &queue, bool targetsOnly) const;
+  void buildReach(int row, std::vector<Distance> &dist,
+                  std::vector<std::int32_t> &queue) const;
+  const Reach &reachOf(int row) const;
+  const std::vector<Distance> &fieldOf(int row) const;
+};
+
+#endif // ZOO_MAP_H